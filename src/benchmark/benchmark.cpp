@@ -0,0 +1,356 @@
+#include "src/common/precompiled.h"
+
+#include "benchmark.h"
+
+#include "src/common/profiler.h"
+#include "src/common/taskscheduler.h"
+#include "src/common/tictoc.h"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+// Heap allocations of the benchmark process are counted while a measurement is active
+void *operator new( size_t size )
+{
+    if ( AllocationCounter::isActive() )
+        AllocationCounter::add( size );
+
+    if ( auto ptr = std::malloc( size ? size : 1 ) )
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete( void *ptr, size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr, size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+// cv::Mat buffers bypass operator new, so they are counted by a forwarding allocator
+class CountingMatAllocator : public cv::MatAllocator
+{
+public:
+    virtual cv::UMatData *allocate( int dims, const int *sizes, int type, void *data, size_t *step, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags ) const override
+    {
+        if ( !data && AllocationCounter::isActive() ) {
+            size_t total = CV_ELEM_SIZE( type );
+
+            for ( int i = 0; i < dims; ++i )
+                total *= sizes[ i ];
+
+            AllocationCounter::add( total );
+
+        }
+
+        return cv::Mat::getStdAllocator()->allocate( dims, sizes, type, data, step, flags, usageFlags );
+
+    }
+
+    virtual bool allocate( cv::UMatData *data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags ) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate( data, accessFlags, usageFlags );
+    }
+
+    virtual void deallocate( cv::UMatData *data ) const override
+    {
+        cv::Mat::getStdAllocator()->deallocate( data );
+    }
+
+};
+
+// AllocationCounter
+std::atomic< bool > AllocationCounter::m_active( false );
+std::atomic< size_t > AllocationCounter::m_count( 0 );
+std::atomic< size_t > AllocationCounter::m_bytes( 0 );
+
+void AllocationCounter::install()
+{
+    static CountingMatAllocator allocator;
+
+    cv::Mat::setDefaultAllocator( &allocator );
+}
+
+void AllocationCounter::start()
+{
+    m_count = 0;
+    m_bytes = 0;
+    m_active = true;
+}
+
+void AllocationCounter::stop()
+{
+    m_active = false;
+}
+
+bool AllocationCounter::isActive()
+{
+    return m_active;
+}
+
+size_t AllocationCounter::count()
+{
+    return m_count;
+}
+
+size_t AllocationCounter::bytes()
+{
+    return m_bytes;
+}
+
+void AllocationCounter::add( const size_t bytes )
+{
+    ++m_count;
+    m_bytes += bytes;
+}
+
+// Benchmark
+Benchmark::Benchmark()
+{
+    initialize();
+}
+
+void Benchmark::initialize()
+{
+    m_resolutions = { Resolution( "VGA", cv::Size( 640, 480 ) ),
+                      Resolution( "2MP", cv::Size( 1600, 1200 ) ),
+                      Resolution( "5MP", cv::Size( 2592, 1944 ) ) };
+
+    m_threadCounts = { 1, std::max( 1, omp_get_num_procs() ) };
+
+    m_iterations = 10;
+}
+
+void Benchmark::add( const std::string &name, const Setup &setup, const char *zone )
+{
+    Entry entry;
+
+    entry.name = name;
+    entry.setup = setup;
+    entry.zone = zone;
+
+    m_entries.push_back( entry );
+
+}
+
+const std::vector< Benchmark::Resolution > &Benchmark::resolutions() const
+{
+    return m_resolutions;
+}
+
+void Benchmark::setResolutions( const std::vector< Resolution > &value )
+{
+    m_resolutions = value;
+}
+
+const std::vector< int > &Benchmark::threadCounts() const
+{
+    return m_threadCounts;
+}
+
+void Benchmark::setThreadCounts( const std::vector< int > &value )
+{
+    m_threadCounts = value;
+}
+
+int Benchmark::iterations() const
+{
+    return m_iterations;
+}
+
+void Benchmark::setIterations( const int value )
+{
+    m_iterations = std::max( 1, value );
+}
+
+const std::string &Benchmark::filter() const
+{
+    return m_filter;
+}
+
+void Benchmark::setFilter( const std::string &value )
+{
+    m_filter = value;
+}
+
+std::vector< BenchmarkResult > Benchmark::run() const
+{
+    std::vector< BenchmarkResult > ret;
+
+    printHeader();
+
+    for ( auto &entry : m_entries ) {
+
+        if ( !m_filter.empty() && entry.name.find( m_filter ) == std::string::npos )
+            continue;
+
+        for ( auto &resolution : m_resolutions ) {
+            for ( auto threads : m_threadCounts ) {
+                auto result = measure( entry, resolution, threads );
+
+                print( result );
+
+                ret.push_back( result );
+
+            }
+
+        }
+
+    }
+
+    return ret;
+
+}
+
+BenchmarkResult Benchmark::measure( const Entry &entry, const Resolution &resolution, const int threads ) const
+{
+    BenchmarkResult ret;
+
+    ret.name = entry.name;
+    ret.resolution = resolution.first;
+    ret.size = resolution.second;
+    ret.threads = threads;
+    ret.iterations = m_iterations;
+    ret.failed = false;
+
+    cv::setNumThreads( threads );
+    omp_set_num_threads( threads );
+
+    // The calling thread runs scheduler tasks while it waits for them, so it counts as one of the threads
+    TaskScheduler::instance().setThreadsCount( threads - 1 );
+
+    auto function = entry.setup( resolution.second );
+
+    // Warm-up call fills caches and lazily created buffers
+    function();
+
+    auto &profiler = Profiler::instance();
+    profiler.clear();
+
+    std::vector< double > durations;
+
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+    for ( int i = 0; i < m_iterations; ++i ) {
+        TicToc time;
+
+        AllocationCounter::start();
+
+        function();
+
+        AllocationCounter::stop();
+
+        durations.push_back( time.toc() * 1.e3 );
+
+        allocations += AllocationCounter::count();
+        bytes += AllocationCounter::bytes();
+
+    }
+
+    std::sort( durations.begin(), durations.end() );
+
+    ret.mean = 0.;
+
+    for ( auto &i : durations )
+        ret.mean += i / durations.size();
+
+    ret.median = durations[ durations.size() / 2 ];
+
+    // Kernels deep inside a pipeline are timed by their profiler zone instead of the whole call
+    if ( entry.zone ) {
+        std::string zone( entry.zone );
+
+        size_t count = 0;
+        double total = 0.;
+        double median = 0.;
+
+        for ( auto &i : profiler.statistics() ) {
+            if ( i.path == zone || ( i.path.size() > zone.size() && i.path.compare( i.path.size() - zone.size() - 1, std::string::npos, "/" + zone ) == 0 ) ) {
+                count += i.count;
+                total += i.total;
+                median = std::max( median, i.p50 );
+            }
+
+        }
+
+        ret.mean = count > 0 ? total / count : 0.;
+        ret.median = median;
+
+        ret.failed = count == 0;
+
+    }
+
+    ret.megapixelsPerSecond = ret.mean > 0. ? resolution.second.area() * 1.e-6 / ( ret.mean * 1.e-3 ) : 0.;
+
+    ret.allocationsPerCall = static_cast< double >( allocations ) / m_iterations;
+    ret.bytesPerCall = static_cast< double >( bytes ) / m_iterations;
+
+    return ret;
+
+}
+
+void Benchmark::printHeader()
+{
+    std::cout << std::left << std::setw( 24 ) << "Kernel" << std::setw( 8 ) << "Size" << std::right << std::setw( 8 ) << "threads"
+              << std::setw( 12 ) << "mean, ms" << std::setw( 12 ) << "median, ms" << std::setw( 10 ) << "MP/s"
+              << std::setw( 12 ) << "allocs" << std::setw( 12 ) << "KB" << std::endl;
+}
+
+void Benchmark::print( const BenchmarkResult &result )
+{
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    std::cout << std::left << std::setw( 24 ) << result.name << std::setw( 8 ) << result.resolution << std::right << std::setw( 8 ) << result.threads
+              << std::setw( 12 ) << result.mean << std::setw( 12 ) << result.median << std::setw( 10 ) << result.megapixelsPerSecond
+              << std::setw( 12 ) << result.allocationsPerCall << std::setw( 12 ) << result.bytesPerCall / 1024.;
+
+    if ( result.failed )
+        std::cout << "  FAILED: zone never ran";
+
+    std::cout << std::endl;
+
+    std::cout << std::defaultfloat;
+}
+
+bool Benchmark::saveCsv( const std::vector< BenchmarkResult > &results, const std::string &fileName )
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    stream << "kernel,resolution,width,height,threads,iterations,mean_ms,median_ms,megapixels_per_second,allocations_per_call,bytes_per_call" << std::endl;
+
+    for ( auto &i : results )
+        stream << i.name << "," << i.resolution << "," << i.size.width << "," << i.size.height << "," << i.threads << "," << i.iterations << ","
+               << i.mean << "," << i.median << "," << i.megapixelsPerSecond << "," << i.allocationsPerCall << "," << i.bytesPerCall << std::endl;
+
+    return stream.good();
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+class AllocationCounter
+{
+public:
+    static void install();
+
+    static void start();
+    static void stop();
+
+    static bool isActive();
+
+    static size_t count();
+    static size_t bytes();
+
+    static void add( const size_t bytes );
+
+protected:
+    static std::atomic< bool > m_active;
+    static std::atomic< size_t > m_count;
+    static std::atomic< size_t > m_bytes;
+
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string resolution;
+    cv::Size size;
+
+    int threads;
+    int iterations;
+
+    // milliseconds
+    double mean;
+    double median;
+
+    double megapixelsPerSecond;
+
+    double allocationsPerCall;
+    double bytesPerCall;
+
+    // The profiler zone of the kernel never ran, the timings are meaningless
+    bool failed;
+};
+
+class Benchmark
+{
+public:
+    using Function = std::function< void() >;
+    using Setup = std::function< Function( const cv::Size &size ) >;
+
+    using Resolution = std::pair< std::string, cv::Size >;
+
+    Benchmark();
+
+    void add( const std::string &name, const Setup &setup, const char *zone = nullptr );
+
+    const std::vector< Resolution > &resolutions() const;
+    void setResolutions( const std::vector< Resolution > &value );
+
+    const std::vector< int > &threadCounts() const;
+    void setThreadCounts( const std::vector< int > &value );
+
+    int iterations() const;
+    void setIterations( const int value );
+
+    const std::string &filter() const;
+    void setFilter( const std::string &value );
+
+    std::vector< BenchmarkResult > run() const;
+
+    static void print( const BenchmarkResult &result );
+    static void printHeader();
+
+    static bool saveCsv( const std::vector< BenchmarkResult > &results, const std::string &fileName );
+
+protected:
+    struct Entry
+    {
+        std::string name;
+        Setup setup;
+        const char *zone;
+    };
+
+    std::vector< Entry > m_entries;
+
+    std::vector< Resolution > m_resolutions;
+    std::vector< int > m_threadCounts;
+
+    int m_iterations;
+
+    std::string m_filter;
+
+    BenchmarkResult measure( const Entry &entry, const Resolution &resolution, const int threads ) const;
+
+private:
+    void initialize();
+
+};
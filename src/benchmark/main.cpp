@@ -0,0 +1,323 @@
+#include "src/common/precompiled.h"
+
+#include "benchmark.h"
+
+#include "src/common/bpprocessor.h"
+#include "src/common/censusprocessor.h"
+#include "src/common/disparitycolorizer.h"
+#include "src/common/disparitypreprocessor.h"
+#include "src/common/disparityrefinement.h"
+#include "src/common/functions.h"
+#include "src/common/rectificationprocessor.h"
+#include "src/common/stereoprocessor.h"
+#include "src/common/syntheticdata.h"
+#include "src/common/taskscheduler.h"
+
+#include "src/libelas/elas.h"
+#include "src/libelas/parallel.h"
+
+#include "src/slam/world.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <iostream>
+
+static const int BENCHMARK_DISPARITY = 32;
+
+static void elasParallelForHook( const int32_t begin, const int32_t end, const std::function< void( int32_t ) > &body, const int32_t grain )
+{
+    parallelFor( begin, end, body, TaskScheduler::TRACKING, grain );
+}
+
+class PointCloudKernel : public StereoProcessor
+{
+public:
+    using StereoProcessor::reprojectPoints;
+    using StereoProcessor::producePointCloud;
+    using StereoProcessor::reprojectDepth;
+    using StereoProcessor::produceDepthPointCloud;
+};
+
+static StampedStereoImage benchmarkStereoPair( const cv::Size &size )
+{
+    auto texture = syntheticTexture( cv::Size( size.width + BENCHMARK_DISPARITY, size.height ) );
+
+    return syntheticStereoPair( texture, cv::Rect( cv::Point(), size ), BENCHMARK_DISPARITY );
+}
+
+static cv::Mat benchmarkDisparity( const cv::Size &size )
+{
+    cv::Mat ret( size, CV_16S );
+
+    cv::RNG rng( 0 );
+    rng.fill( ret, cv::RNG::UNIFORM, 0, 64 * 16 );
+
+    return ret;
+}
+
+static void addKernels( Benchmark *benchmark )
+{
+    benchmark->add( "DisparityColorizer::process", []( const cv::Size &size ) {
+        auto disparity = benchmarkDisparity( size );
+        auto colorizer = std::make_shared< DisparityColorizer >();
+
+        colorizer->setRange( cv::Range( 0, 64 ) );
+
+        return [ disparity, colorizer ] { colorizer->process( disparity ); };
+
+    } );
+
+    benchmark->add( "stackImages", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+
+        return [ frame ] { stackImages( frame.leftImage(), frame.rightImage() ); };
+
+    } );
+
+    benchmark->add( "rectify", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< StereoRectificationProcessor >( syntheticStereoCalibration( size, 100., 0.05 ) );
+
+        return [ frame, processor ] {
+            CvImage leftResult, rightResult;
+            processor->rectify( frame.leftImage(), frame.rightImage(), &leftResult, &rightResult );
+        };
+
+    } );
+
+    benchmark->add( "DisparityPreprocessor::process", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< DisparityPreprocessor >();
+
+        return [ frame, processor ] {
+            cv::Mat left;
+            cv::Mat right;
+
+            processor->process( frame.leftImage(), frame.rightImage(), &left, &right );
+        };
+
+    } );
+
+    benchmark->add( "producePointCloud", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< PointCloudKernel >();
+
+        processor->setDisparityToDepthMatrix( syntheticStereoCalibration( size ).disparityToDepthMatrix() );
+
+        auto points = processor->reprojectPoints( benchmarkDisparity( size ) );
+
+        return [ frame, processor, points ] { processor->producePointCloud( points, frame.leftImage() ); };
+
+    } );
+
+    benchmark->add( "reprojectPoints", []( const cv::Size &size ) {
+        auto processor = std::make_shared< PointCloudKernel >();
+
+        processor->setDisparityToDepthMatrix( syntheticStereoCalibration( size ).disparityToDepthMatrix() );
+
+        auto disparity = benchmarkDisparity( size );
+
+        return [ processor, disparity ] { processor->reprojectPoints( disparity ); };
+
+    } );
+
+    benchmark->add( "reprojectDepth", []( const cv::Size &size ) {
+        auto processor = std::make_shared< PointCloudKernel >();
+
+        processor->setDisparityToDepthMatrix( syntheticStereoCalibration( size ).disparityToDepthMatrix() );
+
+        auto disparity = benchmarkDisparity( size );
+
+        return [ processor, disparity ] { processor->reprojectDepth( disparity ); };
+
+    } );
+
+    benchmark->add( "produceDepthPointCloud", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< PointCloudKernel >();
+
+        processor->setDisparityToDepthMatrix( syntheticStereoCalibration( size ).disparityToDepthMatrix() );
+
+        auto depth = processor->reprojectDepth( benchmarkDisparity( size ) );
+
+        return [ frame, processor, depth ] { processor->produceDepthPointCloud( depth, frame.leftImage() ); };
+
+    } );
+
+    benchmark->add( "BMDisparityProcessor", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< BMDisparityProcessor >();
+
+        processor->setNumDisparities( 2 * BENCHMARK_DISPARITY );
+
+        return [ frame, processor ] { processor->processDisparity( frame.leftImage(), frame.rightImage() ); };
+
+    } );
+
+    benchmark->add( "CensusDisparityProcessor", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< CensusDisparityProcessor >();
+
+        processor->setNumDisparities( 2 * BENCHMARK_DISPARITY );
+
+        return [ frame, processor ] { processor->processDisparity( frame.leftImage(), frame.rightImage() ); };
+
+    } );
+
+    benchmark->add( "BPCPUDisparityProcessor", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+        auto processor = std::make_shared< BPCPUDisparityProcessor >();
+
+        processor->setNumDisparities( 2 * BENCHMARK_DISPARITY );
+
+        return [ frame, processor ] { processor->processDisparity( frame.leftImage(), frame.rightImage() ); };
+
+    } );
+
+    benchmark->add( "DisparityRefinement::process", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+
+        CensusDisparityProcessor processor;
+        processor.setNumDisparities( 2 * BENCHMARK_DISPARITY );
+
+        auto disparity = processor.processDisparity( frame.leftImage(), frame.rightImage() );
+        auto range = processor.disparityRange();
+
+        auto refinement = std::make_shared< DisparityRefinement >();
+
+        return [ frame, disparity, range, refinement ] { refinement->process( disparity, frame.leftImage(), frame.rightImage(), range ); };
+
+    } );
+
+    benchmark->add( "Elas::process", []( const cv::Size &size ) {
+        auto frame = benchmarkStereoPair( size );
+
+        auto left = std::make_shared< cv::Mat >();
+        auto right = std::make_shared< cv::Mat >();
+
+        cv::cvtColor( frame.leftImage(), *left, cv::COLOR_BGR2GRAY );
+        cv::cvtColor( frame.rightImage(), *right, cv::COLOR_BGR2GRAY );
+
+        auto elas = std::make_shared< Elas >( Elas::parameters() );
+
+        setParallelForHook( &elasParallelForHook, TaskScheduler::instance().threadsCount() );
+
+        return [ left, right, elas ] {
+            const int32_t dims[ 3 ] = { left->cols, left->rows, left->cols };
+
+            std::vector< float > leftDisparity( left->total() ), rightDisparity( right->total() );
+
+            elas->process( left->data, right->data, leftDisparity.data(), rightDisparity.data(), dims );
+        };
+
+    } );
+
+    // Triangulation needs a live map, so the camera drifts along a synthetic scene and the zone is timed by the profiler.
+    // Only the stereo keyframe path is timed, consecutive keyframes triangulate under their own zone
+    benchmark->add( "triangulatePoints", []( const cv::Size &size ) {
+        const int step = 4;
+
+        auto texture = std::make_shared< CvImage >( syntheticTexture( cv::Size( 2 * size.width + BENCHMARK_DISPARITY, size.height ) ) );
+        auto world = slam::World::create( syntheticStereoCalibration( size ).projectionMatrix() );
+        auto offset = std::make_shared< int >( 0 );
+
+        return [ texture, world, offset, size, step ] {
+            auto frame = syntheticStereoPair( *texture, cv::Rect( cv::Point( *offset, 0 ), size ), BENCHMARK_DISPARITY );
+
+            world->track( frame.leftImage(), frame.rightImage() );
+
+            *offset = ( *offset + step ) % size.width;
+        };
+
+    }, "stereo triangulation" );
+
+}
+
+static std::vector< int > parseThreadCounts( const QString &value )
+{
+    std::vector< int > ret;
+
+    for ( auto &i : value.split( ",", QString::SkipEmptyParts ) ) {
+        auto count = i.trimmed().toInt();
+
+        if ( count > 0 )
+            ret.push_back( count );
+
+    }
+
+    return ret;
+
+}
+
+static std::vector< Benchmark::Resolution > parseResolutions( const QString &value, const std::vector< Benchmark::Resolution > &known )
+{
+    std::vector< Benchmark::Resolution > ret;
+
+    for ( auto &i : value.split( ",", QString::SkipEmptyParts ) ) {
+        for ( auto &j : known ) {
+            if ( QString::fromStdString( j.first ).compare( i.trimmed(), Qt::CaseInsensitive ) == 0 )
+                ret.push_back( j );
+        }
+
+    }
+
+    return ret;
+
+}
+
+int main( int argc, char **argv )
+{
+    QCoreApplication application( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Benchmark of image and geometry kernels on synthetic input" );
+    parser.addHelpOption();
+
+    QCommandLineOption iterationsOption( QStringList() << "i" << "iterations", "Measured calls per kernel.", "count", "10" );
+    QCommandLineOption threadsOption( QStringList() << "t" << "threads", "Comma separated thread counts.", "list" );
+    QCommandLineOption resolutionsOption( QStringList() << "r" << "resolutions", "Comma separated resolutions: VGA, 2MP, 5MP.", "list" );
+    QCommandLineOption filterOption( QStringList() << "f" << "filter", "Run only kernels containing this name.", "name" );
+    QCommandLineOption csvOption( "csv", "Save results to a CSV file.", "file" );
+
+    parser.addOption( iterationsOption );
+    parser.addOption( threadsOption );
+    parser.addOption( resolutionsOption );
+    parser.addOption( filterOption );
+    parser.addOption( csvOption );
+
+    parser.process( application );
+
+    AllocationCounter::install();
+
+    Benchmark benchmark;
+
+    addKernels( &benchmark );
+
+    benchmark.setIterations( parser.value( iterationsOption ).toInt() );
+
+    if ( parser.isSet( threadsOption ) )
+        benchmark.setThreadCounts( parseThreadCounts( parser.value( threadsOption ) ) );
+
+    if ( parser.isSet( resolutionsOption ) )
+        benchmark.setResolutions( parseResolutions( parser.value( resolutionsOption ), benchmark.resolutions() ) );
+
+    if ( parser.isSet( filterOption ) )
+        benchmark.setFilter( parser.value( filterOption ).toStdString() );
+
+    auto results = benchmark.run();
+
+    auto failed = std::count_if( results.begin(), results.end(), []( const BenchmarkResult &result ) { return result.failed; } );
+
+    if ( failed > 0 )
+        std::cerr << failed << " measurements failed, their profiler zones never ran" << std::endl;
+
+    if ( parser.isSet( csvOption ) && !Benchmark::saveCsv( results, parser.value( csvOption ).toStdString() ) ) {
+        std::cerr << "Can't save " << parser.value( csvOption ).toStdString() << std::endl;
+        return 1;
+    }
+
+    return failed > 0 ? 1 : 0;
+
+}
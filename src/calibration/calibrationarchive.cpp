@@ -0,0 +1,298 @@
+#include "src/common/precompiled.h"
+
+#include "calibrationarchive.h"
+
+#include <QDataStream>
+
+// Bytes left in the chunk a stream reads, sizes read from the file are checked against them
+static quint64 bytesLeft( QDataStream &stream )
+{
+    auto device = stream.device();
+
+    return device ? static_cast< quint64 >( std::max< qint64 >( 0, device->bytesAvailable() ) ) : 0;
+}
+
+static bool readRaw( QDataStream &stream, void *data, const quint64 size )
+{
+    if ( size == 0 )
+        return true;
+
+    if ( stream.readRawData( reinterpret_cast< char * >( data ), size ) != static_cast< int >( size ) ) {
+        stream.setStatus( QDataStream::ReadPastEnd );
+        return false;
+    }
+
+    return true;
+
+}
+
+// CalibrationArchiveBase
+void CalibrationArchiveBase::writeMat( QDataStream &stream, const cv::Mat &mat )
+{
+    cv::Mat continuous = mat.isContinuous() ? mat : mat.clone();
+
+    stream << static_cast< qint32 >( continuous.rows ) << static_cast< qint32 >( continuous.cols ) << static_cast< qint32 >( continuous.type() );
+
+    if ( !continuous.empty() )
+        stream.writeRawData( reinterpret_cast< const char * >( continuous.data ), continuous.total() * continuous.elemSize() );
+
+}
+
+cv::Mat CalibrationArchiveBase::readMat( QDataStream &stream )
+{
+    qint32 rows, cols, type;
+
+    stream >> rows >> cols >> type;
+
+    if ( stream.status() != QDataStream::Ok || rows <= 0 || cols <= 0 )
+        return cv::Mat();
+
+    if ( type < 0 || type != CV_MAT_TYPE( type ) || CV_MAT_DEPTH( type ) > CV_64F ) {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return cv::Mat();
+    }
+
+    quint64 elemSize = CV_ELEM_SIZE( type );
+
+    if ( static_cast< quint64 >( rows ) * static_cast< quint64 >( cols ) > bytesLeft( stream ) / elemSize ) {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return cv::Mat();
+    }
+
+    cv::Mat ret( rows, cols, type );
+
+    if ( !readRaw( stream, ret.data, ret.total() * elemSize ) )
+        return cv::Mat();
+
+    return ret;
+
+}
+
+void CalibrationArchiveBase::writePoints( QDataStream &stream, const std::vector< cv::Point2f > &points )
+{
+    stream << static_cast< quint32 >( points.size() );
+    stream.writeRawData( reinterpret_cast< const char * >( points.data() ), points.size() * sizeof( cv::Point2f ) );
+}
+
+std::vector< cv::Point2f > CalibrationArchiveBase::readPoints2f( QDataStream &stream )
+{
+    quint32 count;
+
+    stream >> count;
+
+    if ( stream.status() != QDataStream::Ok )
+        return std::vector< cv::Point2f >();
+
+    if ( count > bytesLeft( stream ) / sizeof( cv::Point2f ) ) {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return std::vector< cv::Point2f >();
+    }
+
+    std::vector< cv::Point2f > ret( count );
+
+    if ( !readRaw( stream, ret.data(), ret.size() * sizeof( cv::Point2f ) ) )
+        return std::vector< cv::Point2f >();
+
+    return ret;
+
+}
+
+void CalibrationArchiveBase::writePoints( QDataStream &stream, const std::vector< cv::Point3f > &points )
+{
+    stream << static_cast< quint32 >( points.size() );
+    stream.writeRawData( reinterpret_cast< const char * >( points.data() ), points.size() * sizeof( cv::Point3f ) );
+}
+
+std::vector< cv::Point3f > CalibrationArchiveBase::readPoints3f( QDataStream &stream )
+{
+    quint32 count;
+
+    stream >> count;
+
+    if ( stream.status() != QDataStream::Ok )
+        return std::vector< cv::Point3f >();
+
+    if ( count > bytesLeft( stream ) / sizeof( cv::Point3f ) ) {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return std::vector< cv::Point3f >();
+    }
+
+    std::vector< cv::Point3f > ret( count );
+
+    if ( !readRaw( stream, ret.data(), ret.size() * sizeof( cv::Point3f ) ) )
+        return std::vector< cv::Point3f >();
+
+    return ret;
+
+}
+
+// CalibrationArchiveWriter
+CalibrationArchiveWriter::CalibrationArchiveWriter( const std::string &fileName, const ArchiveType type )
+    : m_file( QString::fromStdString( fileName ) ), m_failed( false )
+{
+    initialize( type );
+}
+
+CalibrationArchiveWriter::~CalibrationArchiveWriter()
+{
+    close();
+}
+
+void CalibrationArchiveWriter::initialize( const ArchiveType type )
+{
+    if ( m_file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+        QDataStream stream( &m_file );
+
+        // Index offset is patched in close()
+        stream << m_magic << m_version << static_cast< quint32 >( type ) << static_cast< quint64 >( 0 );
+
+        m_failed = stream.status() != QDataStream::Ok;
+
+    }
+
+}
+
+bool CalibrationArchiveWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+bool CalibrationArchiveWriter::writeChunk( const ChunkType type, const unsigned int camera, const unsigned int number, const QByteArray &data )
+{
+    if ( !isOpen() || m_failed )
+        return false;
+
+    ChunkEntry entry;
+    entry.offset = m_file.pos();
+    entry.size = data.size();
+
+    if ( m_file.write( data ) != data.size() ) {
+        m_failed = true;
+        return false;
+    }
+
+    m_index[ ChunkKey( type, camera, number ) ] = entry;
+
+    return true;
+
+}
+
+bool CalibrationArchiveWriter::close()
+{
+    if ( !isOpen() )
+        return false;
+
+    // Without the index a partial archive is not mistaken for a valid one, it is removed instead
+    if ( m_failed ) {
+        m_file.remove();
+        return false;
+    }
+
+    QDataStream stream( &m_file );
+
+    quint64 indexOffset = m_file.pos();
+
+    stream << static_cast< quint32 >( m_index.size() );
+
+    for ( auto &i : m_index )
+        stream << std::get< 0 >( i.first ) << std::get< 1 >( i.first ) << std::get< 2 >( i.first ) << i.second.offset << i.second.size;
+
+    m_file.seek( m_headerSize - sizeof( quint64 ) );
+    stream << indexOffset;
+
+    bool ret = stream.status() == QDataStream::Ok && m_file.flush();
+
+    if ( ret )
+        m_file.close();
+    else
+        m_file.remove();
+
+    return ret;
+
+}
+
+// CalibrationArchiveReader
+CalibrationArchiveReader::CalibrationArchiveReader( const std::string &fileName )
+    : m_file( QString::fromStdString( fileName ) )
+{
+    initialize();
+}
+
+void CalibrationArchiveReader::initialize()
+{
+    m_archiveType = MONOCULAR;
+
+    if ( !m_file.open( QIODevice::ReadOnly ) )
+        return;
+
+    QDataStream stream( &m_file );
+
+    quint32 magic, version, type;
+    quint64 indexOffset;
+
+    stream >> magic >> version >> type >> indexOffset;
+
+    if ( stream.status() != QDataStream::Ok || magic != m_magic || version != m_version || !m_file.seek( indexOffset ) ) {
+        m_file.close();
+        return;
+    }
+
+    m_archiveType = static_cast< ArchiveType >( type );
+
+    quint32 count;
+
+    stream >> count;
+
+    for ( quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i ) {
+        quint32 chunkType, camera, number;
+        ChunkEntry entry;
+
+        stream >> chunkType >> camera >> number >> entry.offset >> entry.size;
+
+        // Chunks lie between the header and the index
+        if ( entry.offset < static_cast< quint64 >( m_headerSize ) || entry.offset > indexOffset || entry.size > indexOffset - entry.offset ) {
+            stream.setStatus( QDataStream::ReadCorruptData );
+            break;
+        }
+
+        m_index[ ChunkKey( chunkType, camera, number ) ] = entry;
+
+    }
+
+    if ( stream.status() != QDataStream::Ok ) {
+        m_index.clear();
+        m_file.close();
+    }
+
+}
+
+bool CalibrationArchiveReader::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+CalibrationArchiveBase::ArchiveType CalibrationArchiveReader::archiveType() const
+{
+    return m_archiveType;
+}
+
+bool CalibrationArchiveReader::contains( const ChunkType type, const unsigned int camera, const unsigned int number ) const
+{
+    return m_index.find( ChunkKey( type, camera, number ) ) != m_index.end();
+}
+
+QByteArray CalibrationArchiveReader::readChunk( const ChunkType type, const unsigned int camera, const unsigned int number ) const
+{
+    auto it = m_index.find( ChunkKey( type, camera, number ) );
+
+    if ( it == m_index.end() )
+        return QByteArray();
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if ( !m_file.seek( it->second.offset ) )
+        return QByteArray();
+
+    return m_file.read( it->second.size );
+
+}
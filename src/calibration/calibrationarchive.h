@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+class QDataStream;
+
+class CalibrationArchiveBase
+{
+public:
+    enum ArchiveType : quint32 { MONOCULAR = 1, STEREO = 2 };
+
+    enum ChunkType : quint32 { INTRINSICS = 1, EXTRINSICS = 2, PREVIEW = 3, VIEW = 4 };
+
+    static void writeMat( QDataStream &stream, const cv::Mat &mat );
+    static cv::Mat readMat( QDataStream &stream );
+
+    static void writePoints( QDataStream &stream, const std::vector< cv::Point2f > &points );
+    static std::vector< cv::Point2f > readPoints2f( QDataStream &stream );
+
+    static void writePoints( QDataStream &stream, const std::vector< cv::Point3f > &points );
+    static std::vector< cv::Point3f > readPoints3f( QDataStream &stream );
+
+protected:
+    using ChunkKey = std::tuple< quint32, quint32, quint32 >;
+
+    struct ChunkEntry
+    {
+        quint64 offset;
+        quint64 size;
+    };
+
+    static const quint32 m_magic = 0x434c4241; // "CLBA"
+    static const quint32 m_version = 1;
+
+    // magic, version, archive type, index offset
+    static const qint64 m_headerSize = 3 * sizeof( quint32 ) + sizeof( quint64 );
+
+};
+
+class CalibrationArchiveWriter : public CalibrationArchiveBase
+{
+public:
+    CalibrationArchiveWriter( const std::string &fileName, const ArchiveType type );
+    ~CalibrationArchiveWriter();
+
+    bool isOpen() const;
+
+    bool writeChunk( const ChunkType type, const unsigned int camera, const unsigned int number, const QByteArray &data );
+
+    bool close();
+
+protected:
+    QFile m_file;
+
+    // A chunk failed to write, the archive is removed on close
+    bool m_failed;
+
+    std::map< ChunkKey, ChunkEntry > m_index;
+
+private:
+    void initialize( const ArchiveType type );
+
+};
+
+class CalibrationArchiveReader : public CalibrationArchiveBase
+{
+public:
+    CalibrationArchiveReader( const std::string &fileName );
+
+    bool isOpen() const;
+
+    ArchiveType archiveType() const;
+
+    bool contains( const ChunkType type, const unsigned int camera, const unsigned int number = 0 ) const;
+    QByteArray readChunk( const ChunkType type, const unsigned int camera, const unsigned int number = 0 ) const;
+
+protected:
+    mutable QFile m_file;
+    mutable std::mutex m_mutex;
+
+    ArchiveType m_archiveType;
+
+    std::map< ChunkKey, ChunkEntry > m_index;
+
+private:
+    void initialize();
+
+};
@@ -2,6 +2,10 @@
 
 #include "calibrationdata.h"
 
+#include "calibrationarchive.h"
+
+#include <QDataStream>
+
 // MonocularCalibrationData
 MonocularCalibrationResult::MonocularCalibrationResult()
 {
@@ -71,28 +75,68 @@ MonocularCalibrationData::MonocularCalibrationData()
 
 void MonocularCalibrationData::initialize()
 {
+    m_archiveCamera = 0;
 }
 
 void MonocularCalibrationData::setResults( std::vector< MonocularCalibrationResult > &value )
 {
     m_results = value;
+    m_loadedResults.assign( m_results.size(), true );
 }
 
 const std::vector< MonocularCalibrationResult > &MonocularCalibrationData::results() const
 {
+    loadResults();
+
     return m_results;
 }
 
 MonocularCalibrationResult &MonocularCalibrationData::result( const unsigned int i )
 {
+    loadResult( i );
+
     return m_results[i];
 }
 
 const MonocularCalibrationResult &MonocularCalibrationData::result( const unsigned int i ) const
 {
+    loadResult( i );
+
     return m_results[i];
 }
 
+void MonocularCalibrationData::loadResult( const unsigned int i ) const
+{
+    if ( i >= m_loadedResults.size() || m_loadedResults[ i ] || !m_archive )
+        return;
+
+    auto data = m_archive->readChunk( CalibrationArchiveBase::VIEW, m_archiveCamera, i );
+
+    QDataStream stream( data );
+
+    bool ok;
+
+    stream >> ok;
+
+    MonocularCalibrationResult result;
+
+    result.setRVec( CalibrationArchiveBase::readMat( stream ) );
+    result.setTVec( CalibrationArchiveBase::readMat( stream ) );
+    result.setPoints2d( CalibrationArchiveBase::readPoints2f( stream ) );
+    result.setPoints3d( CalibrationArchiveBase::readPoints3f( stream ) );
+    result.setOk( ok && stream.status() == QDataStream::Ok );
+
+    m_results[ i ] = result;
+    m_loadedResults[ i ] = true;
+
+}
+
+void MonocularCalibrationData::loadResults() const
+{
+    for ( size_t i = 0; i < m_loadedResults.size(); ++i )
+        loadResult( i );
+}
+
 unsigned int MonocularCalibrationData::resultsSize() const
 {
     return m_results.size();
@@ -105,7 +149,15 @@ void MonocularCalibrationData::setPreviewImage( const CvImage &image )
 
 const CvImage &MonocularCalibrationData::previewImage() const
 {
+    if ( m_previewImage.empty() && m_archive && m_archive->contains( CalibrationArchiveBase::PREVIEW, m_archiveCamera ) ) {
+        auto data = m_archive->readChunk( CalibrationArchiveBase::PREVIEW, m_archiveCamera );
+
+        m_previewImage = cv::imdecode( cv::Mat( 1, data.size(), CV_8U, data.data() ), cv::IMREAD_COLOR );
+
+    }
+
     return m_previewImage;
+
 }
 
 bool MonocularCalibrationData::saveYaml( const std::string &fileName ) const
@@ -170,6 +222,126 @@ bool MonocularCalibrationData::loadYaml( const std::string &fileName )
 
 }
 
+bool MonocularCalibrationData::saveArchive( const std::string &fileName ) const
+{
+    if ( !isOk() )
+        return false;
+
+    CalibrationArchiveWriter archive( fileName, CalibrationArchiveBase::MONOCULAR );
+
+    return writeArchive( archive, 0 ) && archive.close();
+
+}
+
+bool MonocularCalibrationData::loadArchive( const std::string &fileName )
+{
+    auto archive = std::make_shared< CalibrationArchiveReader >( fileName );
+
+    if ( !archive->isOpen() || archive->archiveType() != CalibrationArchiveBase::MONOCULAR )
+        return false;
+
+    return readArchive( archive, 0 );
+
+}
+
+bool MonocularCalibrationData::writeArchive( CalibrationArchiveWriter &archive, const unsigned int camera ) const
+{
+    if ( !archive.isOpen() )
+        return false;
+
+    QByteArray intrinsics;
+
+    {
+        QDataStream stream( &intrinsics, QIODevice::WriteOnly );
+
+        stream << static_cast< qint32 >( frameSize().width ) << static_cast< qint32 >( frameSize().height );
+        CalibrationArchiveBase::writeMat( stream, cameraMatrix() );
+        CalibrationArchiveBase::writeMat( stream, distortionCoefficients() );
+        stream << error() << isOk() << static_cast< quint32 >( resultsSize() );
+
+    }
+
+    if ( !archive.writeChunk( CalibrationArchiveBase::INTRINSICS, camera, 0, intrinsics ) )
+        return false;
+
+    auto &preview = previewImage();
+
+    if ( !preview.empty() ) {
+        std::vector< uchar > buffer;
+
+        if ( cv::imencode( ".jpg", preview, buffer, { cv::IMWRITE_JPEG_QUALITY, 95 } ) )
+            archive.writeChunk( CalibrationArchiveBase::PREVIEW, camera, 0, QByteArray( reinterpret_cast< const char * >( buffer.data() ), buffer.size() ) );
+
+    }
+
+    for ( unsigned int i = 0; i < resultsSize(); ++i ) {
+        auto &current = result( i );
+
+        QByteArray view;
+
+        {
+            QDataStream stream( &view, QIODevice::WriteOnly );
+
+            stream << current.isOk();
+            CalibrationArchiveBase::writeMat( stream, current.rVec() );
+            CalibrationArchiveBase::writeMat( stream, current.tVec() );
+            CalibrationArchiveBase::writePoints( stream, current.points2d() );
+            CalibrationArchiveBase::writePoints( stream, current.points3d() );
+
+        }
+
+        if ( !archive.writeChunk( CalibrationArchiveBase::VIEW, camera, i, view ) )
+            return false;
+
+    }
+
+    return true;
+
+}
+
+bool MonocularCalibrationData::readArchive( const std::shared_ptr< CalibrationArchiveReader > &archive, const unsigned int camera )
+{
+    if ( !archive || !archive->contains( CalibrationArchiveBase::INTRINSICS, camera ) )
+        return false;
+
+    auto data = archive->readChunk( CalibrationArchiveBase::INTRINSICS, camera );
+
+    QDataStream stream( data );
+
+    qint32 width, height;
+
+    stream >> width >> height;
+
+    auto cameraMatrix = CalibrationArchiveBase::readMat( stream );
+    auto distortionCoefficients = CalibrationArchiveBase::readMat( stream );
+
+    double error;
+    bool ok;
+    quint32 resultsCount;
+
+    stream >> error >> ok >> resultsCount;
+
+    if ( stream.status() != QDataStream::Ok )
+        return false;
+
+    setFrameSize( cv::Size( width, height ) );
+    setCameraMatrix( cameraMatrix );
+    setDistortionCoefficients( distortionCoefficients );
+    setError( error );
+    setOk( ok );
+
+    // Views and preview are read from the archive on first access
+    m_results.assign( resultsCount, MonocularCalibrationResult() );
+    m_loadedResults.assign( resultsCount, false );
+    m_previewImage = CvImage();
+
+    m_archive = archive;
+    m_archiveCamera = camera;
+
+    return true;
+
+}
+
 // StereoCalibrationData
 StereoCalibrationData::StereoCalibrationData()
 {
@@ -352,6 +524,106 @@ bool StereoCalibrationData::loadYaml( const std::string &fileName )
 
 }
 
+bool StereoCalibrationData::saveArchive( const std::string &fileName ) const
+{
+    if ( !isOk() )
+        return false;
+
+    CalibrationArchiveWriter archive( fileName, CalibrationArchiveBase::STEREO );
+
+    if ( !leftCameraResults().writeArchive( archive, 0 ) || !rightCameraResults().writeArchive( archive, 1 ) )
+        return false;
+
+    QByteArray extrinsics;
+
+    {
+        QDataStream stream( &extrinsics, QIODevice::WriteOnly );
+
+        stream << static_cast< quint32 >( correspondFrameCount() );
+
+        CalibrationArchiveBase::writeMat( stream, rotationMatrix() );
+        CalibrationArchiveBase::writeMat( stream, translationVector() );
+        CalibrationArchiveBase::writeMat( stream, fundamentalMatrix() );
+        CalibrationArchiveBase::writeMat( stream, essentialMatrix() );
+        CalibrationArchiveBase::writeMat( stream, leftRectifyMatrix() );
+        CalibrationArchiveBase::writeMat( stream, rightRectifyMatrix() );
+        CalibrationArchiveBase::writeMat( stream, leftProjectionMatrix() );
+        CalibrationArchiveBase::writeMat( stream, rightProjectionMatrix() );
+
+        stream << leftROI().x << leftROI().y << leftROI().width << leftROI().height;
+        stream << rightROI().x << rightROI().y << rightROI().width << rightROI().height;
+
+        stream << error();
+
+    }
+
+    return archive.writeChunk( CalibrationArchiveBase::EXTRINSICS, 0, 0, extrinsics ) && archive.close();
+
+}
+
+bool StereoCalibrationData::loadArchive( const std::string &fileName )
+{
+    auto archive = std::make_shared< CalibrationArchiveReader >( fileName );
+
+    if ( !archive->isOpen() || archive->archiveType() != CalibrationArchiveBase::STEREO || !archive->contains( CalibrationArchiveBase::EXTRINSICS, 0 ) )
+        return false;
+
+    if ( !leftCameraResults().readArchive( archive, 0 ) || !rightCameraResults().readArchive( archive, 1 ) )
+        return false;
+
+    auto data = archive->readChunk( CalibrationArchiveBase::EXTRINSICS, 0 );
+
+    QDataStream stream( data );
+
+    quint32 correspondFrameCount;
+
+    stream >> correspondFrameCount;
+
+    auto rotationMatrix = CalibrationArchiveBase::readMat( stream );
+    auto translationVector = CalibrationArchiveBase::readMat( stream );
+    auto fundamentalMatrix = CalibrationArchiveBase::readMat( stream );
+    auto essentialMatrix = CalibrationArchiveBase::readMat( stream );
+    auto leftRectifyMatrix = CalibrationArchiveBase::readMat( stream );
+    auto rightRectifyMatrix = CalibrationArchiveBase::readMat( stream );
+    auto leftProjectionMatrix = CalibrationArchiveBase::readMat( stream );
+    auto rightProjectionMatrix = CalibrationArchiveBase::readMat( stream );
+
+    cv::Rect leftROI;
+    cv::Rect rightROI;
+
+    stream >> leftROI.x >> leftROI.y >> leftROI.width >> leftROI.height;
+    stream >> rightROI.x >> rightROI.y >> rightROI.width >> rightROI.height;
+
+    double error;
+
+    stream >> error;
+
+    if ( stream.status() != QDataStream::Ok )
+        return false;
+
+    setCorrespondFrameCount( correspondFrameCount );
+
+    setRotationMatrix( rotationMatrix );
+    setTranslationVector( translationVector );
+    setFundamentalMatrix( fundamentalMatrix );
+    setEssentialMatrix( essentialMatrix );
+
+    setLeftRectifyMatrix( leftRectifyMatrix );
+    setRightRectifyMatrix( rightRectifyMatrix );
+    setLeftProjectionMatrix( leftProjectionMatrix );
+    setRightProjectionMatrix( rightProjectionMatrix );
+
+    setLeftROI( leftROI );
+    setRightROI( rightROI );
+
+    setError( error );
+
+    setOk( true );
+
+    return true;
+
+}
+
 StereoCalibrationData::operator StereoCalibrationDataShort() const
 {
     StereoCalibrationDataShort ret( *static_cast< const StereoCalibrationDataBase * const >( this ) );
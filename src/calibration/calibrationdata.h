@@ -2,8 +2,12 @@
 
 #include "src/common/calibrationdatabase.h"
 
+#include <memory>
+
 class MonocularIcon;
 class StereoIcon;
+class CalibrationArchiveWriter;
+class CalibrationArchiveReader;
 
 class MonocularCalibrationResult
 {
@@ -58,10 +62,23 @@ public:
     bool saveYaml( const std::string &fileName ) const;
     bool loadYaml( const std::string &fileName );
 
+    bool saveArchive( const std::string &fileName ) const;
+    bool loadArchive( const std::string &fileName );
+
+    bool writeArchive( CalibrationArchiveWriter &archive, const unsigned int camera ) const;
+    bool readArchive( const std::shared_ptr< CalibrationArchiveReader > &archive, const unsigned int camera );
+
 protected:
-    std::vector< MonocularCalibrationResult > m_results;
+    mutable std::vector< MonocularCalibrationResult > m_results;
+    mutable std::vector< bool > m_loadedResults;
 
-    CvImage m_previewImage;
+    mutable CvImage m_previewImage;
+
+    std::shared_ptr< CalibrationArchiveReader > m_archive;
+    unsigned int m_archiveCamera;
+
+    void loadResult( const unsigned int i ) const;
+    void loadResults() const;
 
 private:
     void initialize();
@@ -86,6 +103,9 @@ public:
     bool saveYaml( const std::string &fileName ) const;
     bool loadYaml( const std::string &fileName );
 
+    bool saveArchive( const std::string &fileName ) const;
+    bool loadArchive( const std::string &fileName );
+
     operator StereoCalibrationDataShort() const;
 
 protected:
@@ -104,7 +104,8 @@ StereoIcon::StereoIcon( const CvImage leftPreviewImage,
                         const std::vector< cv::Point2f > &rightImagePoints,
                         const std::vector<cv::Point3f> &worldPoints,
                         const QString &text )
-    : CalibrationIconBase( makeOverlappedPreview( leftPreviewImage, rightPreviewImage ), frameSize, worldPoints, text )
+    : CalibrationIconBase( makeOverlappedPreview( resizeTo( leftPreviewImage, thumbnailSize() ), resizeTo( rightPreviewImage, thumbnailSize() ) ),
+                           frameSize, worldPoints, text )
 {
     setLeftPreview( leftPreviewImage );
     setRightPreview( rightPreviewImage );
@@ -121,27 +122,27 @@ void StereoIcon::initialize()
 
 void StereoIcon::setLeftPreview( const CvImage &image )
 {
-    m_leftPreview = image;
+    m_leftPreview = CachedImage( image, thumbnailSize() );
 }
 
 void StereoIcon::setRightPreview(const CvImage &image)
 {
-    m_rightPreview = image;
+    m_rightPreview = CachedImage( image, thumbnailSize() );
 }
 
-const CvImage &StereoIcon::leftPreview() const
+CvImage StereoIcon::leftPreview() const
 {
-    return m_leftPreview;
+    return m_leftPreview.image();
 }
 
-const CvImage &StereoIcon::rightPreview() const
+CvImage StereoIcon::rightPreview() const
 {
-    return m_rightPreview;
+    return m_rightPreview.image();
 }
 
 const CvImage StereoIcon::stackedPreview() const
 {
-    return makeStraightPreview( m_leftPreview, m_rightPreview );
+    return makeStraightPreview( leftPreview(), rightPreview() );
 }
 
 void StereoIcon::setLeftImagePoints( const std::vector< cv::Point2f > &points )
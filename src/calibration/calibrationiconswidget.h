@@ -80,8 +80,8 @@ public:
     void setLeftPreview( const CvImage &image );
     void setRightPreview( const CvImage &image );
 
-    const CvImage &leftPreview() const;
-    const CvImage &rightPreview() const;
+    CvImage leftPreview() const;
+    CvImage rightPreview() const;
 
     const CvImage stackedPreview() const;
 
@@ -92,8 +92,8 @@ public:
     std::vector< cv::Point2f > rightImagePoints() const;
 
 protected:
-    CvImage m_leftPreview;
-    CvImage m_rightPreview;
+    CachedImage m_leftPreview;
+    CachedImage m_rightPreview;
 
     std::vector< cv::Point2f > m_leftImagePoints;
     std::vector< cv::Point2f > m_rightImagePoints;
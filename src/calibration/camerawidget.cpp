@@ -40,6 +40,7 @@ void MonocularCameraWidget::initialize()
     m_previewWidget = new CameraPreviewWidget( this );
     addWidget( m_previewWidget );
 
+    m_previewThread.setMarkerTracking( true );
     m_previewThread.start();
 
     connect( &m_camera, &MasterCamera::receivedFrame, this, &MonocularCameraWidget::reciveFrame );
@@ -202,6 +203,7 @@ void StereoCameraWidget::initialize()
     addWidget( m_leftCameraWidget );
     addWidget( m_rightCameraWidget );
 
+    m_previewThread.setMarkerTracking( true );
     m_previewThread.start();
 
     connect( &m_camera, &StereoCamera::receivedFrame, this, &StereoCameraWidget::reciveFrame );
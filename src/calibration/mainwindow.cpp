@@ -4,6 +4,7 @@
 
 #include "calibrationwidget.h"
 #include "documentwidget.h"
+#include "calibrationarchive.h"
 
 #include "src/common/ipwidget.h"
 
@@ -165,6 +166,8 @@ void MainWindow::setupActions()
 
     connect( m_newCalibrationDocumentAction, &QAction::triggered, this, &MainWindow::choiceCalibrationDialog );
 
+    connect( m_openAction, &QAction::triggered, this, &MainWindow::openDialog );
+
     connect( m_importAction, &QAction::triggered, this, &MainWindow::importDialog );
     connect( m_exportAction, &QAction::triggered, this, &MainWindow::exportDialog );
 
@@ -239,6 +242,36 @@ void MainWindow::timerEvent( QTimerEvent * )
 
 }
 
+void MainWindow::openDialog()
+{
+    auto fileName = QFileDialog::getOpenFileName( this, tr( "Open calibration results" ), QString(), tr( "Calibration archives (*.calib)" ), nullptr,
+                                                  QFileDialog::DontUseNativeDialog );
+
+    if ( fileName.isEmpty() )
+        return;
+
+    CalibrationArchiveReader archive( fileName.toStdString() );
+
+    if ( !archive.isOpen() )
+        return;
+
+    if ( archive.archiveType() == CalibrationArchiveBase::STEREO ) {
+        StereoCalibrationData calibration;
+
+        if ( calibration.loadArchive( fileName.toStdString() ) )
+            addStereoReportDocument()->report( calibration );
+
+    }
+    else {
+        MonocularCalibrationData calibration;
+
+        if ( calibration.loadArchive( fileName.toStdString() ) )
+            addMonocularReportDocument()->report( calibration );
+
+    }
+
+}
+
 void MainWindow::importDialog()
 {
     auto doc = currentCalibrationDocument();
@@ -48,6 +48,8 @@ public:
     ReportDocumentBase *currentReportDocument() const;
 
 public slots:
+    void openDialog();
+
     void importDialog();
     void exportDialog();
 
@@ -176,11 +176,15 @@ const MonocularCalibrationData &MonocularReportWidget::calibrationResults() cons
 void MonocularReportWidget::saveYAMLDialog()
 {
     if ( m_calibrationResults.isOk() ) {
-        auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save calibration file" ), QString(), tr( "OpenCV YAML files (*.yaml)" ), nullptr,
+        auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save calibration file" ), QString(),
+                                                      tr( "OpenCV YAML files (*.yaml)" ) + ";;" + tr( "Calibration archives (*.calib)" ), nullptr,
                                                       QFileDialog::DontUseNativeDialog );
 
         if ( !fileName.isEmpty() ) {
-            m_calibrationResults.saveYaml( fileName.toStdString() );
+            if ( QFileInfo( fileName ).suffix() == "calib" )
+                m_calibrationResults.saveArchive( fileName.toStdString() );
+            else
+                m_calibrationResults.saveYaml( fileName.toStdString() );
 
         }
 
@@ -190,6 +194,31 @@ void MonocularReportWidget::saveYAMLDialog()
 
 void MonocularReportWidget::loadYAMLDialog()
 {
+    auto fileName = QFileDialog::getOpenFileName( nullptr, tr( "Open calibration file" ), QString(),
+                                                  tr( "Calibration archives (*.calib)" ) + ";;" + tr( "OpenCV YAML files (*.yaml)" ), nullptr,
+                                                  QFileDialog::DontUseNativeDialog );
+
+    if ( !fileName.isEmpty() )
+        loadFile( fileName );
+
+}
+
+bool MonocularReportWidget::loadFile( const QString &fileName )
+{
+    MonocularCalibrationData calibration;
+
+    bool ok;
+
+    if ( QFileInfo( fileName ).suffix() == "calib" )
+        ok = calibration.loadArchive( fileName.toStdString() );
+    else
+        ok = calibration.loadYaml( fileName.toStdString() );
+
+    if ( ok )
+        report( calibration );
+
+    return ok;
+
 }
 
 // StereoReportWidget
@@ -318,11 +347,15 @@ const StereoCalibrationData &StereoReportWidget::calibrationResults() const
 void StereoReportWidget::saveYAMLDialog()
 {
     if ( m_calibrationResults.isOk() ) {
-        auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save calibration file" ), QString(), tr( "OpenCV YAML files (*.yaml)" ), nullptr,
+        auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save calibration file" ), QString(),
+                                                      tr( "OpenCV YAML files (*.yaml)" ) + ";;" + tr( "Calibration archives (*.calib)" ), nullptr,
                                                       QFileDialog::DontUseNativeDialog );
 
         if ( !fileName.isEmpty() ) {
-            m_calibrationResults.saveYaml( fileName.toStdString() );
+            if ( QFileInfo( fileName ).suffix() == "calib" )
+                m_calibrationResults.saveArchive( fileName.toStdString() );
+            else
+                m_calibrationResults.saveYaml( fileName.toStdString() );
 
         }
 
@@ -332,5 +365,30 @@ void StereoReportWidget::saveYAMLDialog()
 
 void StereoReportWidget::loadYAMLDialog()
 {
+    auto fileName = QFileDialog::getOpenFileName( nullptr, tr( "Open calibration file" ), QString(),
+                                                  tr( "Calibration archives (*.calib)" ) + ";;" + tr( "OpenCV YAML files (*.yaml)" ), nullptr,
+                                                  QFileDialog::DontUseNativeDialog );
+
+    if ( !fileName.isEmpty() )
+        loadFile( fileName );
+
+}
+
+bool StereoReportWidget::loadFile( const QString &fileName )
+{
+    StereoCalibrationData calibration;
+
+    bool ok;
+
+    if ( QFileInfo( fileName ).suffix() == "calib" )
+        ok = calibration.loadArchive( fileName.toStdString() );
+    else
+        ok = calibration.loadYaml( fileName.toStdString() );
+
+    if ( ok )
+        report( calibration );
+
+    return ok;
+
 }
 
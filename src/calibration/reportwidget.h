@@ -46,6 +46,8 @@ public:
     void report( const MonocularCalibrationData &calibration );
     const MonocularCalibrationData &calibrationResults() const;
 
+    bool loadFile( const QString &fileName );
+
 public slots:
     void saveYAMLDialog();
     void loadYAMLDialog();
@@ -65,6 +67,8 @@ public:
     void report( const StereoCalibrationData &calibration );
     const StereoCalibrationData &calibrationResults() const;
 
+    bool loadFile( const QString &fileName );
+
 public slots:
     void saveYAMLDialog();
     void loadYAMLDialog();
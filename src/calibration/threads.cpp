@@ -2,6 +2,8 @@
 
 #include "threads.h"
 
+#include "src/common/taskscheduler.h"
+
 #include <thread>
 
 ProcessorThreadBase::ProcessorThreadBase( QObject *parent )
@@ -13,6 +15,7 @@ ProcessorThreadBase::ProcessorThreadBase( QObject *parent )
 void ProcessorThreadBase::initialize()
 {
     m_type = NONE;
+    m_markerTracking = false;
 }
 
 const TemplateProcessor &ProcessorThreadBase::templateProcessor() const
@@ -35,6 +38,16 @@ ArucoProcessor &ProcessorThreadBase::markerProcessor()
     return m_markerProcessor;
 }
 
+void ProcessorThreadBase::setMarkerTracking( const bool value )
+{
+    m_markerTracking = value;
+}
+
+bool ProcessorThreadBase::markerTracking() const
+{
+    return m_markerTracking;
+}
+
 // MonocularProcessorThread
 MonocularProcessorThread::MonocularProcessorThread( QObject *parent )
     : ProcessorThreadBase( parent )
@@ -55,7 +68,7 @@ void MonocularProcessorThread::processFrame( const StampedImage &frame, Type typ
 
 }
 
-MonocularProcessorResult MonocularProcessorThread::calculate( const StampedImage &frame , const Type type ) const
+MonocularProcessorResult MonocularProcessorThread::calculate( const StampedImage &frame , const Type type, ArucoTrackingState *trackingState ) const
 {
     MonocularProcessorResult ret;
 
@@ -75,7 +88,7 @@ MonocularProcessorResult MonocularProcessorThread::calculate( const StampedImage
 
         ArucoMarkerList list;
 
-        ret.exist = m_markerProcessor.processFrame( frame, &ret.preview, &list );
+        ret.exist = m_markerProcessor.processFrame( frame, &ret.preview, &list, trackingState );
 
         if ( ret.exist ) {
             ret.imagePoints = list.centerPoints();
@@ -106,7 +119,10 @@ void MonocularProcessorThread::run()
 
         if ( m_type != NONE ) {
 
-            m_result = calculate( m_frame, m_type );
+            if ( m_markerTracking )
+                m_result = calculate( m_frame, m_type, &m_trackingState );
+            else
+                m_result = calculate( m_frame, m_type );
 
             m_type = NONE;
 
@@ -140,7 +156,8 @@ void StereoProcessorThread::processFrame( const StampedStereoImage &frame, Type
 
 }
 
-StereoProcessorResult StereoProcessorThread::calculate( const StampedStereoImage &frame, const Type type ) const
+StereoProcessorResult StereoProcessorThread::calculate( const StampedStereoImage &frame, const Type type,
+                                                       ArucoTrackingState *leftTrackingState, ArucoTrackingState *rightTrackingState ) const
 {
     StereoProcessorResult ret;
 
@@ -148,8 +165,12 @@ StereoProcessorResult StereoProcessorThread::calculate( const StampedStereoImage
 
         ret.sourceFrame = frame;
 
-        ret.leftExist = m_templateProcessor.processFrame( frame.leftImage(), &ret.leftPreview, &ret.leftImagePoints );
-        ret.rightExist = m_templateProcessor.processFrame( frame.rightImage(), &ret.rightPreview, &ret.rightImagePoints );
+        TaskGroup group( TaskScheduler::CAPTURE );
+
+        group.run( [ & ] { ret.leftExist = m_templateProcessor.processFrame( frame.leftImage(), &ret.leftPreview, &ret.leftImagePoints ); } );
+        group.run( [ & ] { ret.rightExist = m_templateProcessor.processFrame( frame.rightImage(), &ret.rightPreview, &ret.rightImagePoints ); } );
+
+        group.wait();
 
         if ( ret.leftExist && ret.rightExist )
             m_templateProcessor.calcCorners( &ret.worldPoints );
@@ -162,8 +183,12 @@ StereoProcessorResult StereoProcessorThread::calculate( const StampedStereoImage
         ArucoMarkerList leftList;
         ArucoMarkerList rightList;
 
-        ret.leftExist = m_markerProcessor.processFrame( frame.leftImage(), &ret.leftPreview, &leftList );
-        ret.rightExist = m_markerProcessor.processFrame( frame.rightImage(), &ret.rightPreview, &rightList );
+        TaskGroup group( TaskScheduler::CAPTURE );
+
+        group.run( [ & ] { ret.leftExist = m_markerProcessor.processFrame( frame.leftImage(), &ret.leftPreview, &leftList, leftTrackingState ); } );
+        group.run( [ & ] { ret.rightExist = m_markerProcessor.processFrame( frame.rightImage(), &ret.rightPreview, &rightList, rightTrackingState ); } );
+
+        group.wait();
 
         if ( ret.leftExist && ret.rightExist ) {
 
@@ -198,7 +223,10 @@ void StereoProcessorThread::run()
 
         if ( m_type != NONE ) {
 
-            m_result = calculate( m_frame, m_type );
+            if ( m_markerTracking )
+                m_result = calculate( m_frame, m_type, &m_leftTrackingState, &m_rightTrackingState );
+            else
+                m_result = calculate( m_frame, m_type );
 
             m_type = NONE;
 
@@ -42,6 +42,9 @@ public:
     const ArucoProcessor &markerProcessor() const;
     ArucoProcessor &markerProcessor();
 
+    void setMarkerTracking( const bool value );
+    bool markerTracking() const;
+
 signals:
     void updateSignal();
 
@@ -51,6 +54,8 @@ protected:
     TemplateProcessor m_templateProcessor;
     ArucoProcessor m_markerProcessor;
 
+    bool m_markerTracking;
+
     mutable QMutex m_mutex;
 
 private:
@@ -67,7 +72,7 @@ public:
 
     void processFrame( const StampedImage &frame, Type type );
 
-    MonocularProcessorResult calculate( const StampedImage &frame, const Type type ) const;
+    MonocularProcessorResult calculate( const StampedImage &frame, const Type type, ArucoTrackingState *trackingState = nullptr ) const;
 
     MonocularProcessorResult result() const;
 
@@ -75,6 +80,8 @@ protected:
     StampedImage m_frame;
     MonocularProcessorResult m_result;
 
+    ArucoTrackingState m_trackingState;
+
     virtual void run() override;
 
 private:
@@ -91,7 +98,8 @@ public:
 
     void processFrame( const StampedStereoImage &frame, Type type );
 
-    StereoProcessorResult calculate( const StampedStereoImage &frame, const Type type ) const;
+    StereoProcessorResult calculate( const StampedStereoImage &frame, const Type type,
+                                     ArucoTrackingState *leftTrackingState = nullptr, ArucoTrackingState *rightTrackingState = nullptr ) const;
 
     StereoProcessorResult result() const;
 
@@ -99,6 +107,9 @@ protected:
     StampedStereoImage m_frame;
     StereoProcessorResult m_result;
 
+    ArucoTrackingState m_leftTrackingState;
+    ArucoTrackingState m_rightTrackingState;
+
     virtual void run() override;
 
 private:
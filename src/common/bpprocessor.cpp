@@ -0,0 +1,501 @@
+#include "precompiled.h"
+
+#include "bpprocessor.h"
+
+#include "defs.h"
+#include "taskscheduler.h"
+
+#include <limits>
+
+// Belief sums stay below the 16 bit limit with some room for rounding
+static const int MAX_BELIEF = 30000;
+
+// Coarse data costs are sums of the finer ones, deeper levels saturate instead of losing precision
+static const int MAX_PRECISE_LEVEL = 4;
+
+// Above this many single jumps the min-convolution runs as two sequential passes
+static const int MAX_SHIFTED_JUMPS = 16;
+
+// BPCPUDisparityProcessor
+BPCPUDisparityProcessor::BPCPUDisparityProcessor()
+    : DisparityProcessorBase()
+{
+    initialize();
+}
+
+void BPCPUDisparityProcessor::initialize()
+{
+    // cv::cuda::StereoBeliefPropagation defaults
+    m_numDisparities = 64;
+    m_numIterations = 5;
+    m_numLevels = 5;
+
+    m_maxDataTerm = 10.;
+    m_dataWeight = 0.07;
+    m_maxDiscTerm = 1.7;
+    m_discSingleJump = 1.;
+
+    m_scale = 0.5;
+
+    m_labelsCount = 0;
+    m_costScale = 1.f;
+    m_dataCap = 0;
+    m_discTerm = 0;
+    m_discJump = 0;
+}
+
+int BPCPUDisparityProcessor::getNumDisparities() const
+{
+    return m_numDisparities;
+}
+
+void BPCPUDisparityProcessor::setNumDisparities( const int value )
+{
+    m_numDisparities = std::max( 1, value );
+}
+
+int BPCPUDisparityProcessor::getNumIterations() const
+{
+    return m_numIterations;
+}
+
+void BPCPUDisparityProcessor::setNumIterations( const int value )
+{
+    m_numIterations = std::max( 0, value );
+}
+
+int BPCPUDisparityProcessor::getNumLevels() const
+{
+    return m_numLevels;
+}
+
+void BPCPUDisparityProcessor::setNumLevels( const int value )
+{
+    m_numLevels = std::max( 1, value );
+}
+
+double BPCPUDisparityProcessor::getMaxDataTerm() const
+{
+    return m_maxDataTerm;
+}
+
+void BPCPUDisparityProcessor::setMaxDataTerm( const double value )
+{
+    m_maxDataTerm = std::max( 0., value );
+}
+
+double BPCPUDisparityProcessor::getDataWeight() const
+{
+    return m_dataWeight;
+}
+
+void BPCPUDisparityProcessor::setDataWeight( const double value )
+{
+    m_dataWeight = std::max( 0., value );
+}
+
+double BPCPUDisparityProcessor::getMaxDiscTerm() const
+{
+    return m_maxDiscTerm;
+}
+
+void BPCPUDisparityProcessor::setMaxDiscTerm( const double value )
+{
+    m_maxDiscTerm = std::max( 0., value );
+}
+
+double BPCPUDisparityProcessor::getDiscSingleJump() const
+{
+    return m_discSingleJump;
+}
+
+void BPCPUDisparityProcessor::setDiscSingleJump( const double value )
+{
+    m_discSingleJump = std::max( 0., value );
+}
+
+double BPCPUDisparityProcessor::getScale() const
+{
+    return m_scale;
+}
+
+void BPCPUDisparityProcessor::setScale( const double value )
+{
+    m_scale = std::min( 1., std::max( 0.1, value ) );
+}
+
+cv::Range BPCPUDisparityProcessor::disparityRange() const
+{
+    return cv::Range( 0, m_numDisparities );
+}
+
+std::vector< double > BPCPUDisparityProcessor::parameters() const
+{
+    return { double( m_numDisparities ), double( m_numIterations ), double( m_numLevels ),
+             m_maxDataTerm, m_dataWeight, m_maxDiscTerm, m_discSingleJump, m_scale };
+}
+
+void BPCPUDisparityProcessor::computeDataCosts( const cv::Mat &left, const cv::Mat &right )
+{
+    auto width = left.cols;
+    auto count = m_labelsCount;
+
+    auto &costs = m_dataCosts.front();
+    costs.resize( left.total() * count );
+
+    auto weight = static_cast< float >( m_costScale * m_dataWeight );
+    auto maxCost = std::min( static_cast< float >( m_costScale * m_dataWeight * m_maxDataTerm ), static_cast< float >( m_dataCap ) );
+
+    // Disparities that point outside of the right image get the truncated cost
+    auto outsideCost = static_cast< int16_t >( maxCost + 0.5f );
+
+    parallelFor( 0, left.rows, [ & ]( const int y ) {
+        auto leftRow = left.ptr< uchar >( y );
+        auto rightRow = right.ptr< uchar >( y );
+
+        // Reversed right row, so matched pixels are read forward with growing disparity
+        std::vector< float > reversed( width );
+
+        for ( int x = 0; x < width; ++x )
+            reversed[ x ] = rightRow[ width - 1 - x ];
+
+        for ( int x = 0; x < width; ++x ) {
+            auto pixelCosts = costs.data() + ( y * width + x ) * count;
+            auto valid = std::min( count, x + 1 );
+
+            float value = leftRow[ x ];
+            auto rightPixels = reversed.data() + width - 1 - x;
+
+            #pragma omp simd
+            for ( int d = 0; d < valid; ++d ) {
+                auto cost = std::abs( value - rightPixels[ d ] ) * weight;
+                pixelCosts[ d ] = static_cast< int16_t >( ( cost < maxCost ? cost : maxCost ) + 0.5f );
+            }
+
+            std::fill( pixelCosts + valid, pixelCosts + count, outsideCost );
+
+        }
+
+    } );
+
+}
+
+void BPCPUDisparityProcessor::downsampleDataCosts( const int level )
+{
+    auto &fineSize = m_levelSizes[ level - 1 ];
+    auto &size = m_levelSizes[ level ];
+
+    auto count = m_labelsCount;
+
+    auto &fine = m_dataCosts[ level - 1 ];
+    auto &costs = m_dataCosts[ level ];
+    costs.resize( size.area() * count );
+
+    int cap = m_dataCap;
+
+    parallelFor( 0, size.height, [ & ]( const int y ) {
+        std::vector< int > sums( count );
+
+        for ( int x = 0; x < size.width; ++x ) {
+            std::fill( sums.begin(), sums.end(), 0 );
+
+            for ( int fineY = 2 * y; fineY < std::min( 2 * y + 2, fineSize.height ); ++fineY )
+                for ( int fineX = 2 * x; fineX < std::min( 2 * x + 2, fineSize.width ); ++fineX ) {
+                    auto child = fine.data() + ( fineY * fineSize.width + fineX ) * count;
+
+                    #pragma omp simd
+                    for ( int d = 0; d < count; ++d )
+                        sums[ d ] += child[ d ];
+
+                }
+
+            auto pixelCosts = costs.data() + ( y * size.width + x ) * count;
+
+            #pragma omp simd
+            for ( int d = 0; d < count; ++d )
+                pixelCosts[ d ] = static_cast< int16_t >( sums[ d ] < cap ? sums[ d ] : cap );
+
+        }
+
+    } );
+
+}
+
+// Finer messages start from the ones of the parent pixel
+void BPCPUDisparityProcessor::initializeMessages( const int level )
+{
+    auto &size = m_levelSizes[ level ];
+    auto count = m_labelsCount;
+
+    auto isCoarsest = level == static_cast< int >( m_levelSizes.size() ) - 1;
+
+    for ( int i = 0; i < DIRECTIONS_COUNT; ++i ) {
+        std::swap( m_messages[ i ], m_coarseMessages[ i ] );
+
+        m_messages[ i ].resize( size.area() * count );
+
+        if ( isCoarsest )
+            std::fill( m_messages[ i ].begin(), m_messages[ i ].end(), 0 );
+
+    }
+
+    if ( isCoarsest )
+        return;
+
+    auto &coarseSize = m_levelSizes[ level + 1 ];
+
+    parallelFor( 0, size.height, [ & ]( const int y ) {
+        for ( int i = 0; i < DIRECTIONS_COUNT; ++i ) {
+            auto row = m_messages[ i ].data() + y * size.width * count;
+            auto coarseRow = m_coarseMessages[ i ].data() + ( y / 2 ) * coarseSize.width * count;
+
+            for ( int x = 0; x < size.width; ++x )
+                std::copy( coarseRow + ( x / 2 ) * count, coarseRow + ( x / 2 + 1 ) * count, row + x * count );
+
+        }
+
+    } );
+
+}
+
+// Min-convolution of the belief without the receiver's own message with the truncated linear
+// smoothness cost, normalized to a zero minimum
+void BPCPUDisparityProcessor::sendMessage( const int16_t *belief, const int16_t *received, int16_t *buffer, int16_t *message ) const
+{
+    auto count = m_labelsCount;
+
+    int16_t minCost = std::numeric_limits< int16_t >::max();
+
+    #pragma omp simd reduction( min : minCost )
+    for ( int d = 0; d < count; ++d ) {
+        buffer[ d ] = static_cast< int16_t >( belief[ d ] - received[ d ] );
+        minCost = buffer[ d ] < minCost ? buffer[ d ] : minCost;
+    }
+
+    // Free jumps make every disparity as cheap as the best one
+    if ( m_discJump == 0 ) {
+        std::fill( message, message + count, 0 );
+        return;
+    }
+
+    auto jumpsCount = std::min( count - 1, m_discTerm / m_discJump );
+
+    if ( jumpsCount <= MAX_SHIFTED_JUMPS ) {
+        // Every disparity within the truncation distance, as whole shifted rows
+        std::copy( buffer, buffer + count, message );
+
+        for ( int k = 1; k <= jumpsCount; ++k ) {
+            auto penalty = static_cast< int16_t >( k * m_discJump );
+
+            #pragma omp simd
+            for ( int d = k; d < count; ++d ) {
+                auto cost = static_cast< int16_t >( buffer[ d - k ] + penalty );
+                message[ d ] = cost < message[ d ] ? cost : message[ d ];
+            }
+
+            #pragma omp simd
+            for ( int d = 0; d < count - k; ++d ) {
+                auto cost = static_cast< int16_t >( buffer[ d + k ] + penalty );
+                message[ d ] = cost < message[ d ] ? cost : message[ d ];
+            }
+
+        }
+
+    }
+    else {
+        message[ 0 ] = buffer[ 0 ];
+
+        for ( int d = 1; d < count; ++d )
+            message[ d ] = std::min< int16_t >( buffer[ d ], message[ d - 1 ] + m_discJump );
+
+        for ( int d = count - 2; d >= 0; --d )
+            message[ d ] = std::min< int16_t >( message[ d ], message[ d + 1 ] + m_discJump );
+
+    }
+
+    auto truncated = static_cast< int16_t >( minCost + m_discTerm );
+
+    #pragma omp simd
+    for ( int d = 0; d < count; ++d )
+        message[ d ] = static_cast< int16_t >( ( message[ d ] < truncated ? message[ d ] : truncated ) - minCost );
+
+}
+
+// Checkerboard update: pixels of one parity only read their own messages and write the ones of
+// the other parity, each neighbour slot has a single writer, so rows run in parallel
+void BPCPUDisparityProcessor::updateMessages( const int level, const int parity )
+{
+    auto &size = m_levelSizes[ level ];
+    auto width = size.width;
+    auto height = size.height;
+
+    auto count = m_labelsCount;
+
+    auto &costs = m_dataCosts[ level ];
+
+    auto up = m_messages[ FROM_UP ].data();
+    auto down = m_messages[ FROM_DOWN ].data();
+    auto left = m_messages[ FROM_LEFT ].data();
+    auto right = m_messages[ FROM_RIGHT ].data();
+
+    parallelFor( 0, height, [ & ]( const int y ) {
+        std::vector< int16_t > belief( count );
+        std::vector< int16_t > buffer( count );
+
+        for ( int x = ( y + parity ) & 1; x < width; x += 2 ) {
+            size_t offset = ( y * width + x ) * count;
+
+            auto data = costs.data() + offset;
+            auto fromUp = up + offset;
+            auto fromDown = down + offset;
+            auto fromLeft = left + offset;
+            auto fromRight = right + offset;
+
+            #pragma omp simd
+            for ( int d = 0; d < count; ++d )
+                belief[ d ] = static_cast< int16_t >( data[ d ] + fromUp[ d ] + fromDown[ d ] + fromLeft[ d ] + fromRight[ d ] );
+
+            if ( y > 0 )
+                sendMessage( belief.data(), fromUp, buffer.data(), down + offset - width * count );
+
+            if ( y < height - 1 )
+                sendMessage( belief.data(), fromDown, buffer.data(), up + offset + width * count );
+
+            if ( x > 0 )
+                sendMessage( belief.data(), fromLeft, buffer.data(), right + offset - count );
+
+            if ( x < width - 1 )
+                sendMessage( belief.data(), fromRight, buffer.data(), left + offset + count );
+
+        }
+
+    } );
+
+}
+
+cv::Mat BPCPUDisparityProcessor::computeDisparity() const
+{
+    auto &size = m_levelSizes.front();
+    auto count = m_labelsCount;
+
+    auto &costs = m_dataCosts.front();
+
+    cv::Mat ret( size, CV_16S );
+
+    auto factor = static_cast< float >( cv::StereoMatcher::DISP_SCALE / m_scale );
+
+    parallelFor( 0, size.height, [ & ]( const int y ) {
+        std::vector< int16_t > belief( count );
+
+        auto result = ret.ptr< short >( y );
+
+        for ( int x = 0; x < size.width; ++x ) {
+            size_t offset = ( y * size.width + x ) * count;
+
+            auto data = costs.data() + offset;
+            auto fromUp = m_messages[ FROM_UP ].data() + offset;
+            auto fromDown = m_messages[ FROM_DOWN ].data() + offset;
+            auto fromLeft = m_messages[ FROM_LEFT ].data() + offset;
+            auto fromRight = m_messages[ FROM_RIGHT ].data() + offset;
+
+            auto valid = std::min( count, x + 1 );
+
+            int16_t minCost = std::numeric_limits< int16_t >::max();
+
+            #pragma omp simd reduction( min : minCost )
+            for ( int d = 0; d < valid; ++d ) {
+                belief[ d ] = static_cast< int16_t >( data[ d ] + fromUp[ d ] + fromDown[ d ] + fromLeft[ d ] + fromRight[ d ] );
+                minCost = belief[ d ] < minCost ? belief[ d ] : minCost;
+            }
+
+            int bestDisparity = 0;
+
+            while ( belief[ bestDisparity ] != minCost )
+                ++bestDisparity;
+
+            float offsetValue = 0.f;
+
+            if ( bestDisparity > 0 && bestDisparity < valid - 1 ) {
+                int previousCost = belief[ bestDisparity - 1 ];
+                int nextCost = belief[ bestDisparity + 1 ];
+
+                auto denominator = previousCost + nextCost - 2 * minCost;
+
+                if ( denominator > 0 )
+                    offsetValue = static_cast< float >( previousCost - nextCost ) / ( 2 * denominator );
+
+            }
+
+            result[ x ] = static_cast< short >( cvRound( ( bestDisparity + offsetValue ) * factor ) );
+
+        }
+
+    } );
+
+    return ret;
+
+}
+
+cv::Mat BPCPUDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
+{
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
+
+    auto isScaled = std::abs( m_scale - 1. ) > DOUBLE_EPS;
+
+    if ( isScaled ) {
+        cv::resize( leftGray, m_leftScaled, cv::Size(), m_scale, m_scale, cv::INTER_AREA );
+        cv::resize( rightGray, m_rightScaled, cv::Size(), m_scale, m_scale, cv::INTER_AREA );
+
+        leftGray = m_leftScaled;
+        rightGray = m_rightScaled;
+
+    }
+
+    m_labelsCount = std::max( 1, cvRound( m_numDisparities * m_scale ) );
+
+    m_levelSizes.assign( 1, leftGray.size() );
+
+    while ( static_cast< int >( m_levelSizes.size() ) < m_numLevels && m_levelSizes.back().width > 1 && m_levelSizes.back().height > 1 ) {
+        auto &size = m_levelSizes.back();
+        m_levelSizes.push_back( cv::Size( ( size.width + 1 ) / 2, ( size.height + 1 ) / 2 ) );
+    }
+
+    auto levelsCount = static_cast< int >( m_levelSizes.size() );
+
+    // Fixed point scale, so the belief of the coarsest precise level fits 16 bits
+    auto maxDataCost = m_dataWeight * m_maxDataTerm * ( 1 << ( 2 * std::min( levelsCount - 1, MAX_PRECISE_LEVEL ) ) );
+    auto range = maxDataCost + DIRECTIONS_COUNT * m_maxDiscTerm;
+
+    m_costScale = range > DOUBLE_EPS ? static_cast< float >( MAX_BELIEF / range ) : 1.f;
+
+    m_discTerm = static_cast< int16_t >( std::min( cvRound( m_maxDiscTerm * m_costScale ), MAX_BELIEF / DIRECTIONS_COUNT ) );
+    m_discJump = static_cast< int16_t >( std::min( cvRound( m_discSingleJump * m_costScale ), MAX_BELIEF / DIRECTIONS_COUNT ) );
+    m_dataCap = static_cast< int16_t >( MAX_BELIEF - DIRECTIONS_COUNT * m_discTerm );
+
+    m_dataCosts.resize( levelsCount );
+
+    computeDataCosts( leftGray, rightGray );
+
+    for ( int level = 1; level < levelsCount; ++level )
+        downsampleDataCosts( level );
+
+    for ( int level = levelsCount - 1; level >= 0; --level ) {
+        initializeMessages( level );
+
+        for ( int i = 0; i < m_numIterations; ++i )
+            updateMessages( level, i & 1 );
+
+    }
+
+    auto ret = computeDisparity();
+
+    // Nearest neighbour, interpolation would blend foreground and background disparities along depth edges
+    if ( isScaled )
+        cv::resize( ret, ret, left.size(), 0, 0, cv::INTER_NEAREST );
+
+    return ret;
+
+}
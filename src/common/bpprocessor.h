@@ -0,0 +1,89 @@
+#pragma once
+
+#include "stereoprocessor.h"
+
+#include <cstdint>
+#include <vector>
+
+// Hierarchical belief propagation on the CPU, same parameters as cv::cuda::StereoBeliefPropagation
+class BPCPUDisparityProcessor : public DisparityProcessorBase
+{
+public:
+    BPCPUDisparityProcessor();
+
+    int getNumDisparities() const;
+    void setNumDisparities( const int value );
+
+    int getNumIterations() const;
+    void setNumIterations( const int value );
+
+    int getNumLevels() const;
+    void setNumLevels( const int value );
+
+    double getMaxDataTerm() const;
+    void setMaxDataTerm( const double value );
+
+    double getDataWeight() const;
+    void setDataWeight( const double value );
+
+    double getMaxDiscTerm() const;
+    void setMaxDiscTerm( const double value );
+
+    double getDiscSingleJump() const;
+    void setDiscSingleJump( const double value );
+
+    // Matching resolution relative to the input images
+    double getScale() const;
+    void setScale( const double value );
+
+    virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
+
+    virtual cv::Range disparityRange() const override;
+
+    virtual std::vector< double > parameters() const override;
+
+protected:
+    enum Direction { FROM_UP, FROM_DOWN, FROM_LEFT, FROM_RIGHT, DIRECTIONS_COUNT };
+
+    int m_numDisparities;
+    int m_numIterations;
+    int m_numLevels;
+
+    double m_maxDataTerm;
+    double m_dataWeight;
+    double m_maxDiscTerm;
+    double m_discSingleJump;
+
+    double m_scale;
+
+    // Fixed point costs of the current frame
+    int m_labelsCount;
+    float m_costScale;
+    int16_t m_dataCap;
+    int16_t m_discTerm;
+    int16_t m_discJump;
+
+    // Scaled input, kept between frames
+    cv::Mat m_leftScaled;
+    cv::Mat m_rightScaled;
+
+    // Disparity-major costs per pixel, kept between frames. Messages are indexed by the neighbour they came from
+    std::vector< cv::Size > m_levelSizes;
+    std::vector< std::vector< int16_t > > m_dataCosts;
+    std::vector< int16_t > m_messages[ DIRECTIONS_COUNT ];
+    std::vector< int16_t > m_coarseMessages[ DIRECTIONS_COUNT ];
+
+    void computeDataCosts( const cv::Mat &left, const cv::Mat &right );
+    void downsampleDataCosts( const int level );
+
+    void initializeMessages( const int level );
+    void updateMessages( const int level, const int parity );
+
+    void sendMessage( const int16_t *belief, const int16_t *received, int16_t *buffer, int16_t *message ) const;
+
+    cv::Mat computeDisparity() const;
+
+private:
+    void initialize();
+
+};
@@ -0,0 +1,420 @@
+#include "precompiled.h"
+
+#include "censusprocessor.h"
+
+#include "taskscheduler.h"
+
+#include <limits>
+
+static const int MAX_BLOCK_SIZE = 31;
+static const int MIN_BAND_HEIGHT = 32;
+
+static inline int hammingDistance( const uint64_t first, const uint64_t second )
+{
+    return __builtin_popcountll( first ^ second );
+}
+
+// CensusDisparityProcessor
+CensusDisparityProcessor::CensusDisparityProcessor()
+    : DisparityProcessorBase()
+{
+    initialize();
+}
+
+void CensusDisparityProcessor::initialize()
+{
+    m_window = WINDOW_9X7;
+
+    m_minDisparity = 0;
+    m_numDisparities = 128;
+    m_blockSize = 9;
+    m_uniquenessRatio = 10;
+    m_disp12MaxDiff = 1;
+    m_speckleWindowSize = 50;
+    m_speckleRange = 2;
+
+    // Census only depends on the intensity order, gray conversion is enough
+    m_preprocessor.setEqualizationEnabled( false );
+    m_preprocessor.setBlurSize( 1 );
+}
+
+CensusDisparityProcessor::Window CensusDisparityProcessor::getWindow() const
+{
+    return m_window;
+}
+
+void CensusDisparityProcessor::setWindow( const Window window )
+{
+    m_window = window;
+}
+
+int CensusDisparityProcessor::getMinDisparity() const
+{
+    return m_minDisparity;
+}
+
+void CensusDisparityProcessor::setMinDisparity( const int minDisparity )
+{
+    m_minDisparity = minDisparity;
+}
+
+int CensusDisparityProcessor::getNumDisparities() const
+{
+    return m_numDisparities;
+}
+
+void CensusDisparityProcessor::setNumDisparities( const int numDisparities )
+{
+    m_numDisparities = std::max( 1, numDisparities );
+}
+
+int CensusDisparityProcessor::getBlockSize() const
+{
+    return m_blockSize;
+}
+
+void CensusDisparityProcessor::setBlockSize( const int blockSize )
+{
+    // Odd and small enough for 16 bit aggregated costs
+    m_blockSize = std::min( MAX_BLOCK_SIZE, std::max( 1, blockSize ) ) | 1;
+}
+
+int CensusDisparityProcessor::getUniquenessRatio() const
+{
+    return m_uniquenessRatio;
+}
+
+void CensusDisparityProcessor::setUniquenessRatio( const int uniquenessRatio )
+{
+    m_uniquenessRatio = std::min( 99, std::max( 0, uniquenessRatio ) );
+}
+
+int CensusDisparityProcessor::getDisp12MaxDiff() const
+{
+    return m_disp12MaxDiff;
+}
+
+void CensusDisparityProcessor::setDisp12MaxDiff( const int disp12MaxDiff )
+{
+    m_disp12MaxDiff = disp12MaxDiff;
+}
+
+int CensusDisparityProcessor::getSpeckleWindowSize() const
+{
+    return m_speckleWindowSize;
+}
+
+void CensusDisparityProcessor::setSpeckleWindowSize( const int speckleWindowSize )
+{
+    m_speckleWindowSize = speckleWindowSize;
+}
+
+int CensusDisparityProcessor::getSpeckleRange() const
+{
+    return m_speckleRange;
+}
+
+void CensusDisparityProcessor::setSpeckleRange( const int speckleRange )
+{
+    m_speckleRange = speckleRange;
+}
+
+cv::Size CensusDisparityProcessor::windowSize() const
+{
+    switch ( m_window ) {
+    case WINDOW_5X5:
+        return cv::Size( 5, 5 );
+    case WINDOW_7X7:
+        return cv::Size( 7, 7 );
+    default:
+        return cv::Size( 9, 7 );
+    }
+
+}
+
+void CensusDisparityProcessor::censusTransform( const cv::Mat &image, std::vector< uint64_t > *codes ) const
+{
+    auto size = windowSize();
+
+    auto radiusX = size.width / 2;
+    auto radiusY = size.height / 2;
+
+    cv::Mat padded;
+    cv::copyMakeBorder( image, padded, radiusY, radiusY, radiusX, radiusX, cv::BORDER_REPLICATE );
+
+    codes->resize( image.total() );
+
+    auto data = codes->data();
+    auto width = image.cols;
+
+    parallelFor( 0, image.rows, [ & ]( const int y ) {
+        auto code = data + y * width;
+        auto center = padded.ptr< uchar >( y + radiusY ) + radiusX;
+
+        std::fill( code, code + width, 0 );
+
+        // Offset by offset over the whole row, so the inner loop vectorizes
+        for ( int dy = -radiusY; dy <= radiusY; ++dy ) {
+            auto row = padded.ptr< uchar >( y + radiusY + dy ) + radiusX;
+
+            for ( int dx = -radiusX; dx <= radiusX; ++dx ) {
+
+                if ( dx == 0 && dy == 0 )
+                    continue;
+
+                auto neighbour = row + dx;
+
+                #pragma omp simd
+                for ( int x = 0; x < width; ++x )
+                    code[ x ] = ( code[ x ] << 1 ) | static_cast< uint64_t >( neighbour[ x ] < center[ x ] );
+
+            }
+
+        }
+
+    } );
+
+}
+
+// Costs are kept per row in disparity-major order: column sums move down the band,
+// block sums run along the row, both as plain 16 bit loops over disparities
+void CensusDisparityProcessor::matchRows( const std::vector< uint64_t > &leftCodes, const std::vector< uint64_t > &rightCodes,
+                                          const int beginRow, const int endRow, cv::Mat *disparity ) const
+{
+    auto width = disparity->cols;
+    auto height = disparity->rows;
+
+    auto count = m_numDisparities;
+    auto radius = m_blockSize / 2;
+
+    auto size = windowSize();
+    const uint16_t maxCost = size.area() - 1;
+
+    const short invalidValue = ( m_minDisparity - 1 ) * cv::StereoMatcher::DISP_SCALE;
+
+    std::vector< uint16_t > columnSums( width * count, 0 );
+    std::vector< uint16_t > blockSums( width * count );
+
+    std::vector< uint16_t > rightCosts( width );
+    std::vector< int > rightDisparities( width );
+
+    std::vector< int > leftDisparities( width );
+    std::vector< float > leftValues( width );
+
+    // Disparities that point outside of the right image
+    auto firstDisparity = [ & ]( const int x ) { return std::max( 0, x - m_minDisparity - ( width - 1 ) ); };
+    auto lastDisparity = [ & ]( const int x ) { return std::min( count, x - m_minDisparity + 1 ); };
+
+    auto clampRow = [ height ]( const int y ) { return std::min( std::max( y, 0 ), height - 1 ); };
+
+    auto addRow = [ & ]( const int y ) {
+        auto row = clampRow( y );
+
+        auto left = leftCodes.data() + row * width;
+        auto right = rightCodes.data() + row * width - m_minDisparity;
+
+        for ( int x = 0; x < width; ++x ) {
+            auto sums = columnSums.data() + x * count;
+
+            auto begin = firstDisparity( x );
+            auto end = lastDisparity( x );
+
+            for ( int d = 0; d < count; ++d )
+                sums[ d ] += d >= begin && d < end ? hammingDistance( left[ x ], right[ x - d ] ) : maxCost;
+
+        }
+
+    };
+
+    // Out of range disparities have the same cost in both rows and cancel out
+    auto replaceRow = [ & ]( const int removedY, const int addedY ) {
+        auto removedRow = clampRow( removedY );
+        auto addedRow = clampRow( addedY );
+
+        if ( removedRow == addedRow )
+            return;
+
+        auto removedLeft = leftCodes.data() + removedRow * width;
+        auto removedRight = rightCodes.data() + removedRow * width - m_minDisparity;
+        auto addedLeft = leftCodes.data() + addedRow * width;
+        auto addedRight = rightCodes.data() + addedRow * width - m_minDisparity;
+
+        for ( int x = 0; x < width; ++x ) {
+            auto sums = columnSums.data() + x * count;
+
+            auto end = lastDisparity( x );
+
+            for ( int d = firstDisparity( x ); d < end; ++d )
+                sums[ d ] += hammingDistance( addedLeft[ x ], addedRight[ x - d ] ) - hammingDistance( removedLeft[ x ], removedRight[ x - d ] );
+
+        }
+
+    };
+
+    for ( int y = beginRow - radius; y <= beginRow + radius; ++y )
+        addRow( y );
+
+    for ( int y = beginRow; y < endRow; ++y ) {
+
+        if ( y > beginRow )
+            replaceRow( y - radius - 1, y + radius );
+
+        // Block sums, running along the row with replicated border columns
+        {
+            auto first = blockSums.data();
+
+            std::fill( first, first + count, 0 );
+
+            for ( int k = -radius; k <= radius; ++k ) {
+                auto column = columnSums.data() + std::min( std::max( k, 0 ), width - 1 ) * count;
+
+                #pragma omp simd
+                for ( int d = 0; d < count; ++d )
+                    first[ d ] += column[ d ];
+
+            }
+
+            for ( int x = 1; x < width; ++x ) {
+                auto previous = blockSums.data() + ( x - 1 ) * count;
+                auto current = blockSums.data() + x * count;
+                auto added = columnSums.data() + std::min( x + radius, width - 1 ) * count;
+                auto removed = columnSums.data() + std::max( x - radius - 1, 0 ) * count;
+
+                #pragma omp simd
+                for ( int d = 0; d < count; ++d )
+                    current[ d ] = previous[ d ] + added[ d ] - removed[ d ];
+
+            }
+
+        }
+
+        std::fill( rightCosts.begin(), rightCosts.end(), std::numeric_limits< uint16_t >::max() );
+        std::fill( rightDisparities.begin(), rightDisparities.end(), -1 );
+
+        for ( int x = 0; x < width; ++x ) {
+            auto costs = blockSums.data() + x * count;
+
+            auto begin = firstDisparity( x );
+            auto end = lastDisparity( x );
+
+            leftDisparities[ x ] = -1;
+
+            if ( begin >= end )
+                continue;
+
+            uint16_t minCost = std::numeric_limits< uint16_t >::max();
+
+            #pragma omp simd reduction( min : minCost )
+            for ( int d = begin; d < end; ++d )
+                minCost = costs[ d ] < minCost ? costs[ d ] : minCost;
+
+            int bestDisparity = begin;
+
+            while ( costs[ bestDisparity ] != minCost )
+                ++bestDisparity;
+
+            // Best match for each right image pixel, for the left-right check
+            for ( int d = begin; d < end; ++d ) {
+                auto rightX = x - m_minDisparity - d;
+
+                if ( costs[ d ] < rightCosts[ rightX ] ) {
+                    rightCosts[ rightX ] = costs[ d ];
+                    rightDisparities[ rightX ] = d;
+                }
+
+            }
+
+            if ( m_uniquenessRatio > 0 ) {
+                int ambiguousCount = 0;
+
+                #pragma omp simd reduction( + : ambiguousCount )
+                for ( int d = begin; d < end; ++d )
+                    ambiguousCount += std::abs( d - bestDisparity ) > 1 && costs[ d ] * ( 100 - m_uniquenessRatio ) < minCost * 100;
+
+                if ( ambiguousCount > 0 )
+                    continue;
+
+            }
+
+            float offset = 0.f;
+
+            if ( bestDisparity > begin && bestDisparity < end - 1 ) {
+                int previousCost = costs[ bestDisparity - 1 ];
+                int nextCost = costs[ bestDisparity + 1 ];
+
+                auto denominator = previousCost + nextCost - 2 * minCost;
+
+                if ( denominator > 0 )
+                    offset = static_cast< float >( previousCost - nextCost ) / ( 2 * denominator );
+
+            }
+
+            leftDisparities[ x ] = bestDisparity;
+            leftValues[ x ] = m_minDisparity + bestDisparity + offset;
+
+        }
+
+        auto result = disparity->ptr< short >( y );
+
+        for ( int x = 0; x < width; ++x ) {
+            auto value = leftDisparities[ x ];
+
+            result[ x ] = invalidValue;
+
+            if ( value < 0 )
+                continue;
+
+            if ( m_disp12MaxDiff >= 0 && std::abs( rightDisparities[ x - m_minDisparity - value ] - value ) > m_disp12MaxDiff )
+                continue;
+
+            result[ x ] = static_cast< short >( cvRound( leftValues[ x ] * cv::StereoMatcher::DISP_SCALE ) );
+
+        }
+
+    }
+
+}
+
+cv::Range CensusDisparityProcessor::disparityRange() const
+{
+    return cv::Range( m_minDisparity, m_minDisparity + m_numDisparities );
+}
+
+int CensusDisparityProcessor::supportRadius() const
+{
+    return DisparityProcessorBase::supportRadius() + m_blockSize / 2 + windowSize().width / 2;
+}
+
+std::vector< double > CensusDisparityProcessor::parameters() const
+{
+    return { double( m_window ), double( m_minDisparity ), double( m_numDisparities ), double( m_blockSize ),
+             double( m_uniquenessRatio ), double( m_disp12MaxDiff ), double( m_speckleWindowSize ), double( m_speckleRange ) };
+}
+
+cv::Mat CensusDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
+{
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
+
+    censusTransform( leftGray, &m_leftCodes );
+    censusTransform( rightGray, &m_rightCodes );
+
+    cv::Mat ret( leftGray.size(), CV_16S );
+
+    auto height = ret.rows;
+
+    auto bandsCount = std::max( 1, std::min( height / MIN_BAND_HEIGHT, static_cast< int >( TaskScheduler::instance().threadsCount() ) ) );
+
+    parallelFor( 0, bandsCount, [ & ]( const int band ) {
+        matchRows( m_leftCodes, m_rightCodes, height * band / bandsCount, height * ( band + 1 ) / bandsCount, &ret );
+    } );
+
+    if ( m_speckleWindowSize > 0 )
+        cv::filterSpeckles( ret, ( m_minDisparity - 1 ) * cv::StereoMatcher::DISP_SCALE, m_speckleWindowSize,
+                            m_speckleRange * cv::StereoMatcher::DISP_SCALE );
+
+    return ret;
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "stereoprocessor.h"
+
+#include <cstdint>
+#include <vector>
+
+class CensusDisparityProcessor : public DisparityProcessorBase
+{
+public:
+    enum Window { WINDOW_5X5, WINDOW_7X7, WINDOW_9X7 };
+
+    CensusDisparityProcessor();
+
+    Window getWindow() const;
+    void setWindow( const Window window );
+
+    int getMinDisparity() const;
+    void setMinDisparity( const int minDisparity );
+
+    int getNumDisparities() const;
+    void setNumDisparities( const int numDisparities );
+
+    int getBlockSize() const;
+    void setBlockSize( const int blockSize );
+
+    int getUniquenessRatio() const;
+    void setUniquenessRatio( const int uniquenessRatio );
+
+    int getDisp12MaxDiff() const;
+    void setDisp12MaxDiff( const int disp12MaxDiff );
+
+    int getSpeckleWindowSize() const;
+    void setSpeckleWindowSize( const int speckleWindowSize );
+
+    int getSpeckleRange() const;
+    void setSpeckleRange( const int speckleRange );
+
+    virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
+
+    virtual cv::Range disparityRange() const override;
+    virtual int supportRadius() const override;
+    virtual std::vector< double > parameters() const override;
+
+protected:
+    Window m_window;
+
+    int m_minDisparity;
+    int m_numDisparities;
+    int m_blockSize;
+    int m_uniquenessRatio;
+    int m_disp12MaxDiff;
+    int m_speckleWindowSize;
+    int m_speckleRange;
+
+    // Codes of the current frame, kept between frames
+    std::vector< uint64_t > m_leftCodes;
+    std::vector< uint64_t > m_rightCodes;
+
+    cv::Size windowSize() const;
+
+    void censusTransform( const cv::Mat &image, std::vector< uint64_t > *codes ) const;
+
+    void matchRows( const std::vector< uint64_t > &leftCodes, const std::vector< uint64_t > &rightCodes,
+                    const int beginRow, const int endRow, cv::Mat *disparity ) const;
+
+private:
+    void initialize();
+
+};
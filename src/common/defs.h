@@ -14,3 +14,4 @@ static const auto FLOAT_MIN = std::numeric_limits< float >::min();
 static const int MIN_PNP_POINTS_COUNT = 6;
 static const int MIN_FMAT_POINTS_COUNT = 6;
 
+static const int DRAW_GRAIN_SIZE = 256;
@@ -0,0 +1,135 @@
+#include "precompiled.h"
+
+#include "disparitycolorizer.h"
+
+#include "taskscheduler.h"
+
+#include <limits>
+
+static const int TABLE_OFFSET = -std::numeric_limits< short >::min();
+static const int TABLE_SIZE = TABLE_OFFSET + std::numeric_limits< short >::max() + 1;
+
+// DisparityColorizer
+DisparityColorizer::DisparityColorizer()
+{
+    initialize();
+}
+
+void DisparityColorizer::initialize()
+{
+    m_tableLow = 1;
+    m_tableHigh = 0;
+
+    cv::Mat levels( 1, 256, CV_8U );
+
+    for ( int i = 0; i < levels.cols; ++i )
+        levels.at< uchar >( i ) = i;
+
+    cv::Mat colors;
+    cv::applyColorMap( levels, colors, cv::COLORMAP_JET );
+
+    for ( int i = 0; i < colors.cols; ++i )
+        m_colors[ i ] = colors.at< cv::Vec3b >( i );
+
+}
+
+const cv::Range &DisparityColorizer::range() const
+{
+    return m_range;
+}
+
+void DisparityColorizer::setRange( const cv::Range &value )
+{
+    m_range = value;
+}
+
+void DisparityColorizer::updateTable( const int low, const int high )
+{
+    if ( low == m_tableLow && high == m_tableHigh )
+        return;
+
+    m_tableLow = low;
+    m_tableHigh = high;
+
+    m_table.resize( TABLE_SIZE );
+
+    auto multiplier = high > low ? 255. / ( high - low ) : 0.;
+
+    for ( int i = 0; i < TABLE_SIZE; ++i ) {
+        auto value = i - TABLE_OFFSET;
+
+        if ( value < low )
+            m_table[ i ] = cv::Vec3b( 0, 0, 0 );
+        else
+            m_table[ i ] = m_colors[ std::min( 255, cvRound( ( value - low ) * multiplier ) ) ];
+
+    }
+
+}
+
+CvImage DisparityColorizer::buffer( const cv::Size &size )
+{
+    for ( auto &i : m_buffers )
+        if ( !i.u || i.u->refcount == 1 ) {
+            i.create( size, CV_8UC3 );
+            return i;
+        }
+
+    // Every image is still in use
+    return CvImage( size, CV_8UC3 );
+
+}
+
+CvImage DisparityColorizer::process( const cv::Mat &disparity )
+{
+    if ( disparity.empty() )
+        return CvImage();
+
+    auto ret = buffer( disparity.size() );
+
+    auto width = disparity.cols;
+
+    if ( disparity.type() == CV_16S ) {
+
+        if ( m_range.empty() ) {
+            double min, max;
+            cv::minMaxIdx( disparity, &min, &max );
+
+            updateTable( cvRound( min ), cvRound( max ) );
+
+        }
+        else
+            updateTable( m_range.start * cv::StereoMatcher::DISP_SCALE, ( m_range.end - 1 ) * cv::StereoMatcher::DISP_SCALE );
+
+        parallelFor( 0, disparity.rows, [ & ]( const int y ) {
+            auto row = disparity.ptr< short >( y );
+            auto result = ret.ptr< cv::Vec3b >( y );
+
+            for ( int x = 0; x < width; ++x )
+                result[ x ] = m_table[ row[ x ] + TABLE_OFFSET ];
+
+        }, TaskScheduler::VISUALIZATION );
+
+    }
+    else {
+        double min, max;
+        cv::minMaxIdx( disparity, &min, &max );
+
+        auto multiplier = max > min ? 255. / ( max - min ) : 0.;
+
+        disparity.convertTo( m_converted, CV_8U, multiplier, -min * multiplier );
+
+        parallelFor( 0, disparity.rows, [ & ]( const int y ) {
+            auto row = m_converted.ptr< uchar >( y );
+            auto result = ret.ptr< cv::Vec3b >( y );
+
+            for ( int x = 0; x < width; ++x )
+                result[ x ] = m_colors[ row[ x ] ];
+
+        }, TaskScheduler::VISUALIZATION );
+
+    }
+
+    return ret;
+
+}
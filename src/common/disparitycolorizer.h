@@ -0,0 +1,46 @@
+#pragma once
+
+#include "image.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <array>
+#include <vector>
+
+// Jet colored disparity for display. CV_16S fixed point disparity goes through a table of all
+// 16 bit values, other types are scaled to 8 bit by their own minimum and maximum
+class DisparityColorizer
+{
+public:
+    DisparityColorizer();
+
+    // Colored disparity range in pixels, smaller values are invalid and black. An empty range is
+    // taken from each frame
+    const cv::Range &range() const;
+    void setRange( const cv::Range &value );
+
+    CvImage process( const cv::Mat &disparity );
+
+protected:
+    static const int BUFFERS_COUNT = 3;
+
+    cv::Range m_range;
+
+    std::array< cv::Vec3b, 256 > m_colors;
+
+    // Colors by fixed point value, offset by the 16 bit minimum, for the fixed point range they were built for
+    std::vector< cv::Vec3b > m_table;
+    int m_tableLow;
+    int m_tableHigh;
+
+    // Results still held by a viewer keep their image, the others are written again
+    std::array< CvImage, BUFFERS_COUNT > m_buffers;
+    cv::Mat m_converted;
+
+    void updateTable( const int low, const int high );
+    CvImage buffer( const cv::Size &size );
+
+private:
+    void initialize();
+
+};
@@ -0,0 +1,392 @@
+#include "precompiled.h"
+
+#include "disparityevaluation.h"
+
+#include "defs.h"
+
+#include <QDir>
+
+#include <fstream>
+
+static const int DEFAULT_MAX_DISPARITY = 256;
+
+static const double KITTI_DISPARITY_SCALE = 1. / 256.;
+static const double KITTI_D1_ABSOLUTE = 3.;
+static const double KITTI_D1_RELATIVE = 0.05;
+
+static int middleburyDisparitiesCount( const QString &fileName )
+{
+    std::ifstream stream( fileName.toStdString() );
+
+    std::string line;
+
+    while ( std::getline( stream, line ) ) {
+        auto parts = QString::fromStdString( line ).trimmed().split( "=" );
+
+        if ( parts.size() == 2 && parts[ 0 ].trimmed() == "ndisp" )
+            return parts[ 1 ].trimmed().toInt();
+
+    }
+
+    return 0;
+
+}
+
+static QString firstExisting( const QDir &dir, const QStringList &names )
+{
+    for ( auto &i : names )
+        if ( dir.exists( i ) )
+            return dir.filePath( i );
+
+    return QString();
+}
+
+// StereoDataset
+StereoDataset::StereoDataset()
+{
+    initialize();
+}
+
+void StereoDataset::initialize()
+{
+    m_format = Format::UNKNOWN;
+    m_scale = 1.;
+}
+
+bool StereoDataset::load( const std::string &path )
+{
+    m_entries.clear();
+    m_format = Format::UNKNOWN;
+
+    if ( loadKitti( path ) )
+        m_format = Format::KITTI;
+    else if ( loadSynthetic( path ) )
+        m_format = Format::SYNTHETIC;
+    else if ( loadMiddlebury( path ) )
+        m_format = Format::MIDDLEBURY;
+
+    return !m_entries.empty();
+
+}
+
+bool StereoDataset::loadMiddlebury( const std::string &path )
+{
+    QDir root( QString::fromStdString( path ) );
+
+    // Either a single scene folder or a folder of scenes
+    QStringList scenes;
+
+    if ( root.exists( "im0.png" ) )
+        scenes << root.absolutePath();
+    else
+        for ( auto &i : root.entryInfoList( QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name ) )
+            scenes << i.absoluteFilePath();
+
+    for ( auto &i : scenes ) {
+        QDir dir( i );
+
+        auto groundTruth = firstExisting( dir, QStringList() << "disp0GT.pfm" << "disp0.pfm" );
+
+        if ( !dir.exists( "im0.png" ) || !dir.exists( "im1.png" ) || groundTruth.isEmpty() )
+            continue;
+
+        Entry entry;
+        entry.name = dir.dirName().toStdString();
+        entry.leftFileName = dir.filePath( "im0.png" ).toStdString();
+        entry.rightFileName = dir.filePath( "im1.png" ).toStdString();
+        entry.groundTruthFileName = groundTruth.toStdString();
+        entry.maxDisparity = middleburyDisparitiesCount( dir.filePath( "calib.txt" ) );
+
+        m_entries.push_back( entry );
+
+    }
+
+    return !m_entries.empty();
+
+}
+
+bool StereoDataset::loadKitti( const std::string &path )
+{
+    QDir dir( QString::fromStdString( path ) );
+
+    auto left = firstExisting( dir, QStringList() << "image_2" << "colored_0" << "image_0" );
+    auto right = firstExisting( dir, QStringList() << "image_3" << "colored_1" << "image_1" );
+    auto groundTruth = firstExisting( dir, QStringList() << "disp_occ_0" << "disp_occ" << "disp_noc_0" << "disp_noc" );
+
+    if ( left.isEmpty() || right.isEmpty() || groundTruth.isEmpty() )
+        return false;
+
+    QDir leftDir( left );
+    QDir rightDir( right );
+    QDir groundTruthDir( groundTruth );
+
+    // Ground truth exists for the first frame of each pair only
+    for ( auto &i : leftDir.entryInfoList( QStringList() << "*_10.png", QDir::Files, QDir::Name ) ) {
+
+        if ( !rightDir.exists( i.fileName() ) || !groundTruthDir.exists( i.fileName() ) )
+            continue;
+
+        Entry entry;
+        entry.name = i.completeBaseName().toStdString();
+        entry.leftFileName = i.absoluteFilePath().toStdString();
+        entry.rightFileName = rightDir.filePath( i.fileName() ).toStdString();
+        entry.groundTruthFileName = groundTruthDir.filePath( i.fileName() ).toStdString();
+        entry.maxDisparity = DEFAULT_MAX_DISPARITY;
+
+        m_entries.push_back( entry );
+
+    }
+
+    return !m_entries.empty();
+
+}
+
+bool StereoDataset::loadSynthetic( const std::string &path )
+{
+    QDir dir( QString::fromStdString( path ) );
+
+    if ( !dir.exists( "left" ) || !dir.exists( "right" ) || !dir.exists( "disparity" ) )
+        return false;
+
+    QDir leftDir( dir.filePath( "left" ) );
+    QDir rightDir( dir.filePath( "right" ) );
+    QDir groundTruthDir( dir.filePath( "disparity" ) );
+
+    for ( auto &i : leftDir.entryInfoList( QStringList() << "*.png", QDir::Files, QDir::Name ) ) {
+        auto groundTruthName = i.completeBaseName() + ".pfm";
+
+        if ( !rightDir.exists( i.fileName() ) || !groundTruthDir.exists( groundTruthName ) )
+            continue;
+
+        Entry entry;
+        entry.name = i.completeBaseName().toStdString();
+        entry.leftFileName = i.absoluteFilePath().toStdString();
+        entry.rightFileName = rightDir.filePath( i.fileName() ).toStdString();
+        entry.groundTruthFileName = groundTruthDir.filePath( groundTruthName ).toStdString();
+
+        // Taken from the ground truth on load
+        entry.maxDisparity = 0;
+
+        m_entries.push_back( entry );
+
+    }
+
+    return !m_entries.empty();
+
+}
+
+StereoDataset::Format StereoDataset::format() const
+{
+    return m_format;
+}
+
+void StereoDataset::setScale( const double value )
+{
+    m_scale = value;
+}
+
+double StereoDataset::scale() const
+{
+    return m_scale;
+}
+
+size_t StereoDataset::size() const
+{
+    return m_entries.size();
+}
+
+bool StereoDataset::empty() const
+{
+    return m_entries.empty();
+}
+
+cv::Mat StereoDataset::loadGroundTruth( const std::string &fileName, const Format format )
+{
+    auto source = cv::imread( fileName, cv::IMREAD_UNCHANGED );
+
+    if ( source.empty() )
+        return cv::Mat();
+
+    cv::Mat ret;
+
+    if ( format == Format::KITTI && source.depth() == CV_16U )
+        source.convertTo( ret, CV_32F, KITTI_DISPARITY_SCALE );
+    else
+        source.convertTo( ret, CV_32F );
+
+    if ( ret.channels() > 1 )
+        cv::extractChannel( ret, ret, 0 );
+
+    // Middlebury marks unknown pixels with infinity, all formats use zero from here
+    for ( int i = 0; i < ret.rows; ++i ) {
+        auto row = ret.ptr< float >( i );
+
+        for ( int j = 0; j < ret.cols; ++j )
+            if ( !std::isfinite( row[ j ] ) || row[ j ] < 0.f )
+                row[ j ] = 0.f;
+
+    }
+
+    return ret;
+
+}
+
+StereoSample StereoDataset::sample( const size_t index ) const
+{
+    auto &entry = m_entries.at( index );
+
+    StereoSample ret;
+    ret.name = entry.name;
+    ret.leftImage = CvImage( entry.leftFileName );
+    ret.rightImage = CvImage( entry.rightFileName );
+    ret.groundTruth = loadGroundTruth( entry.groundTruthFileName, m_format );
+    ret.maxDisparity = entry.maxDisparity;
+
+    if ( ret.leftImage.empty() || ret.rightImage.empty() || ret.groundTruth.empty() )
+        return StereoSample();
+
+    if ( ret.maxDisparity <= 0 ) {
+        double maxValue;
+        cv::minMaxLoc( ret.groundTruth, nullptr, &maxValue );
+
+        ret.maxDisparity = static_cast< int >( std::ceil( maxValue ) ) + 1;
+
+    }
+
+    if ( std::abs( m_scale - 1. ) > DOUBLE_EPS ) {
+        cv::resize( ret.leftImage, ret.leftImage, cv::Size(), m_scale, m_scale, cv::INTER_AREA );
+        cv::resize( ret.rightImage, ret.rightImage, cv::Size(), m_scale, m_scale, cv::INTER_AREA );
+
+        // Nearest keeps unknown pixels from blending into known ones
+        cv::resize( ret.groundTruth, ret.groundTruth, ret.leftImage.size(), 0., 0., cv::INTER_NEAREST );
+        ret.groundTruth *= m_scale;
+
+        ret.maxDisparity = static_cast< int >( std::ceil( ret.maxDisparity * m_scale ) );
+
+    }
+
+    return ret;
+
+}
+
+cv::Mat disparityToFloat( const cv::Mat &disparity )
+{
+    cv::Mat ret;
+
+    if ( disparity.type() == CV_16S )
+        disparity.convertTo( ret, CV_32F, 1. / cv::StereoMatcher::DISP_SCALE );
+    else
+        disparity.convertTo( ret, CV_32F );
+
+    return ret;
+
+}
+
+DisparityMetrics evaluateDisparity( const cv::Mat &disparity, const cv::Mat &groundTruth )
+{
+    DisparityMetrics ret = {};
+
+    auto values = disparityToFloat( disparity );
+
+    if ( values.size() != groundTruth.size() || groundTruth.type() != CV_32F )
+        return ret;
+
+    size_t totalCount = 0;
+    size_t estimatedCount = 0;
+
+    size_t bad05Count = 0, bad1Count = 0, bad2Count = 0, bad4Count = 0, d1Count = 0;
+
+    double errorSum = 0.;
+    double squaredErrorSum = 0.;
+
+    for ( int i = 0; i < groundTruth.rows; ++i ) {
+        auto valueRow = values.ptr< float >( i );
+        auto groundTruthRow = groundTruth.ptr< float >( i );
+
+        for ( int j = 0; j < groundTruth.cols; ++j ) {
+            auto expected = groundTruthRow[ j ];
+
+            if ( !( expected > 0.f ) )
+                continue;
+
+            ++totalCount;
+
+            auto value = valueRow[ j ];
+
+            // Matchers mark rejected pixels with zero or negative values
+            if ( !( value > 0.f ) || !std::isfinite( value ) )
+                continue;
+
+            ++estimatedCount;
+
+            double error = std::abs( value - expected );
+
+            errorSum += error;
+            squaredErrorSum += error * error;
+
+            bad05Count += error > 0.5;
+            bad1Count += error > 1.;
+            bad2Count += error > 2.;
+            bad4Count += error > 4.;
+            d1Count += error > KITTI_D1_ABSOLUTE && error > KITTI_D1_RELATIVE * expected;
+
+        }
+
+    }
+
+    if ( totalCount == 0 )
+        return ret;
+
+    auto missingCount = totalCount - estimatedCount;
+
+    auto percent = [ totalCount ]( const size_t count ) { return 100. * count / totalCount; };
+
+    ret.bad05 = percent( bad05Count + missingCount );
+    ret.bad1 = percent( bad1Count + missingCount );
+    ret.bad2 = percent( bad2Count + missingCount );
+    ret.bad4 = percent( bad4Count + missingCount );
+    ret.d1 = percent( d1Count + missingCount );
+
+    ret.density = percent( estimatedCount );
+
+    if ( estimatedCount > 0 ) {
+        ret.averageError = errorSum / estimatedCount;
+        ret.rmsError = std::sqrt( squaredErrorSum / estimatedCount );
+    }
+
+    return ret;
+
+}
+
+double disparityConsistency( const cv::Mat &leftDisparity, const cv::Mat &rightDisparity, const double threshold )
+{
+    auto leftValues = disparityToFloat( leftDisparity );
+    auto rightValues = disparityToFloat( rightDisparity );
+
+    if ( leftValues.empty() || leftValues.size() != rightValues.size() )
+        return 0.;
+
+    size_t consistentCount = 0;
+
+    for ( int i = 0; i < leftValues.rows; ++i ) {
+        auto leftRow = leftValues.ptr< float >( i );
+        auto rightRow = rightValues.ptr< float >( i );
+
+        for ( int j = 0; j < leftValues.cols; ++j ) {
+            auto value = leftRow[ j ];
+
+            if ( !( value > 0.f ) )
+                continue;
+
+            auto x = cvRound( j - value );
+
+            if ( x >= 0 && rightRow[ x ] > 0.f && std::abs( rightRow[ x ] - value ) <= threshold )
+                ++consistentCount;
+
+        }
+
+    }
+
+    return 100. * consistentCount / leftValues.total();
+
+}
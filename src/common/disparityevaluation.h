@@ -0,0 +1,91 @@
+#pragma once
+
+#include "image.h"
+
+#include <string>
+#include <vector>
+
+struct StereoSample
+{
+    std::string name;
+
+    CvImage leftImage;
+    CvImage rightImage;
+
+    // CV_32F, zero where the ground truth is unknown
+    cv::Mat groundTruth;
+
+    int maxDisparity;
+};
+
+class StereoDataset
+{
+public:
+    enum class Format { UNKNOWN, MIDDLEBURY, KITTI, SYNTHETIC };
+
+    StereoDataset();
+
+    bool load( const std::string &path );
+
+    Format format() const;
+
+    void setScale( const double value );
+    double scale() const;
+
+    size_t size() const;
+    bool empty() const;
+
+    StereoSample sample( const size_t index ) const;
+
+protected:
+    struct Entry
+    {
+        std::string name;
+
+        std::string leftFileName;
+        std::string rightFileName;
+        std::string groundTruthFileName;
+
+        int maxDisparity;
+    };
+
+    Format m_format;
+
+    double m_scale;
+
+    std::vector< Entry > m_entries;
+
+    bool loadMiddlebury( const std::string &path );
+    bool loadKitti( const std::string &path );
+    bool loadSynthetic( const std::string &path );
+
+    static cv::Mat loadGroundTruth( const std::string &fileName, const Format format );
+
+private:
+    void initialize();
+
+};
+
+struct DisparityMetrics
+{
+    // Percent of ground truth pixels, missing estimates count as bad
+    double bad05;
+    double bad1;
+    double bad2;
+    double bad4;
+    double d1;
+
+    // Percent of ground truth pixels with an estimate
+    double density;
+
+    // Pixels, over estimated pixels
+    double averageError;
+    double rmsError;
+};
+
+cv::Mat disparityToFloat( const cv::Mat &disparity );
+
+DisparityMetrics evaluateDisparity( const cv::Mat &disparity, const cv::Mat &groundTruth );
+
+// Percent of all pixels with a left view estimate confirmed by the right view one
+double disparityConsistency( const cv::Mat &leftDisparity, const cv::Mat &rightDisparity, const double threshold = 1. );
@@ -0,0 +1,215 @@
+#include "precompiled.h"
+
+#include "disparityparameters.h"
+
+#include "stereoprocessor.h"
+
+static void readValue( const cv::FileNode &node, const char *name, int *value )
+{
+    auto child = node[ name ];
+
+    if ( !child.empty() )
+        child >> *value;
+
+}
+
+// BMDisparityParameters
+BMDisparityParameters::BMDisparityParameters()
+    : blockSize( 7 ), minDisparity( 0 ), numDisparities( 256 ), preFilterSize( 15 ), preFilterCap( 12 ),
+      textureThreshold( 450 ), uniquenessRatio( 55 ), speckleWindowSize( 55 ), speckleRange( 5 ), disp12MaxDiff( 0 )
+{
+}
+
+void BMDisparityParameters::apply( BMDisparityProcessor *processor ) const
+{
+    processor->setBlockSize( blockSize );
+    processor->setMinDisparity( minDisparity );
+    processor->setNumDisparities( numDisparities );
+    processor->setPreFilterSize( preFilterSize );
+    processor->setPreFilterCap( preFilterCap );
+    processor->setTextureThreshold( textureThreshold );
+    processor->setUniquenessRatio( uniquenessRatio );
+    processor->setSpeckleWindowSize( speckleWindowSize );
+    processor->setSpeckleRange( speckleRange );
+    processor->setDisp12MaxDiff( disp12MaxDiff );
+}
+
+// GMDisparityParameters
+GMDisparityParameters::GMDisparityParameters()
+    : mode( cv::StereoSGBM::MODE_SGBM ), blockSize( 12 ), minDisparity( 0 ), numDisparities( 256 ), preFilterCap( 50 ),
+      uniquenessRatio( 30 ), speckleWindowSize( 20 ), speckleRange( 10 ), disp12MaxDiff( 0 ), p1( 0 ), p2( 0 )
+{
+}
+
+void GMDisparityParameters::apply( GMDisparityProcessor *processor ) const
+{
+    processor->setMode( mode );
+    processor->setBlockSize( blockSize );
+    processor->setMinDisparity( minDisparity );
+    processor->setNumDisparities( numDisparities );
+    processor->setPreFilterCap( preFilterCap );
+    processor->setUniquenessRatio( uniquenessRatio );
+    processor->setSpeckleWindowSize( speckleWindowSize );
+    processor->setSpeckleRange( speckleRange );
+    processor->setDisp12MaxDiff( disp12MaxDiff );
+    processor->setP1( p1 );
+    processor->setP2( p2 );
+}
+
+// DisparityParameters
+DisparityParameters::DisparityParameters()
+{
+    initialize();
+}
+
+DisparityParameters::DisparityParameters( const std::string &fileName )
+{
+    initialize();
+
+    loadYaml( fileName );
+}
+
+void DisparityParameters::initialize()
+{
+    m_method = Method::BM;
+    m_ok = false;
+}
+
+void DisparityParameters::setMethod( const Method value )
+{
+    m_method = value;
+}
+
+DisparityParameters::Method DisparityParameters::method() const
+{
+    return m_method;
+}
+
+void DisparityParameters::setBmParameters( const BMDisparityParameters &value )
+{
+    m_bmParameters = value;
+}
+
+const BMDisparityParameters &DisparityParameters::bmParameters() const
+{
+    return m_bmParameters;
+}
+
+void DisparityParameters::setGmParameters( const GMDisparityParameters &value )
+{
+    m_gmParameters = value;
+}
+
+const GMDisparityParameters &DisparityParameters::gmParameters() const
+{
+    return m_gmParameters;
+}
+
+bool DisparityParameters::isOk() const
+{
+    return m_ok;
+}
+
+bool DisparityParameters::saveYaml( const std::string &fileName ) const
+{
+    cv::FileStorage fs( fileName, cv::FileStorage::WRITE );
+
+    if ( !fs.isOpened() )
+        return false;
+
+    if ( m_method == Method::BM ) {
+        fs << "method" << "bm";
+
+        fs << "bm" << "{"
+           << "blockSize" << m_bmParameters.blockSize
+           << "minDisparity" << m_bmParameters.minDisparity
+           << "numDisparities" << m_bmParameters.numDisparities
+           << "preFilterSize" << m_bmParameters.preFilterSize
+           << "preFilterCap" << m_bmParameters.preFilterCap
+           << "textureThreshold" << m_bmParameters.textureThreshold
+           << "uniquenessRatio" << m_bmParameters.uniquenessRatio
+           << "speckleWindowSize" << m_bmParameters.speckleWindowSize
+           << "speckleRange" << m_bmParameters.speckleRange
+           << "disp12MaxDiff" << m_bmParameters.disp12MaxDiff << "}";
+
+    }
+    else {
+        fs << "method" << "gm";
+
+        fs << "gm" << "{"
+           << "mode" << m_gmParameters.mode
+           << "blockSize" << m_gmParameters.blockSize
+           << "minDisparity" << m_gmParameters.minDisparity
+           << "numDisparities" << m_gmParameters.numDisparities
+           << "preFilterCap" << m_gmParameters.preFilterCap
+           << "uniquenessRatio" << m_gmParameters.uniquenessRatio
+           << "speckleWindowSize" << m_gmParameters.speckleWindowSize
+           << "speckleRange" << m_gmParameters.speckleRange
+           << "disp12MaxDiff" << m_gmParameters.disp12MaxDiff
+           << "p1" << m_gmParameters.p1
+           << "p2" << m_gmParameters.p2 << "}";
+
+    }
+
+    fs.release();
+
+    return true;
+
+}
+
+bool DisparityParameters::loadYaml( const std::string &fileName )
+{
+    m_ok = false;
+
+    cv::FileStorage fs( fileName, cv::FileStorage::READ );
+
+    if ( !fs.isOpened() )
+        return false;
+
+    std::string method;
+    fs[ "method" ] >> method;
+
+    // Missing keys keep their defaults
+    if ( method == "bm" ) {
+        auto node = fs[ "bm" ];
+
+        readValue( node, "blockSize", &m_bmParameters.blockSize );
+        readValue( node, "minDisparity", &m_bmParameters.minDisparity );
+        readValue( node, "numDisparities", &m_bmParameters.numDisparities );
+        readValue( node, "preFilterSize", &m_bmParameters.preFilterSize );
+        readValue( node, "preFilterCap", &m_bmParameters.preFilterCap );
+        readValue( node, "textureThreshold", &m_bmParameters.textureThreshold );
+        readValue( node, "uniquenessRatio", &m_bmParameters.uniquenessRatio );
+        readValue( node, "speckleWindowSize", &m_bmParameters.speckleWindowSize );
+        readValue( node, "speckleRange", &m_bmParameters.speckleRange );
+        readValue( node, "disp12MaxDiff", &m_bmParameters.disp12MaxDiff );
+
+        m_method = Method::BM;
+
+    }
+    else if ( method == "gm" ) {
+        auto node = fs[ "gm" ];
+
+        readValue( node, "mode", &m_gmParameters.mode );
+        readValue( node, "blockSize", &m_gmParameters.blockSize );
+        readValue( node, "minDisparity", &m_gmParameters.minDisparity );
+        readValue( node, "numDisparities", &m_gmParameters.numDisparities );
+        readValue( node, "preFilterCap", &m_gmParameters.preFilterCap );
+        readValue( node, "uniquenessRatio", &m_gmParameters.uniquenessRatio );
+        readValue( node, "speckleWindowSize", &m_gmParameters.speckleWindowSize );
+        readValue( node, "speckleRange", &m_gmParameters.speckleRange );
+        readValue( node, "disp12MaxDiff", &m_gmParameters.disp12MaxDiff );
+        readValue( node, "p1", &m_gmParameters.p1 );
+        readValue( node, "p2", &m_gmParameters.p2 );
+
+        m_method = Method::GM;
+
+    }
+    else
+        return false;
+
+    m_ok = true;
+
+    return true;
+
+}
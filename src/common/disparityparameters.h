@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+
+class BMDisparityProcessor;
+class GMDisparityProcessor;
+
+struct BMDisparityParameters
+{
+    BMDisparityParameters();
+
+    int blockSize;
+    int minDisparity;
+    int numDisparities;
+    int preFilterSize;
+    int preFilterCap;
+    int textureThreshold;
+    int uniquenessRatio;
+    int speckleWindowSize;
+    int speckleRange;
+    int disp12MaxDiff;
+
+    void apply( BMDisparityProcessor *processor ) const;
+};
+
+struct GMDisparityParameters
+{
+    GMDisparityParameters();
+
+    int mode;
+    int blockSize;
+    int minDisparity;
+    int numDisparities;
+    int preFilterCap;
+    int uniquenessRatio;
+    int speckleWindowSize;
+    int speckleRange;
+    int disp12MaxDiff;
+    int p1;
+    int p2;
+
+    void apply( GMDisparityProcessor *processor ) const;
+};
+
+class DisparityParameters
+{
+public:
+    enum class Method { BM, GM };
+
+    DisparityParameters();
+    DisparityParameters( const std::string &fileName );
+
+    void setMethod( const Method value );
+    Method method() const;
+
+    void setBmParameters( const BMDisparityParameters &value );
+    const BMDisparityParameters &bmParameters() const;
+
+    void setGmParameters( const GMDisparityParameters &value );
+    const GMDisparityParameters &gmParameters() const;
+
+    bool isOk() const;
+
+    bool saveYaml( const std::string &fileName ) const;
+    bool loadYaml( const std::string &fileName );
+
+protected:
+    Method m_method;
+
+    BMDisparityParameters m_bmParameters;
+    GMDisparityParameters m_gmParameters;
+
+    bool m_ok;
+
+private:
+    void initialize();
+
+};
@@ -0,0 +1,376 @@
+#include "precompiled.h"
+
+#include "disparitypreprocessor.h"
+
+#include "taskscheduler.h"
+
+#include <array>
+#include <numeric>
+
+// cv::COLOR_BGR2GRAY fixed point weights
+static const int GRAY_SHIFT = 14;
+static const int GRAY_BLUE = 1868;
+static const int GRAY_GREEN = 9617;
+static const int GRAY_RED = 4899;
+
+static const int KERNEL_SHIFT = 8;
+static const int MAX_BLUR_SIZE = 31;
+
+template < int CHANNELS >
+static void convertRow( const uchar *source, const int width, uchar *destination )
+{
+    #pragma omp simd
+    for ( int x = 0; x < width; ++x ) {
+        auto pixel = source + x * CHANNELS;
+        destination[ x ] = static_cast< uchar >( ( pixel[ 0 ] * GRAY_BLUE + pixel[ 1 ] * GRAY_GREEN + pixel[ 2 ] * GRAY_RED
+                                                   + ( 1 << ( GRAY_SHIFT - 1 ) ) ) >> GRAY_SHIFT );
+    }
+
+}
+
+static void grayRow( const cv::Mat &image, const int y, uchar *destination )
+{
+    auto source = image.ptr< uchar >( y );
+
+    switch ( image.channels() ) {
+    case 1:
+        std::copy( source, source + image.cols, destination );
+        break;
+    case 3:
+        convertRow< 3 >( source, image.cols, destination );
+        break;
+    default:
+        convertRow< 4 >( source, image.cols, destination );
+        break;
+    }
+
+}
+
+// Vertical then horizontal pass of the fixed point kernel over the kernel size rows around the result row
+static void blurRow( const uchar *const *rows, const uint16_t *kernel, const int size, const int width,
+                     uint16_t *sums, uint32_t *accumulators, uchar *result )
+{
+    auto radius = size / 2;
+    auto center = sums + radius;
+
+    for ( int k = 0; k < size; ++k ) {
+        auto row = rows[ k ];
+        auto weight = kernel[ k ];
+
+        if ( k == 0 ) {
+            #pragma omp simd
+            for ( int x = 0; x < width; ++x )
+                center[ x ] = weight * row[ x ];
+        }
+        else {
+            #pragma omp simd
+            for ( int x = 0; x < width; ++x )
+                center[ x ] += weight * row[ x ];
+        }
+
+    }
+
+    for ( int i = 1; i <= radius; ++i ) {
+        center[ -i ] = center[ cv::borderInterpolate( -i, width, cv::BORDER_REFLECT_101 ) ];
+        center[ width - 1 + i ] = center[ cv::borderInterpolate( width - 1 + i, width, cv::BORDER_REFLECT_101 ) ];
+    }
+
+    for ( int k = 0; k < size; ++k ) {
+        auto shifted = sums + k;
+        auto weight = kernel[ k ];
+
+        if ( k == 0 ) {
+            #pragma omp simd
+            for ( int x = 0; x < width; ++x )
+                accumulators[ x ] = weight * shifted[ x ];
+        }
+        else {
+            #pragma omp simd
+            for ( int x = 0; x < width; ++x )
+                accumulators[ x ] += weight * shifted[ x ];
+        }
+
+    }
+
+    #pragma omp simd
+    for ( int x = 0; x < width; ++x )
+        result[ x ] = static_cast< uchar >( ( accumulators[ x ] + ( 1 << ( 2 * KERNEL_SHIFT - 1 ) ) ) >> ( 2 * KERNEL_SHIFT ) );
+
+}
+
+// DisparityPreprocessor
+DisparityPreprocessor::DisparityPreprocessor()
+{
+    initialize();
+}
+
+void DisparityPreprocessor::initialize()
+{
+    m_equalizationEnabled = true;
+    m_frameEqualization = false;
+    m_blurSize = 5;
+
+    m_left.shared = false;
+    m_right.shared = false;
+
+    updateKernel();
+}
+
+bool DisparityPreprocessor::isEqualizationEnabled() const
+{
+    return m_equalizationEnabled;
+}
+
+void DisparityPreprocessor::setEqualizationEnabled( const bool value )
+{
+    m_equalizationEnabled = value;
+}
+
+int DisparityPreprocessor::getBlurSize() const
+{
+    return m_blurSize;
+}
+
+void DisparityPreprocessor::setBlurSize( const int value )
+{
+    auto blurSize = std::min( MAX_BLUR_SIZE, std::max( 1, value ) ) | 1;
+
+    if ( blurSize != m_blurSize ) {
+        m_blurSize = blurSize;
+        updateKernel();
+    }
+
+}
+
+void DisparityPreprocessor::copySettings( const DisparityPreprocessor &other )
+{
+    setEqualizationEnabled( other.m_equalizationEnabled );
+    setBlurSize( other.m_blurSize );
+
+    m_frameEqualization = other.m_frameEqualization;
+    m_left.frameLut = other.m_left.frameLut;
+    m_right.frameLut = other.m_right.frameLut;
+
+}
+
+void DisparityPreprocessor::setEqualizationFrames( const cv::Mat &left, const cv::Mat &right )
+{
+    m_frameEqualization = m_equalizationEnabled && !left.empty() && !right.empty();
+
+    if ( !m_frameEqualization )
+        return;
+
+    TaskGroup group;
+
+    group.run( [ & ] { computeTable( left, false, &m_left, &m_left.frameLut ); } );
+    group.run( [ & ] { computeTable( right, false, &m_right, &m_right.frameLut ); } );
+
+    group.wait();
+
+}
+
+std::vector< double > DisparityPreprocessor::parameters() const
+{
+    return { double( m_equalizationEnabled ), double( m_blurSize ) };
+}
+
+// Same weights as cv::GaussianBlur with zero sigma, rounded so they still sum to one
+void DisparityPreprocessor::updateKernel()
+{
+    cv::Mat kernel = cv::getGaussianKernel( m_blurSize, 0, CV_64F );
+
+    m_kernel.resize( m_blurSize );
+
+    for ( int i = 0; i < m_blurSize; ++i )
+        m_kernel[ i ] = static_cast< uint16_t >( cvRound( kernel.at< double >( i ) * ( 1 << KERNEL_SHIFT ) ) );
+
+    auto sum = std::accumulate( m_kernel.begin(), m_kernel.end(), 0 );
+
+    m_kernel[ m_blurSize / 2 ] += ( 1 << KERNEL_SHIFT ) - sum;
+}
+
+// Same table as cv::equalizeHist, the gray image is kept in the view when asked for
+void DisparityPreprocessor::computeTable( const cv::Mat &image, const bool keepGray, View *view, std::array< uchar, 256 > *lut ) const
+{
+    auto width = image.cols;
+    auto height = image.rows;
+
+    auto bandsCount = std::max( 1, std::min( height, static_cast< int >( TaskScheduler::instance().threadsCount() ) ) );
+
+    view->bands.resize( bandsCount );
+
+    if ( keepGray )
+        view->gray.create( image.size(), CV_8U );
+
+    parallelFor( 0, bandsCount, [ & ]( const int band ) {
+        auto &buffers = view->bands[ band ];
+        auto &histogram = buffers.histogram;
+
+        histogram.fill( 0 );
+
+        if ( !keepGray )
+            buffers.rows.resize( width );
+
+        for ( int y = height * band / bandsCount; y < height * ( band + 1 ) / bandsCount; ++y ) {
+            auto row = keepGray ? view->gray.ptr< uchar >( y ) : buffers.rows.data();
+
+            grayRow( image, y, row );
+
+            for ( int x = 0; x < width; ++x )
+                ++histogram[ row[ x ] ];
+
+        }
+
+    } );
+
+    std::array< int, 256 > histogram;
+    histogram.fill( 0 );
+
+    for ( auto &band : view->bands )
+        for ( size_t i = 0; i < histogram.size(); ++i )
+            histogram[ i ] += band.histogram[ i ];
+
+    int first = 0;
+
+    while ( histogram[ first ] == 0 )
+        ++first;
+
+    auto total = width * height;
+
+    if ( histogram[ first ] == total )
+        std::iota( lut->begin(), lut->end(), 0 );
+    else {
+        auto scale = 255.f / ( total - histogram[ first ] );
+
+        std::fill( lut->begin(), lut->begin() + first + 1, 0 );
+
+        int sum = 0;
+
+        for ( int i = first + 1; i < 256; ++i ) {
+            sum += histogram[ i ];
+            ( *lut )[ i ] = cv::saturate_cast< uchar >( sum * scale );
+        }
+
+    }
+
+}
+
+void DisparityPreprocessor::processView( const cv::Mat &image, View *view ) const
+{
+    if ( image.empty() ) {
+        view->result = cv::Mat();
+        view->shared = false;
+        return;
+    }
+
+    auto width = image.cols;
+    auto height = image.rows;
+    auto radius = m_blurSize / 2;
+
+    if ( !m_equalizationEnabled && radius == 0 && image.channels() == 1 ) {
+        view->result = image;
+        view->shared = true;
+        return;
+    }
+
+    // A result passed through earlier shares the buffer of that image, which may be this one or overlap it
+    if ( view->shared ) {
+        view->result.release();
+        view->shared = false;
+    }
+
+    view->result.create( image.size(), CV_8U );
+
+    auto frameTable = m_equalizationEnabled && m_frameEqualization;
+
+    if ( m_equalizationEnabled && !frameTable )
+        computeTable( image, true, view, &view->lut );
+
+    auto bandsCount = std::max( 1, std::min( height, static_cast< int >( TaskScheduler::instance().threadsCount() ) ) );
+
+    view->bands.resize( bandsCount );
+
+    // Blur input row: equalized gray, gray equalized with the frame table, or gray converted straight from the image
+    auto loadRow = [ & ]( const int y, uchar *destination ) {
+        if ( frameTable ) {
+            grayRow( image, y, destination );
+
+            for ( int x = 0; x < width; ++x )
+                destination[ x ] = view->frameLut[ destination[ x ] ];
+
+        }
+        else if ( m_equalizationEnabled ) {
+            auto source = view->gray.ptr< uchar >( y );
+
+            for ( int x = 0; x < width; ++x )
+                destination[ x ] = view->lut[ source[ x ] ];
+
+        }
+        else
+            grayRow( image, y, destination );
+
+    };
+
+    parallelFor( 0, bandsCount, [ & ]( const int band ) {
+        auto begin = height * band / bandsCount;
+        auto end = height * ( band + 1 ) / bandsCount;
+
+        if ( radius == 0 ) {
+            for ( int y = begin; y < end; ++y )
+                loadRow( y, view->result.ptr< uchar >( y ) );
+
+            return;
+
+        }
+
+        auto &buffers = view->bands[ band ];
+
+        buffers.rows.resize( m_blurSize * width );
+        buffers.sums.resize( width + 2 * radius );
+        buffers.accumulators.resize( width );
+
+        auto rows = buffers.rows.data();
+        auto sums = buffers.sums.data();
+        auto accumulators = buffers.accumulators.data();
+
+        // Row y of the band is kept in slot y modulo the kernel size, rows past the border are reflected
+        auto slot = [ & ]( const int y ) {
+            return rows + ( ( y % m_blurSize ) + m_blurSize ) % m_blurSize * width;
+        };
+
+        auto load = [ & ]( const int y ) {
+            loadRow( cv::borderInterpolate( y, height, cv::BORDER_REFLECT_101 ), slot( y ) );
+        };
+
+        for ( int y = begin - radius; y < begin + radius; ++y )
+            load( y );
+
+        std::array< const uchar *, MAX_BLUR_SIZE > kernelRows;
+
+        for ( int y = begin; y < end; ++y ) {
+            load( y + radius );
+
+            for ( int k = 0; k < m_blurSize; ++k )
+                kernelRows[ k ] = slot( y - radius + k );
+
+            blurRow( kernelRows.data(), m_kernel.data(), m_blurSize, width, sums, accumulators, view->result.ptr< uchar >( y ) );
+
+        }
+
+    } );
+
+}
+
+void DisparityPreprocessor::process( const cv::Mat &left, const cv::Mat &right, cv::Mat *leftResult, cv::Mat *rightResult )
+{
+    TaskGroup group;
+
+    group.run( [ & ] { processView( left, &m_left ); } );
+    group.run( [ & ] { processView( right, &m_right ); } );
+
+    group.wait();
+
+    *leftResult = m_left.result;
+    *rightResult = m_right.result;
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Gray conversion, histogram equalization and Gaussian blur of a stereo pair before matching.
+// Both views run concurrently, the gray conversion or equalization lookup is fused into the
+// blur, all buffers are kept between frames
+class DisparityPreprocessor
+{
+public:
+    DisparityPreprocessor();
+
+    bool isEqualizationEnabled() const;
+    void setEqualizationEnabled( const bool value );
+
+    // Odd Gaussian kernel size, 1 disables blurring
+    int getBlurSize() const;
+    void setBlurSize( const int value );
+
+    // Equalization, blur and frame tables of another preprocessor
+    void copySettings( const DisparityPreprocessor &other );
+
+    // Equalizes with the tables of these whole frames instead of each processed image, so crops of them
+    // are equalized as in the full frames. Empty frames go back to per image tables
+    void setEqualizationFrames( const cv::Mat &left, const cv::Mat &right );
+
+    // Settings the result depends on, see DisparityProcessorBase::parameters
+    std::vector< double > parameters() const;
+
+    // 8 bit gray, color or color with alpha input. Results are valid until the next call
+    void process( const cv::Mat &left, const cv::Mat &right, cv::Mat *leftResult, cv::Mat *rightResult );
+
+protected:
+    struct Band
+    {
+        std::array< int, 256 > histogram;
+
+        // Ring of the blurred rows, vertical sums with the border reflected and horizontal sums
+        std::vector< uchar > rows;
+        std::vector< uint16_t > sums;
+        std::vector< uint32_t > accumulators;
+    };
+
+    struct View
+    {
+        cv::Mat gray;
+        cv::Mat result;
+
+        // The result is the input image passed through, not a buffer of the view
+        bool shared;
+
+        std::array< uchar, 256 > lut;
+        std::array< uchar, 256 > frameLut;
+
+        std::vector< Band > bands;
+    };
+
+    bool m_equalizationEnabled;
+    int m_blurSize;
+
+    // Equalization with the frameLut tables of the views, see setEqualizationFrames
+    bool m_frameEqualization;
+
+    // Fixed point kernel, sums to 1 << KERNEL_SHIFT
+    std::vector< uint16_t > m_kernel;
+
+    View m_left;
+    View m_right;
+
+    void computeTable( const cv::Mat &image, const bool keepGray, View *view, std::array< uchar, 256 > *lut ) const;
+    void processView( const cv::Mat &image, View *view ) const;
+
+    void updateKernel();
+
+private:
+    void initialize();
+
+};
@@ -0,0 +1,370 @@
+#include "precompiled.h"
+
+#include "disparityrefinement.h"
+
+#include "taskscheduler.h"
+
+#include <array>
+#include <cmath>
+
+// Columns per task of the vertical filter pass, rows of a strip run as one vector loop
+static const int STRIP_WIDTH = 256;
+
+// Fixed point disparity jumps past this one stop the filter completely
+static const int MAX_JUMP = 64 * cv::StereoMatcher::DISP_SCALE;
+
+static cv::Mat grayImage( const CvImage &image )
+{
+    if ( image.channels() == 1 )
+        return image;
+
+    cv::Mat ret;
+    cv::cvtColor( image, ret, cv::COLOR_BGR2GRAY );
+
+    return ret;
+
+}
+
+// DisparityRefinement
+DisparityRefinement::DisparityRefinement()
+{
+    initialize();
+}
+
+void DisparityRefinement::initialize()
+{
+    m_subpixelEnabled = true;
+    m_maxHoleWidth = 16;
+    m_iterations = 2;
+
+    m_spatialSigma = 10.;
+    m_colorSigma = 20.;
+    m_disparitySigma = 2.;
+}
+
+bool DisparityRefinement::isSubpixelEnabled() const
+{
+    return m_subpixelEnabled;
+}
+
+void DisparityRefinement::setSubpixelEnabled( const bool value )
+{
+    m_subpixelEnabled = value;
+}
+
+int DisparityRefinement::getMaxHoleWidth() const
+{
+    return m_maxHoleWidth;
+}
+
+void DisparityRefinement::setMaxHoleWidth( const int value )
+{
+    m_maxHoleWidth = std::max( 0, value );
+}
+
+int DisparityRefinement::getIterations() const
+{
+    return m_iterations;
+}
+
+void DisparityRefinement::setIterations( const int value )
+{
+    m_iterations = std::max( 0, value );
+}
+
+double DisparityRefinement::getSpatialSigma() const
+{
+    return m_spatialSigma;
+}
+
+void DisparityRefinement::setSpatialSigma( const double value )
+{
+    m_spatialSigma = std::max( 0.1, value );
+}
+
+double DisparityRefinement::getColorSigma() const
+{
+    return m_colorSigma;
+}
+
+void DisparityRefinement::setColorSigma( const double value )
+{
+    m_colorSigma = std::max( 0.1, value );
+}
+
+double DisparityRefinement::getDisparitySigma() const
+{
+    return m_disparitySigma;
+}
+
+void DisparityRefinement::setDisparitySigma( const double value )
+{
+    m_disparitySigma = std::max( 0.1, value );
+}
+
+std::vector< double > DisparityRefinement::parameters() const
+{
+    return { double( m_subpixelEnabled ), double( m_maxHoleWidth ), double( m_iterations ),
+             m_spatialSigma, m_colorSigma, m_disparitySigma };
+}
+
+// Parabola through the 3x3 SAD costs of the neighbour disparities, for the matchers that give whole pixels
+void DisparityRefinement::refineSubpixel( const cv::Mat &left, const cv::Mat &right, const short invalidValue, cv::Mat *disparity ) const
+{
+    auto width = disparity->cols;
+
+    parallelFor( 1, disparity->rows - 1, [ & ]( const int y ) {
+        auto row = disparity->ptr< short >( y );
+
+        for ( int x = 1; x < width - 1; ++x ) {
+            auto value = row[ x ];
+
+            if ( value <= invalidValue || value % cv::StereoMatcher::DISP_SCALE != 0 )
+                continue;
+
+            int d = value / cv::StereoMatcher::DISP_SCALE;
+
+            if ( x - d - 2 < 0 || x - d + 2 >= width )
+                continue;
+
+            int costs[ 3 ] = { 0, 0, 0 };
+
+            for ( int dy = -1; dy <= 1; ++dy ) {
+                auto leftRow = left.ptr< uchar >( y + dy ) + x;
+                auto rightRow = right.ptr< uchar >( y + dy ) + x - d;
+
+                for ( int dx = -1; dx <= 1; ++dx )
+                    for ( int k = 0; k < 3; ++k )
+                        costs[ k ] += std::abs( leftRow[ dx ] - rightRow[ dx + 1 - k ] );
+
+            }
+
+            auto denominator = costs[ 0 ] + costs[ 2 ] - 2 * costs[ 1 ];
+
+            if ( costs[ 1 ] >= costs[ 0 ] || costs[ 1 ] >= costs[ 2 ] || denominator <= 0 )
+                continue;
+
+            auto offset = static_cast< float >( costs[ 0 ] - costs[ 2 ] ) / ( 2 * denominator );
+
+            row[ x ] = static_cast< short >( cvRound( ( d + offset ) * cv::StereoMatcher::DISP_SCALE ) );
+
+        }
+
+    } );
+
+}
+
+// Holes between two valid pixels are mostly occlusions rejected by the left-right check,
+// they take the farther of the two sides
+void DisparityRefinement::fillHoles( const short invalidValue, cv::Mat *disparity ) const
+{
+    auto width = disparity->cols;
+
+    parallelFor( 0, disparity->rows, [ & ]( const int y ) {
+        auto row = disparity->ptr< short >( y );
+
+        int x = 0;
+
+        while ( x < width ) {
+
+            if ( row[ x ] > invalidValue ) {
+                ++x;
+                continue;
+            }
+
+            auto begin = x;
+
+            while ( x < width && row[ x ] <= invalidValue )
+                ++x;
+
+            if ( begin == 0 || x == width || x - begin > m_maxHoleWidth )
+                continue;
+
+            std::fill( row + begin, row + x, std::min( row[ begin - 1 ], row[ x ] ) );
+
+        }
+
+    } );
+
+}
+
+// Recursive domain transform filter (Gastal and Oliveira), the distance between neighbours
+// grows with both the guide and the disparity difference. Invalid pixels have zero weight and
+// keep invalid, so the result is a normalized convolution of the valid ones
+void DisparityRefinement::filter( const cv::Mat &guide, const short invalidValue, cv::Mat *disparity )
+{
+    auto width = disparity->cols;
+    auto height = disparity->rows;
+
+    auto total = disparity->total();
+
+    m_values.resize( total );
+    m_weights.resize( total );
+    m_horizontalFeedback.resize( total );
+    m_verticalFeedback.resize( total );
+
+    // Sigma of the first pass, so the passes together give the spatial sigma. Each next pass has
+    // half the sigma, its feedback is the square of the previous one
+    auto sigma = m_spatialSigma * std::sqrt( 3. ) * std::pow( 2., m_iterations - 1 ) / std::sqrt( std::pow( 4., m_iterations ) - 1. );
+    auto logFeedback = -std::sqrt( 2. ) / sigma;
+
+    // The feedback a^d of the distance d = 1 + colorRatio * |dI| + disparityRatio * |dD| is
+    // a product of two tables
+    std::array< float, 256 > colorFeedback;
+    std::vector< float > jumpFeedback( MAX_JUMP + 1 );
+
+    for ( size_t i = 0; i < colorFeedback.size(); ++i )
+        colorFeedback[ i ] = static_cast< float >( std::exp( logFeedback * ( 1. + m_spatialSigma / m_colorSigma * i ) ) );
+
+    for ( size_t i = 0; i < jumpFeedback.size(); ++i )
+        jumpFeedback[ i ] = static_cast< float >( std::exp( logFeedback * m_spatialSigma / ( m_disparitySigma * cv::StereoMatcher::DISP_SCALE ) * i ) );
+
+    auto feedback = [ & ]( const uchar firstColor, const uchar secondColor, const short firstValue, const short secondValue ) {
+        auto ret = colorFeedback[ std::abs( firstColor - secondColor ) ];
+
+        if ( firstValue > invalidValue && secondValue > invalidValue )
+            ret *= jumpFeedback[ std::min( std::abs( firstValue - secondValue ), MAX_JUMP ) ];
+
+        return ret;
+
+    };
+
+    parallelFor( 0, height, [ & ]( const int y ) {
+        auto row = disparity->ptr< short >( y );
+        auto guideRow = guide.ptr< uchar >( y );
+
+        auto values = m_values.data() + y * width;
+        auto weights = m_weights.data() + y * width;
+        auto horizontal = m_horizontalFeedback.data() + y * width;
+        auto vertical = m_verticalFeedback.data() + y * width;
+
+        for ( int x = 0; x < width; ++x ) {
+            auto isValid = row[ x ] > invalidValue;
+
+            values[ x ] = isValid ? row[ x ] : 0.f;
+            weights[ x ] = isValid ? 1.f : 0.f;
+        }
+
+        horizontal[ 0 ] = 0.f;
+
+        for ( int x = 1; x < width; ++x )
+            horizontal[ x ] = feedback( guideRow[ x ], guideRow[ x - 1 ], row[ x ], row[ x - 1 ] );
+
+        if ( y == 0 ) {
+            std::fill( vertical, vertical + width, 0.f );
+            return;
+        }
+
+        auto previousRow = disparity->ptr< short >( y - 1 );
+        auto previousGuideRow = guide.ptr< uchar >( y - 1 );
+
+        for ( int x = 0; x < width; ++x )
+            vertical[ x ] = feedback( guideRow[ x ], previousGuideRow[ x ], row[ x ], previousRow[ x ] );
+
+    } );
+
+    auto stripsCount = ( width + STRIP_WIDTH - 1 ) / STRIP_WIDTH;
+
+    for ( int i = 0; i < m_iterations; ++i ) {
+
+        if ( i > 0 ) {
+            parallelFor( 0, height, [ & ]( const int y ) {
+                auto horizontal = m_horizontalFeedback.data() + y * width;
+                auto vertical = m_verticalFeedback.data() + y * width;
+
+                #pragma omp simd
+                for ( int x = 0; x < width; ++x ) {
+                    horizontal[ x ] *= horizontal[ x ];
+                    vertical[ x ] *= vertical[ x ];
+                }
+
+            } );
+
+        }
+
+        // Sequential along the row, values and weights as two independent chains
+        parallelFor( 0, height, [ & ]( const int y ) {
+            auto values = m_values.data() + y * width;
+            auto weights = m_weights.data() + y * width;
+            auto horizontal = m_horizontalFeedback.data() + y * width;
+
+            for ( int x = 1; x < width; ++x ) {
+                values[ x ] += horizontal[ x ] * ( values[ x - 1 ] - values[ x ] );
+                weights[ x ] += horizontal[ x ] * ( weights[ x - 1 ] - weights[ x ] );
+            }
+
+            for ( int x = width - 2; x >= 0; --x ) {
+                values[ x ] += horizontal[ x + 1 ] * ( values[ x + 1 ] - values[ x ] );
+                weights[ x ] += horizontal[ x + 1 ] * ( weights[ x + 1 ] - weights[ x ] );
+            }
+
+        } );
+
+        // Whole row segments at once, vectorized across the columns of a strip
+        parallelFor( 0, stripsCount, [ & ]( const int strip ) {
+            auto begin = strip * STRIP_WIDTH;
+            auto count = std::min( STRIP_WIDTH, width - begin );
+
+            auto passRow = [ & ]( const int y, const int neighbourY, const int feedbackY ) {
+                auto values = m_values.data() + y * width + begin;
+                auto weights = m_weights.data() + y * width + begin;
+                auto neighbourValues = m_values.data() + neighbourY * width + begin;
+                auto neighbourWeights = m_weights.data() + neighbourY * width + begin;
+                auto vertical = m_verticalFeedback.data() + feedbackY * width + begin;
+
+                #pragma omp simd
+                for ( int x = 0; x < count; ++x ) {
+                    values[ x ] += vertical[ x ] * ( neighbourValues[ x ] - values[ x ] );
+                    weights[ x ] += vertical[ x ] * ( neighbourWeights[ x ] - weights[ x ] );
+                }
+
+            };
+
+            for ( int y = 1; y < height; ++y )
+                passRow( y, y - 1, y );
+
+            for ( int y = height - 2; y >= 0; --y )
+                passRow( y, y + 1, y + 1 );
+
+        } );
+
+    }
+
+    parallelFor( 0, height, [ & ]( const int y ) {
+        auto row = disparity->ptr< short >( y );
+
+        auto values = m_values.data() + y * width;
+        auto weights = m_weights.data() + y * width;
+
+        for ( int x = 0; x < width; ++x )
+            if ( row[ x ] > invalidValue && weights[ x ] > 0.f )
+                row[ x ] = static_cast< short >( cvRound( values[ x ] / weights[ x ] ) );
+
+    } );
+
+}
+
+cv::Mat DisparityRefinement::process( const cv::Mat &disparity, const CvImage &left, const CvImage &right, const cv::Range &range )
+{
+    // Only fixed point disparity has a known scale and invalid value
+    if ( disparity.empty() || disparity.type() != CV_16S )
+        return disparity;
+
+    const short invalidValue = ( range.start - 1 ) * cv::StereoMatcher::DISP_SCALE;
+
+    auto leftGray = grayImage( left );
+
+    cv::Mat ret = disparity.clone();
+
+    if ( m_subpixelEnabled )
+        refineSubpixel( leftGray, grayImage( right ), invalidValue, &ret );
+
+    if ( m_maxHoleWidth > 0 )
+        fillHoles( invalidValue, &ret );
+
+    if ( m_iterations > 0 )
+        filter( leftGray, invalidValue, &ret );
+
+    return ret;
+
+}
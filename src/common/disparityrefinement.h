@@ -0,0 +1,66 @@
+#pragma once
+
+#include "image.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+
+// Post processing of CV_16S fixed point disparity from any DisparityProcessorBase: sub-pixel
+// refinement of whole pixel matches, filling of the holes left by the left-right check and
+// a domain transform filter guided by the left image
+class DisparityRefinement
+{
+public:
+    DisparityRefinement();
+
+    bool isSubpixelEnabled() const;
+    void setSubpixelEnabled( const bool value );
+
+    // Widest filled hole in pixels, 0 disables filling
+    int getMaxHoleWidth() const;
+    void setMaxHoleWidth( const int value );
+
+    // Filter passes, 0 disables filtering
+    int getIterations() const;
+    void setIterations( const int value );
+
+    double getSpatialSigma() const;
+    void setSpatialSigma( const double value );
+
+    double getColorSigma() const;
+    void setColorSigma( const double value );
+
+    // Disparity jumps in pixels the filter smooths over
+    double getDisparitySigma() const;
+    void setDisparitySigma( const double value );
+
+    // Settings the result depends on, see DisparityProcessorBase::parameters
+    std::vector< double > parameters() const;
+
+    // Disparity below the range start is invalid
+    cv::Mat process( const cv::Mat &disparity, const CvImage &left, const CvImage &right, const cv::Range &range );
+
+protected:
+    bool m_subpixelEnabled;
+    int m_maxHoleWidth;
+    int m_iterations;
+
+    double m_spatialSigma;
+    double m_colorSigma;
+    double m_disparitySigma;
+
+    // Filter buffers, kept between frames
+    std::vector< float > m_values;
+    std::vector< float > m_weights;
+    std::vector< float > m_horizontalFeedback;
+    std::vector< float > m_verticalFeedback;
+
+    void refineSubpixel( const cv::Mat &left, const cv::Mat &right, const short invalidValue, cv::Mat *disparity ) const;
+    void fillHoles( const short invalidValue, cv::Mat *disparity ) const;
+    void filter( const cv::Mat &guide, const short invalidValue, cv::Mat *disparity );
+
+private:
+    void initialize();
+
+};
@@ -0,0 +1,252 @@
+#include "precompiled.h"
+
+#include "frametrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static double percentile( const std::vector< int64_t > &sortedValues, const double value )
+{
+    if ( sortedValues.empty() )
+        return 0.;
+
+    auto index = static_cast< size_t >( std::ceil( value * sortedValues.size() ) );
+
+    index = std::min( std::max< size_t >( index, 1 ), sortedValues.size() ) - 1;
+
+    return sortedValues[ index ] * 1.e-3;
+}
+
+// FrameTrace
+std::atomic< uint64_t > FrameTrace::m_nextId( 1 );
+
+FrameTrace::FrameTrace()
+{
+}
+
+FrameTrace FrameTrace::create( const char *stage )
+{
+    FrameTrace ret;
+
+    ret.m_data = std::make_shared< Data >();
+    ret.m_data->id = m_nextId++;
+
+    ret.mark( stage );
+
+    return ret;
+
+}
+
+bool FrameTrace::isValid() const
+{
+    return m_data != nullptr;
+}
+
+uint64_t FrameTrace::id() const
+{
+    return m_data ? m_data->id : 0;
+}
+
+void FrameTrace::mark( const char *stage ) const
+{
+    if ( m_data ) {
+        auto time = Clock::now();
+
+        std::lock_guard< std::mutex > lock( m_data->mutex );
+        m_data->stages.push_back( Stage( stage, time ) );
+
+    }
+
+}
+
+std::vector< FrameTrace::Stage > FrameTrace::stages() const
+{
+    if ( !m_data )
+        return std::vector< Stage >();
+
+    std::lock_guard< std::mutex > lock( m_data->mutex );
+
+    return m_data->stages;
+
+}
+
+// LatencyMonitor
+LatencyMonitor::LatencyMonitor()
+{
+    initialize();
+}
+
+void LatencyMonitor::initialize()
+{
+    m_samplesCount = 1000;
+}
+
+LatencyMonitor &LatencyMonitor::instance()
+{
+    static LatencyMonitor monitor;
+
+    return monitor;
+}
+
+void LatencyMonitor::finish( const FrameTrace &trace, const char *sink )
+{
+    if ( !trace.isValid() )
+        return;
+
+    auto time = FrameTrace::Clock::now();
+    auto stages = trace.stages();
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    // Views refreshed by a timer can show the same frame several times, count it once
+    auto lastId = m_lastIds.find( sink );
+
+    if ( lastId != m_lastIds.end() && lastId->second == trace.id() )
+        return;
+
+    m_lastIds[ sink ] = trace.id();
+
+    // Every stage is measured from the previous one, so a growing interval points to the queue in front of it
+    for ( size_t i = 1; i < stages.size(); ++i )
+        addSample( Key( sink, stages[ i ].first ), std::chrono::duration_cast< std::chrono::microseconds >( stages[ i ].second - stages[ i - 1 ].second ).count() );
+
+    if ( !stages.empty() ) {
+        addSample( Key( sink, "display" ), std::chrono::duration_cast< std::chrono::microseconds >( time - stages.back().second ).count() );
+        addSample( Key( sink, "total" ), std::chrono::duration_cast< std::chrono::microseconds >( time - stages.front().second ).count() );
+    }
+
+}
+
+void LatencyMonitor::drop( const FrameTrace &trace, const char *stage )
+{
+    if ( !trace.isValid() )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    ++m_droppedFrames[ stage ];
+
+}
+
+void LatencyMonitor::addSample( const Key &key, const int64_t value )
+{
+    auto it = m_samples.find( key );
+
+    if ( it == m_samples.end() ) {
+        it = m_samples.insert( std::make_pair( key, LimitedQueue< int64_t >( m_samplesCount ) ) ).first;
+        m_order.push_back( key );
+    }
+
+    it->second.push( value );
+
+}
+
+std::vector< LatencyStatistics > LatencyMonitor::statistics() const
+{
+    std::vector< LatencyStatistics > ret;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    for ( auto &i : m_order ) {
+        auto &samples = m_samples.at( i );
+
+        std::vector< int64_t > values( samples.begin(), samples.end() );
+
+        std::sort( values.begin(), values.end() );
+
+        LatencyStatistics statistics;
+
+        statistics.sink = i.first;
+        statistics.stage = i.second;
+        statistics.count = values.size();
+        statistics.p50 = percentile( values, 0.50 );
+        statistics.p95 = percentile( values, 0.95 );
+        statistics.p99 = percentile( values, 0.99 );
+        statistics.max = values.empty() ? 0. : values.back() * 1.e-3;
+
+        ret.push_back( statistics );
+
+    }
+
+    return ret;
+
+}
+
+std::map< std::string, size_t > LatencyMonitor::droppedFrames() const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    return m_droppedFrames;
+}
+
+size_t LatencyMonitor::samplesCount() const
+{
+    return m_samplesCount;
+}
+
+void LatencyMonitor::setSamplesCount( const size_t value )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_samplesCount = std::max< size_t >( value, 1 );
+
+    for ( auto &i : m_samples )
+        i.second.setMaxSize( m_samplesCount );
+
+}
+
+void LatencyMonitor::clear()
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_samples.clear();
+    m_order.clear();
+    m_lastIds.clear();
+    m_droppedFrames.clear();
+
+}
+
+void LatencyMonitor::report() const
+{
+    auto statistics = this->statistics();
+    auto droppedFrames = this->droppedFrames();
+
+    std::cout << std::left << std::setw( 40 ) << "Latency" << std::right
+              << std::setw( 8 ) << "count" << std::setw( 10 ) << "p50"
+              << std::setw( 10 ) << "p95" << std::setw( 10 ) << "p99" << std::setw( 10 ) << "max" << std::endl;
+
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    for ( auto &i : statistics )
+        std::cout << std::left << std::setw( 40 ) << i.sink + ": " + i.stage << std::right
+                  << std::setw( 8 ) << i.count << std::setw( 10 ) << i.p50
+                  << std::setw( 10 ) << i.p95 << std::setw( 10 ) << i.p99 << std::setw( 10 ) << i.max << std::endl;
+
+    for ( auto &i : droppedFrames )
+        std::cout << "Dropped frames, " << i.first << ": " << i.second << std::endl;
+
+    std::cout << std::defaultfloat;
+
+}
+
+bool LatencyMonitor::saveCsv( const std::string &fileName ) const
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    stream << "sink,stage,count,p50_ms,p95_ms,p99_ms,max_ms" << std::endl;
+
+    for ( auto &i : statistics() )
+        stream << i.sink << "," << i.stage << "," << i.count << "," << i.p50 << "," << i.p95 << "," << i.p99 << "," << i.max << std::endl;
+
+    for ( auto &i : droppedFrames() )
+        stream << "dropped," << i.first << "," << i.second << ",,,," << std::endl;
+
+    return stream.good();
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "limitedqueue.h"
+
+class FrameTrace
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = std::chrono::time_point< Clock >;
+
+    using Stage = std::pair< const char *, TimePoint >;
+
+    FrameTrace();
+
+    static FrameTrace create( const char *stage = "arrival" );
+
+    bool isValid() const;
+
+    uint64_t id() const;
+
+    void mark( const char *stage ) const;
+
+    std::vector< Stage > stages() const;
+
+protected:
+    struct Data
+    {
+        uint64_t id;
+
+        std::vector< Stage > stages;
+        std::mutex mutex;
+    };
+
+    std::shared_ptr< Data > m_data;
+
+    static std::atomic< uint64_t > m_nextId;
+
+};
+
+struct LatencyStatistics
+{
+    std::string sink;
+    std::string stage;
+
+    size_t count;
+
+    // milliseconds
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+class LatencyMonitor
+{
+public:
+    static LatencyMonitor &instance();
+
+    void finish( const FrameTrace &trace, const char *sink );
+
+    void drop( const FrameTrace &trace, const char *stage );
+
+    std::vector< LatencyStatistics > statistics() const;
+    std::map< std::string, size_t > droppedFrames() const;
+
+    size_t samplesCount() const;
+    void setSamplesCount( const size_t value );
+
+    void clear();
+
+    void report() const;
+
+    bool saveCsv( const std::string &fileName ) const;
+
+protected:
+    LatencyMonitor();
+
+    using Key = std::pair< std::string, std::string >;
+
+    std::map< Key, LimitedQueue< int64_t > > m_samples;
+    std::vector< Key > m_order;
+
+    std::map< std::string, uint64_t > m_lastIds;
+    std::map< std::string, size_t > m_droppedFrames;
+
+    size_t m_samplesCount;
+
+    mutable std::mutex m_mutex;
+
+    void addSample( const Key &key, const int64_t value );
+
+private:
+    void initialize();
+
+};
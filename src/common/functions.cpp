@@ -2,6 +2,9 @@
 
 #include "functions.h"
 
+#include "taskscheduler.h"
+#include "defs.h"
+
 #include <opencv2/core/eigen.hpp>
 
 void drawTraceLines( CvImage &image, const unsigned int count )
@@ -62,25 +65,6 @@ CvImage makeStraightPreview( const CvImage &leftPreviewImage, const CvImage &rig
     return stackImages( leftPreviewImage, rightPreviewImage, 1 );
 }
 
-CvImage colorizeDisparity( const cv::Mat &disparity )
-{
-    double min, max;
-
-    cv::minMaxIdx( disparity, &min, &max );
-    double multiplier = 255.0 / (max - min);
-
-    cv::Mat converted;
-
-    disparity.convertTo( converted, CV_8U, multiplier, -min * multiplier );
-
-    cv::Mat colored;
-
-    cv::applyColorMap( converted, colored, cv::COLORMAP_JET );
-
-    return colored;
-
-}
-
 bool drawFeaturePoint( CvImage *target, const cv::Point2f &pt, const int radius, const cv::Scalar &color )
 {
     if ( !target )
@@ -96,9 +80,9 @@ bool drawFeaturePoints( CvImage *target, const std::vector< cv::Point2f > &point
     if ( !target )
         return false;
 
-#pragma omp parallel for
-    for ( size_t i = 0; i < points.size(); ++i )
+    parallelFor( 0, points.size(), [ & ]( const int i ) {
         drawFeaturePoint( target, points[ i ], radius, color );
+    }, TaskScheduler::VISUALIZATION, DRAW_GRAIN_SIZE );
 
     return true;
 
@@ -109,9 +93,9 @@ bool drawFeaturePoints( CvImage *target, const std::vector< cv::KeyPoint > &keyp
     if ( !target )
         return false;
 
-#pragma omp parallel for
-    for ( size_t i = 0; i < keypoints.size(); ++i )
+    parallelFor( 0, keypoints.size(), [ & ]( const int i ) {
         drawFeaturePoint( target, keypoints[ i ].pt, radius, color );
+    }, TaskScheduler::VISUALIZATION, DRAW_GRAIN_SIZE );
 
     return true;
 
@@ -14,8 +14,6 @@ CvImage stackImages( const CvImage &leftImage, const CvImage &rightImage, const
 CvImage makeOverlappedPreview( const CvImage &leftPreviewImage, const CvImage &rightPreviewImage );
 CvImage makeStraightPreview( const CvImage &leftPreviewImage, const CvImage &rightPreviewImage );
 
-CvImage colorizeDisparity( const cv::Mat &disparity );
-
 bool drawFeaturePoint( CvImage *target, const cv::Point2f &pt, const int radius = 3, const cv::Scalar &color = cv::Scalar( 0, 0, 255, 255 ) );
 bool drawFeaturePoints( CvImage *target, const std::vector< cv::Point2f > &points, const int radius = 3, const cv::Scalar &color = cv::Scalar( 0, 0, 255, 255 ) );
 bool drawFeaturePoints( CvImage *target, const std::vector< cv::KeyPoint > &keypoints, const int radius = 3, const cv::Scalar &color = cv::Scalar( 0, 0, 255, 255 ) );
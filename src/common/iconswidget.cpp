@@ -6,18 +6,50 @@
 
 // IconBase
 IconBase::IconBase( const CvImage image, const QString &text )
-    : QListWidgetItem( QPixmap::fromImage( QtImage( image ) ), text ), m_previewImage( image )
+    : QListWidgetItem( text ), m_previewImage( image, thumbnailSize() )
 {
     initialize();
 }
 
 void IconBase::initialize()
 {
+    static std::atomic< unsigned long long > counter( 0 );
+
+    m_pixmapKey = "icon_" + QString::number( counter++ );
+}
+
+unsigned int IconBase::thumbnailSize()
+{
+    return std::max( IconsListWidget::m_iconSize.width(), IconsListWidget::m_iconSize.height() );
+}
+
+const CvImage &IconBase::thumbnailImage() const
+{
+    return m_previewImage.thumbnail();
+}
+
+CvImage IconBase::previewImage() const
+{
+    return m_previewImage.image();
 }
 
-const CvImage &IconBase::previewImage() const
+QVariant IconBase::data( int role ) const
 {
-    return m_previewImage;
+    if ( role == Qt::DecorationRole ) {
+        // Pixmaps are built only for painted items and live in the bounded global pixmap cache
+        QPixmap pixmap;
+
+        if ( !QPixmapCache::find( m_pixmapKey, &pixmap ) ) {
+            pixmap = QPixmap::fromImage( QtImage( thumbnailImage() ) );
+            QPixmapCache::insert( m_pixmapKey, pixmap );
+        }
+
+        return QIcon( pixmap );
+
+    }
+
+    return QListWidgetItem::data( role );
+
 }
 
 // IconsListWidget
@@ -33,6 +65,10 @@ void IconsListWidget::initialize()
 {
     setIconSize( m_iconSize );
     setViewMode( IconMode );
+
+    setUniformItemSizes( true );
+    setLayoutMode( Batched );
+    setBatchSize( m_batchSize );
 }
 
 void IconsListWidget::addIcon( IconBase *icon )
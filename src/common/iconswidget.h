@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "src/common/imagewidget.h"
+#include "src/common/imagecache.h"
 
 class QLabel;
 class QBoxLayout;
@@ -16,10 +17,17 @@ public:
 
     IconBase( const CvImage image, const QString &text );
 
-    const CvImage &previewImage() const;
+    static unsigned int thumbnailSize();
+
+    const CvImage &thumbnailImage() const;
+    CvImage previewImage() const;
+
+    virtual QVariant data( int role ) const override;
 
 protected:
-    CvImage m_previewImage;
+    CachedImage m_previewImage;
+
+    QString m_pixmapKey;
 
 private:
     void initialize();
@@ -30,6 +38,7 @@ class IconsListWidget : public QListWidget
 {
     Q_OBJECT
 
+    friend class IconBase;
     friend class DisparityIcon;
 
 public:
@@ -44,6 +53,7 @@ public:
 
 protected:
     static const QSize m_iconSize;
+    static const int m_batchSize = 50;
 
 private:
     void initialize();
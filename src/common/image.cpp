@@ -197,6 +197,16 @@ const std::chrono::time_point< std::chrono::system_clock > &StampedImageBase::ti
     return m_time;
 }
 
+void StampedImageBase::setTrace( const FrameTrace &trace )
+{
+    m_trace = trace;
+}
+
+const FrameTrace &StampedImageBase::trace() const
+{
+    return m_trace;
+}
+
 // StampedImage
 StampedImage::StampedImage( const std::chrono::time_point<std::chrono::system_clock> &time )
     : StampedImageBase( time )
@@ -280,6 +290,11 @@ int StampedStereoImage::diffMs() const
     return m_leftImage.diffMs( m_rightImage );
 }
 
+const FrameTrace &StampedStereoImage::trace() const
+{
+    return m_leftImage.trace();
+}
+
 bool StampedStereoImage::empty() const
 {
     return m_leftImage.empty() || m_rightImage.empty();
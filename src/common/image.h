@@ -4,6 +4,8 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "frametrace.h"
+
 #include <chrono>
 
 class CvImage;
@@ -69,8 +71,13 @@ public:
     void setTime( const std::chrono::time_point< std::chrono::system_clock > &time );
     const std::chrono::time_point< std::chrono::system_clock > &time() const;
 
+    void setTrace( const FrameTrace &trace );
+    const FrameTrace &trace() const;
+
 protected:
     std::chrono::time_point< std::chrono::system_clock > m_time;
+
+    FrameTrace m_trace;
 };
 
 class StampedImage : public StampedImageBase, public CvImage
@@ -105,6 +112,8 @@ public:
 
     int diffMs() const;
 
+    const FrameTrace &trace() const;
+
     bool empty() const;
 
     operator StereoImage();
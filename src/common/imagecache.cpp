@@ -0,0 +1,175 @@
+#include "precompiled.h"
+
+#include "imagecache.h"
+
+#include "functions.h"
+#include "taskscheduler.h"
+
+static const size_t MIN_SPILLED_PIXELS = 320 * 240;
+
+// ImageCache
+ImageCache::ImageCache()
+    : m_dir( QDir::tempPath() + "/calibration-cache-XXXXXX" ), m_counter( 0 )
+{
+    initialize();
+}
+
+void ImageCache::initialize()
+{
+    m_dir.setAutoRemove( true );
+}
+
+ImageCache &ImageCache::instance()
+{
+    static ImageCache cache;
+
+    return cache;
+}
+
+QString ImageCache::store( const CvImage &image )
+{
+    if ( image.empty() || !m_dir.isValid() )
+        return QString();
+
+    auto fileName = m_dir.filePath( QString::number( m_counter++ ) + ".png" );
+
+    // Fast lossless compression: the cache is written far more often than it is read
+    if ( !cv::imwrite( fileName.toStdString(), image, { cv::IMWRITE_PNG_COMPRESSION, 1 } ) )
+        return QString();
+
+    return fileName;
+
+}
+
+CvImage ImageCache::load( const QString &fileName ) const
+{
+    if ( fileName.isEmpty() )
+        return CvImage();
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if ( fileName != m_lastFileName ) {
+        m_lastImage = cv::imread( fileName.toStdString(), cv::IMREAD_UNCHANGED );
+        m_lastFileName = fileName;
+    }
+
+    // The last image stays cached, callers get their own copy to draw on
+    return m_lastImage.clone();
+
+}
+
+void ImageCache::remove( const QString &fileName )
+{
+    if ( fileName.isEmpty() )
+        return;
+
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        if ( fileName == m_lastFileName ) {
+            m_lastFileName.clear();
+            m_lastImage = CvImage();
+        }
+
+    }
+
+    QFile::remove( fileName );
+
+}
+
+// CachedImage::Entry
+CachedImage::Entry::Entry( const CvImage &image, const unsigned int thumbnailSize )
+    : thumbnail( resizeTo( image, thumbnailSize ) ), size( image.size() ), image( image.clone() )
+{
+}
+
+CachedImage::Entry::~Entry()
+{
+    ImageCache::instance().remove( fileName );
+}
+
+void CachedImage::Entry::spill()
+{
+    CvImage spilledImage;
+
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        spilledImage = image;
+    }
+
+    auto spilledFileName = ImageCache::instance().store( spilledImage );
+
+    // A failed write keeps the image in memory
+    if ( !spilledFileName.isEmpty() ) {
+        std::lock_guard< std::mutex > lock( mutex );
+
+        fileName = spilledFileName;
+        image = CvImage();
+
+    }
+
+}
+
+// CachedImage
+const CvImage CachedImage::m_emptyImage;
+const cv::Size CachedImage::m_emptySize;
+
+CachedImage::CachedImage()
+{
+}
+
+CachedImage::CachedImage( const CvImage &image, const unsigned int thumbnailSize )
+{
+    if ( image.empty() )
+        return;
+
+    m_entry = std::make_shared< Entry >( image, thumbnailSize );
+
+    // Small images cost less memory than a file round trip, the rest is written off the calling thread
+    if ( image.total() <= MIN_SPILLED_PIXELS )
+        return;
+
+    std::weak_ptr< Entry > entry = m_entry;
+
+    TaskScheduler::instance().submit( [ entry ] {
+        if ( auto ptr = entry.lock() )
+            ptr->spill();
+    }, TaskScheduler::VISUALIZATION );
+
+}
+
+const CvImage &CachedImage::thumbnail() const
+{
+    return m_entry ? m_entry->thumbnail : m_emptyImage;
+}
+
+CvImage CachedImage::image() const
+{
+    if ( !m_entry )
+        return CvImage();
+
+    QString fileName;
+
+    {
+        std::lock_guard< std::mutex > lock( m_entry->mutex );
+
+        if ( !m_entry->image.empty() )
+            return m_entry->image.clone();
+
+        fileName = m_entry->fileName;
+
+    }
+
+    return ImageCache::instance().load( fileName );
+
+}
+
+const cv::Size &CachedImage::size() const
+{
+    return m_entry ? m_entry->size : m_emptySize;
+}
+
+bool CachedImage::empty() const
+{
+    return !m_entry;
+}
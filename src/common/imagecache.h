@@ -0,0 +1,72 @@
+#pragma once
+
+#include "image.h"
+
+#include <QString>
+#include <QTemporaryDir>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+class ImageCache
+{
+public:
+    static ImageCache &instance();
+
+    QString store( const CvImage &image );
+    CvImage load( const QString &fileName ) const;
+    void remove( const QString &fileName );
+
+protected:
+    ImageCache();
+
+    QTemporaryDir m_dir;
+    std::atomic< unsigned long long > m_counter;
+
+    mutable std::mutex m_mutex;
+    mutable QString m_lastFileName;
+    mutable CvImage m_lastImage;
+
+private:
+    void initialize();
+
+};
+
+class CachedImage
+{
+public:
+    CachedImage();
+    CachedImage( const CvImage &image, const unsigned int thumbnailSize );
+
+    const CvImage &thumbnail() const;
+    CvImage image() const;
+
+    const cv::Size &size() const;
+
+    bool empty() const;
+
+protected:
+    // The full image stays in memory until a background task spills it to the cache
+    class Entry
+    {
+    public:
+        Entry( const CvImage &image, const unsigned int thumbnailSize );
+        ~Entry();
+
+        void spill();
+
+        CvImage thumbnail;
+        cv::Size size;
+
+        mutable std::mutex mutex;
+        CvImage image;
+        QString fileName;
+    };
+
+    std::shared_ptr< Entry > m_entry;
+
+    static const CvImage m_emptyImage;
+    static const cv::Size m_emptySize;
+
+};
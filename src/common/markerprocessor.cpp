@@ -117,6 +117,66 @@ void fit( ArucoMarkerList *list1, ArucoMarkerList *list2 )
     }
 }
 
+// ArucoTrackingState
+ArucoTrackingState::ArucoTrackingState()
+{
+    initialize();
+}
+
+void ArucoTrackingState::initialize()
+{
+    m_markersCount = 0;
+    m_frameCounter = 0;
+}
+
+void ArucoTrackingState::setRegions( const std::vector< cv::Rect > &value )
+{
+    m_regions = value;
+}
+
+const std::vector< cv::Rect > &ArucoTrackingState::regions() const
+{
+    return m_regions;
+}
+
+void ArucoTrackingState::setFrameSize( const cv::Size &value )
+{
+    m_frameSize = value;
+}
+
+const cv::Size &ArucoTrackingState::frameSize() const
+{
+    return m_frameSize;
+}
+
+void ArucoTrackingState::setMarkersCount( const size_t value )
+{
+    m_markersCount = value;
+}
+
+size_t ArucoTrackingState::markersCount() const
+{
+    return m_markersCount;
+}
+
+unsigned int ArucoTrackingState::frameCounter() const
+{
+    return m_frameCounter;
+}
+
+void ArucoTrackingState::incrementFrameCounter()
+{
+    ++m_frameCounter;
+}
+
+void ArucoTrackingState::reset()
+{
+    m_regions.clear();
+    m_frameSize = cv::Size();
+
+    initialize();
+}
+
 // ArucoProcessor
 const double ArucoProcessor::m_intervalMultiplier = 34./177.;
 
@@ -130,6 +190,9 @@ void ArucoProcessor::initialize()
     m_resizeFlag = false;
     m_frameMaximumSize = 500;
 
+    m_trackingMargin = 0.5;
+    m_refreshInterval = 15;
+
     m_dictionary = cv::aruco::getPredefinedDictionary( cv::aruco::DICT_6X6_50 ) ;
     m_parameters = cv::aruco::DetectorParameters::create() ;
 
@@ -167,6 +230,26 @@ double ArucoProcessor::size() const
     return m_size;
 }
 
+void ArucoProcessor::setTrackingMargin( const double value )
+{
+    m_trackingMargin = value;
+}
+
+double ArucoProcessor::trackingMargin() const
+{
+    return m_trackingMargin;
+}
+
+void ArucoProcessor::setRefreshInterval( const unsigned int value )
+{
+    m_refreshInterval = std::max( 1u, value );
+}
+
+unsigned int ArucoProcessor::refreshInterval() const
+{
+    return m_refreshInterval;
+}
+
 bool ArucoProcessor::detectMarkers( const CvImage &image, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const
 {
     if ( markerIds && markerCorners ) {
@@ -183,7 +266,127 @@ bool ArucoProcessor::detectMarkers( const CvImage &image, std::vector< int > *ma
     return false;
 }
 
-bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const
+bool ArucoProcessor::detectMarkers( const CvImage &image, const std::vector< cv::Rect > &regions, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const
+{
+    if ( markerIds && markerCorners ) {
+
+        markerIds->clear();
+        markerCorners->clear();
+
+        std::set< int > foundIds;
+
+        for ( auto &region : regions ) {
+
+            std::vector< int > regionIds;
+            std::vector< std::vector< cv::Point2f > > regionCorners;
+
+            cv::aruco::detectMarkers( image( region ), m_dictionary, regionCorners, regionIds, m_parameters );
+
+            for ( size_t i = 0; i < regionIds.size() && i < regionCorners.size(); ++i ) {
+
+                if ( foundIds.insert( regionIds[ i ] ).second ) {
+
+                    for ( auto &corner : regionCorners[ i ] ) {
+                        corner.x += region.x;
+                        corner.y += region.y;
+                    }
+
+                    markerIds->push_back( regionIds[ i ] );
+                    markerCorners->push_back( regionCorners[ i ] );
+
+                }
+
+            }
+
+        }
+
+        return !markerIds->empty();
+
+    }
+
+    return false;
+}
+
+bool ArucoProcessor::trackMarkers( const CvImage &image, ArucoTrackingState *state, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const
+{
+    if ( !state )
+        return detectMarkers( image, markerIds, markerCorners );
+
+    if ( !markerIds || !markerCorners )
+        return false;
+
+    bool ret = false;
+
+    bool refresh = state->frameSize() != image.size() || state->regions().empty() || state->frameCounter() % m_refreshInterval == 0;
+
+    // Search around the previous detections first, fall back to the full frame if any marker is lost
+    if ( !refresh )
+        ret = detectMarkers( image, state->regions(), markerIds, markerCorners ) && markerIds->size() >= state->markersCount();
+
+    if ( !ret ) {
+        markerIds->clear();
+        markerCorners->clear();
+
+        ret = detectMarkers( image, markerIds, markerCorners );
+
+    }
+
+    state->setFrameSize( image.size() );
+    state->setRegions( ret ? searchRegions( *markerCorners, image.size() ) : std::vector< cv::Rect >() );
+    state->setMarkersCount( ret ? markerIds->size() : 0 );
+    state->incrementFrameCounter();
+
+    return ret;
+
+}
+
+std::vector< cv::Rect > ArucoProcessor::searchRegions( const std::vector< std::vector< cv::Point2f > > &markerCorners, const cv::Size &frameSize ) const
+{
+    std::vector< cv::Rect > ret;
+
+    cv::Rect frameRect( cv::Point(), frameSize );
+
+    for ( auto &corners : markerCorners ) {
+        auto rect = cv::boundingRect( corners );
+
+        int margin = std::max( m_minimumTrackingMargin, static_cast< int >( m_trackingMargin * std::max( rect.width, rect.height ) ) );
+
+        rect -= cv::Point( margin, margin );
+        rect += cv::Size( 2 * margin, 2 * margin );
+
+        rect &= frameRect;
+
+        if ( rect.area() > 0 )
+            ret.push_back( rect );
+
+    }
+
+    // Merge overlapping regions so that neighbouring markers are searched once
+    bool merged = true;
+
+    while ( merged ) {
+        merged = false;
+
+        for ( size_t i = 0; i < ret.size() && !merged; ++i ) {
+            for ( size_t j = i + 1; j < ret.size() && !merged; ++j ) {
+
+                if ( ( ret[ i ] & ret[ j ] ).area() > 0 ) {
+                    ret[ i ] |= ret[ j ];
+                    ret.erase( ret.begin() + j );
+                    merged = true;
+                }
+
+            }
+
+        }
+
+    }
+
+    return ret;
+
+}
+
+bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners, ArucoTrackingState *state ) const
 {
     if ( !frame.empty() ) {
 
@@ -196,7 +399,7 @@ bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, std::vec
         else
             frame.copyTo( sourceFrame );
 
-        auto ret = detectMarkers( sourceFrame, markerIds, markerCorners );
+        auto ret = trackMarkers( sourceFrame, state, markerIds, markerCorners );
 
         if ( view ) {
             *view = sourceFrame;
@@ -214,12 +417,12 @@ bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, std::vec
 
 }
 
-bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, ArucoMarkerList *markers ) const
+bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, ArucoMarkerList *markers, ArucoTrackingState *state ) const
 {
     std::vector< int > markerIds;
     std::vector< std::vector< cv::Point2f > > markerCorners;
 
-    auto ret = processFrame( frame, view, &markerIds, &markerCorners );
+    auto ret = processFrame( frame, view, &markerIds, &markerCorners, state );
 
     if ( ret && markers ) {
         markers->clear();
@@ -234,6 +437,26 @@ bool ArucoProcessor::processFrame( const CvImage &frame, CvImage *view, ArucoMar
 
 }
 
+const cv::Ptr< cv::aruco::Dictionary > &ArucoProcessor::dictionary() const
+{
+    return m_dictionary;
+}
+
+int ArucoProcessor::firstId() const
+{
+    return m_firstId;
+}
+
+int ArucoProcessor::markersInRow() const
+{
+    return m_markersInRow;
+}
+
+double ArucoProcessor::intervalMultiplier() const
+{
+    return m_intervalMultiplier;
+}
+
 std::vector< cv::Point3f > ArucoProcessor::calcCorners( const ArucoMarkerList &list ) const
 {
     std::vector< cv::Point3f > ret;
@@ -43,6 +43,36 @@ protected:
 
 void fit( ArucoMarkerList *list1, ArucoMarkerList *list2 );
 
+class ArucoTrackingState
+{
+public:
+    ArucoTrackingState();
+
+    void setRegions( const std::vector< cv::Rect > &value );
+    const std::vector< cv::Rect > &regions() const;
+
+    void setFrameSize( const cv::Size &value );
+    const cv::Size &frameSize() const;
+
+    void setMarkersCount( const size_t value );
+    size_t markersCount() const;
+
+    unsigned int frameCounter() const;
+    void incrementFrameCounter();
+
+    void reset();
+
+protected:
+    std::vector< cv::Rect > m_regions;
+    cv::Size m_frameSize;
+    size_t m_markersCount;
+    unsigned int m_frameCounter;
+
+private:
+    void initialize();
+
+};
+
 class ArucoProcessor
 {
 public:
@@ -56,12 +86,24 @@ public:
     unsigned int frameMaximumFlag() const;
     double size() const;
 
-    bool processFrame( const CvImage &frame, CvImage *view, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const;
-    bool processFrame( const CvImage &frame, CvImage *view = nullptr, ArucoMarkerList *markers = nullptr ) const;
+    void setTrackingMargin( const double value );
+    double trackingMargin() const;
+
+    void setRefreshInterval( const unsigned int value );
+    unsigned int refreshInterval() const;
+
+    bool processFrame( const CvImage &frame, CvImage *view, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners, ArucoTrackingState *state = nullptr ) const;
+    bool processFrame( const CvImage &frame, CvImage *view = nullptr, ArucoMarkerList *markers = nullptr, ArucoTrackingState *state = nullptr ) const;
 
     std::vector< cv::Point3f > calcCorners( const ArucoMarkerList &list ) const;
     std::vector< cv::Point3f > calcCentroids( const ArucoMarkerList &list ) const;
 
+    const cv::Ptr< cv::aruco::Dictionary > &dictionary() const;
+
+    int firstId() const;
+    int markersInRow() const;
+    double intervalMultiplier() const;
+
 protected:
     cv::Ptr< cv::aruco::Dictionary > m_dictionary ;
     cv::Ptr< cv::aruco::DetectorParameters > m_parameters ;
@@ -75,7 +117,16 @@ protected:
     double m_size;
     static const double m_intervalMultiplier;
 
+    double m_trackingMargin;
+    unsigned int m_refreshInterval;
+
+    static const int m_minimumTrackingMargin = 16;
+
     bool detectMarkers( const CvImage &image, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const ;
+    bool detectMarkers( const CvImage &image, const std::vector< cv::Rect > &regions, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const ;
+    bool trackMarkers( const CvImage &image, ArucoTrackingState *state, std::vector< int > *markerIds, std::vector< std::vector< cv::Point2f > > *markerCorners ) const ;
+
+    std::vector< cv::Rect > searchRegions( const std::vector< std::vector< cv::Point2f > > &markerCorners, const cv::Size &frameSize ) const;
 
 private:
     void initialize();
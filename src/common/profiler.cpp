@@ -0,0 +1,372 @@
+#include "precompiled.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+static const size_t DEFAULT_PROFILER_BUFFER_SIZE = 16384;
+
+static double percentile( const std::vector< int64_t > &sortedValues, const double value )
+{
+    if ( sortedValues.empty() )
+        return 0.;
+
+    auto index = static_cast< size_t >( std::ceil( value * sortedValues.size() ) );
+
+    index = std::min( std::max< size_t >( index, 1 ), sortedValues.size() ) - 1;
+
+    return sortedValues[ index ] * 1.e-6;
+}
+
+static std::string escapeJson( const std::string &value )
+{
+    std::string ret;
+
+    for ( auto c : value ) {
+        if ( c == '"' || c == '\\' )
+            ret.push_back( '\\' );
+
+        ret.push_back( c );
+
+    }
+
+    return ret;
+
+}
+
+// Profiler
+thread_local Profiler::ThreadHandle Profiler::m_threadHandle;
+
+Profiler::ThreadHandle::~ThreadHandle()
+{
+    if ( buffer )
+        buffer->active = false;
+}
+
+Profiler::Profiler()
+{
+    initialize();
+}
+
+void Profiler::initialize()
+{
+    m_startTime = TicToc::Clock::now();
+
+    m_enabled = true;
+    m_bufferSize = DEFAULT_PROFILER_BUFFER_SIZE;
+}
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+
+    return profiler;
+}
+
+bool Profiler::isEnabled() const
+{
+    return m_enabled;
+}
+
+void Profiler::setEnabled( const bool value )
+{
+    m_enabled = value;
+}
+
+size_t Profiler::bufferSize() const
+{
+    return m_bufferSize;
+}
+
+void Profiler::setBufferSize( const size_t value )
+{
+    m_bufferSize = std::max< size_t >( value, 1 );
+}
+
+Profiler::ThreadBuffer *Profiler::threadBuffer()
+{
+    auto &handle = m_threadHandle;
+
+    if ( !handle.buffer ) {
+        std::lock_guard< std::mutex > lock( m_buffersMutex );
+
+        // Buffers of finished threads are reused so short-lived threads do not grow the pool
+        for ( auto &i : m_buffers ) {
+            if ( !i->active && i->events.size() == m_bufferSize ) {
+                handle.buffer = i;
+                break;
+            }
+
+        }
+
+        if ( !handle.buffer ) {
+            auto buffer = std::make_shared< ThreadBuffer >();
+
+            buffer->thread = m_buffers.size();
+            buffer->events.resize( m_bufferSize );
+            buffer->next = 0;
+            buffer->full = false;
+
+            m_buffers.push_back( buffer );
+
+            handle.buffer = buffer;
+
+        }
+
+        handle.buffer->active = true;
+
+    }
+
+    return handle.buffer.get();
+
+}
+
+void Profiler::record( const char *name, const int depth, const TicToc::TimePoint &start, const TicToc::TimePoint &finish )
+{
+    if ( !m_enabled )
+        return;
+
+    auto buffer = threadBuffer();
+
+    std::lock_guard< std::mutex > lock( buffer->mutex );
+
+    auto &event = buffer->events[ buffer->next ];
+
+    event.name = name;
+    event.depth = depth;
+    event.thread = buffer->thread;
+    event.start = std::chrono::duration_cast< std::chrono::nanoseconds >( start - m_startTime ).count();
+    event.duration = std::chrono::duration_cast< std::chrono::nanoseconds >( finish - start ).count();
+
+    buffer->next = ( buffer->next + 1 ) % buffer->events.size();
+
+    if ( buffer->next == 0 )
+        buffer->full = true;
+
+}
+
+std::vector< ProfileEvent > Profiler::events() const
+{
+    std::vector< ProfileEvent > ret;
+
+    std::lock_guard< std::mutex > buffersLock( m_buffersMutex );
+
+    for ( auto &i : m_buffers ) {
+        std::lock_guard< std::mutex > lock( i->mutex );
+
+        if ( i->full )
+            ret.insert( ret.end(), i->events.begin() + i->next, i->events.end() );
+
+        ret.insert( ret.end(), i->events.begin(), i->events.begin() + i->next );
+
+    }
+
+    return ret;
+
+}
+
+std::vector< ProfileStatistics > Profiler::statistics() const
+{
+    auto events = this->events();
+
+    // Zones are recorded when they close, so restore the nesting order before building paths
+    std::stable_sort( events.begin(), events.end(), []( const ProfileEvent &first, const ProfileEvent &second ) {
+        if ( first.thread != second.thread )
+            return first.thread < second.thread;
+
+        if ( first.start != second.start )
+            return first.start < second.start;
+
+        return first.depth < second.depth;
+
+    } );
+
+    std::map< std::string, std::pair< int, std::vector< int64_t > > > zones;
+
+    std::vector< std::string > stack;
+    unsigned int thread = 0;
+
+    for ( auto &i : events ) {
+        if ( i.thread != thread ) {
+            stack.clear();
+            thread = i.thread;
+        }
+
+        stack.resize( std::min< size_t >( stack.size(), std::max( i.depth, 0 ) ) );
+
+        auto path = stack.empty() ? std::string( i.name ) : stack.back() + "/" + i.name;
+
+        auto &zone = zones[ path ];
+        zone.first = i.depth;
+        zone.second.push_back( i.duration );
+
+        stack.push_back( path );
+
+    }
+
+    std::vector< ProfileStatistics > ret;
+
+    for ( auto &i : zones ) {
+        auto &durations = i.second.second;
+
+        std::sort( durations.begin(), durations.end() );
+
+        ProfileStatistics statistics;
+
+        statistics.path = i.first;
+        statistics.depth = i.second.first;
+        statistics.count = durations.size();
+
+        statistics.total = 0.;
+
+        for ( auto &j : durations )
+            statistics.total += j * 1.e-6;
+
+        statistics.mean = statistics.total / statistics.count;
+        statistics.p50 = percentile( durations, 0.50 );
+        statistics.p95 = percentile( durations, 0.95 );
+        statistics.p99 = percentile( durations, 0.99 );
+        statistics.max = durations.back() * 1.e-6;
+
+        ret.push_back( statistics );
+
+    }
+
+    return ret;
+
+}
+
+void Profiler::clear()
+{
+    std::lock_guard< std::mutex > buffersLock( m_buffersMutex );
+
+    for ( auto &i : m_buffers ) {
+        std::lock_guard< std::mutex > lock( i->mutex );
+
+        i->next = 0;
+        i->full = false;
+
+    }
+
+}
+
+void Profiler::report() const
+{
+    auto statistics = this->statistics();
+
+    std::cout << std::left << std::setw( 40 ) << "Zone" << std::right
+              << std::setw( 8 ) << "count" << std::setw( 10 ) << "mean" << std::setw( 10 ) << "p50"
+              << std::setw( 10 ) << "p95" << std::setw( 10 ) << "p99" << std::setw( 10 ) << "max" << std::endl;
+
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    for ( auto &i : statistics ) {
+        auto name = i.path.substr( i.path.find_last_of( '/' ) + 1 );
+
+        std::cout << std::left << std::setw( 40 ) << std::string( 2 * i.depth, ' ' ) + name << std::right
+                  << std::setw( 8 ) << i.count << std::setw( 10 ) << i.mean << std::setw( 10 ) << i.p50
+                  << std::setw( 10 ) << i.p95 << std::setw( 10 ) << i.p99 << std::setw( 10 ) << i.max << std::endl;
+
+    }
+
+    std::cout << std::defaultfloat;
+
+}
+
+bool Profiler::saveCsv( const std::string &fileName ) const
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    stream << "zone,depth,count,total_ms,mean_ms,p50_ms,p95_ms,p99_ms,max_ms" << std::endl;
+
+    for ( auto &i : statistics() )
+        stream << i.path << "," << i.depth << "," << i.count << "," << i.total << "," << i.mean << ","
+               << i.p50 << "," << i.p95 << "," << i.p99 << "," << i.max << std::endl;
+
+    return stream.good();
+
+}
+
+bool Profiler::saveJson( const std::string &fileName ) const
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    auto statistics = this->statistics();
+
+    stream << "{\n  \"zones\": [";
+
+    for ( size_t i = 0; i < statistics.size(); ++i ) {
+        auto &zone = statistics[ i ];
+
+        stream << ( i > 0 ? ",\n" : "\n" ) << "    { \"zone\": \"" << escapeJson( zone.path ) << "\", \"depth\": " << zone.depth
+               << ", \"count\": " << zone.count << ", \"total_ms\": " << zone.total << ", \"mean_ms\": " << zone.mean
+               << ", \"p50_ms\": " << zone.p50 << ", \"p95_ms\": " << zone.p95 << ", \"p99_ms\": " << zone.p99
+               << ", \"max_ms\": " << zone.max << " }";
+
+    }
+
+    stream << "\n  ]\n}" << std::endl;
+
+    return stream.good();
+
+}
+
+bool Profiler::saveChromeTrace( const std::string &fileName ) const
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    auto events = this->events();
+
+    stream << std::fixed << std::setprecision( 3 );
+
+    stream << "{ \"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    for ( size_t i = 0; i < events.size(); ++i ) {
+        auto &event = events[ i ];
+
+        // Chrome trace timestamps are in microseconds
+        stream << ( i > 0 ? ",\n" : "\n" ) << "{ \"name\": \"" << escapeJson( event.name ) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+               << ", \"ts\": " << event.start * 1.e-3 << ", \"dur\": " << event.duration * 1.e-3 << " }";
+
+    }
+
+    stream << "\n] }" << std::endl;
+
+    return stream.good();
+
+}
+
+// ProfileZone
+thread_local int ProfileZone::m_depth = 0;
+
+ProfileZone::ProfileZone( const char *name )
+    : m_name( name ), m_enabled( Profiler::instance().isEnabled() )
+{
+    if ( m_enabled )
+        ++m_depth;
+
+    m_time.tic();
+}
+
+ProfileZone::~ProfileZone()
+{
+    if ( m_enabled ) {
+        --m_depth;
+        Profiler::instance().record( m_name, m_depth, m_time.startTime(), TicToc::Clock::now() );
+    }
+
+}
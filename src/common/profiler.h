@@ -0,0 +1,117 @@
+#pragma once
+
+#include "tictoc.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ProfileEvent
+{
+    const char *name;
+    int depth;
+    unsigned int thread;
+
+    // nanoseconds since the profiler start
+    int64_t start;
+    int64_t duration;
+};
+
+struct ProfileStatistics
+{
+    std::string path;
+    int depth;
+
+    size_t count;
+
+    // milliseconds
+    double total;
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+class Profiler
+{
+public:
+    static Profiler &instance();
+
+    bool isEnabled() const;
+    void setEnabled( const bool value );
+
+    size_t bufferSize() const;
+    void setBufferSize( const size_t value );
+
+    void record( const char *name, const int depth, const TicToc::TimePoint &start, const TicToc::TimePoint &finish );
+
+    std::vector< ProfileEvent > events() const;
+    std::vector< ProfileStatistics > statistics() const;
+
+    void clear();
+
+    void report() const;
+
+    bool saveCsv( const std::string &fileName ) const;
+    bool saveJson( const std::string &fileName ) const;
+    bool saveChromeTrace( const std::string &fileName ) const;
+
+protected:
+    Profiler();
+
+    struct ThreadBuffer
+    {
+        unsigned int thread;
+
+        std::vector< ProfileEvent > events;
+        size_t next;
+        bool full;
+
+        std::atomic< bool > active;
+
+        mutable std::mutex mutex;
+    };
+
+    struct ThreadHandle
+    {
+        std::shared_ptr< ThreadBuffer > buffer;
+
+        ~ThreadHandle();
+    };
+
+    TicToc::TimePoint m_startTime;
+
+    std::atomic< bool > m_enabled;
+    std::atomic< size_t > m_bufferSize;
+
+    std::vector< std::shared_ptr< ThreadBuffer > > m_buffers;
+    mutable std::mutex m_buffersMutex;
+
+    static thread_local ThreadHandle m_threadHandle;
+
+    ThreadBuffer *threadBuffer();
+
+private:
+    void initialize();
+
+};
+
+class ProfileZone
+{
+public:
+    explicit ProfileZone( const char *name );
+    ~ProfileZone();
+
+protected:
+    const char *m_name;
+    bool m_enabled;
+
+    TicToc m_time;
+
+    static thread_local int m_depth;
+
+};
@@ -2,6 +2,9 @@
 
 #include "rectificationprocessor.h"
 
+#include "profiler.h"
+#include "taskscheduler.h"
+
 // RectificationProcessorBase
 RectificationProcessorBase::RectificationProcessorBase()
 {
@@ -145,10 +148,19 @@ void StereoRectificationProcessor::calcRectificationMaps()
 
 bool StereoRectificationProcessor::rectify( const CvImage &leftImage, const CvImage &rightImage, CvImage *leftResult, CvImage *rightResult ) const
 {
-    auto result = rectifyLeft( leftImage, leftResult );
-    result = result && rectifyRight( rightImage, rightResult );
+    ProfileZone zone( "rectification" );
 
-    return result;
+    bool leftOk = false;
+    bool rightOk = false;
+
+    TaskGroup group( TaskScheduler::CAPTURE );
+
+    group.run( [ & ] { leftOk = rectifyLeft( leftImage, leftResult ); } );
+    group.run( [ & ] { rightOk = rectifyRight( rightImage, rightResult ); } );
+
+    group.wait();
+
+    return leftOk && rightOk;
 }
 
 bool StereoRectificationProcessor::crop( const CvImage &leftImage, const CvImage &rightImage, CvImage *leftResult, CvImage *rightResult ) const
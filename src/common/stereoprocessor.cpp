@@ -2,28 +2,173 @@
 
 #include "stereoprocessor.h"
 
+#include "src/common/bpprocessor.h"
+#include "src/common/defs.h"
+#include "src/common/disparityrefinement.h"
 #include "src/common/functions.h"
+#include "src/common/profiler.h"
+#include "src/common/taskscheduler.h"
 
 const float MISSING_Z = 10000.;
 
+static bool hasCudaDevice()
+{
+    static const bool ret = cv::cuda::getCudaEnabledDeviceCount() > 0;
+
+    return ret;
+
+}
+
+// Belief propagation on the CPU with the parameters of a CUDA matcher, constant space BP included
+static cv::Mat processOnCpu( const cv::cuda::StereoBeliefPropagation &matcher, const DisparityPreprocessor &preprocessor,
+                             BPCPUDisparityProcessor *cpuMatcher, const CvImage &left, const CvImage &right )
+{
+    cpuMatcher->preprocessor().copySettings( preprocessor );
+
+    cpuMatcher->setNumDisparities( matcher.getNumDisparities() );
+    cpuMatcher->setNumIterations( matcher.getNumIters() );
+    cpuMatcher->setNumLevels( matcher.getNumLevels() );
+    cpuMatcher->setMaxDataTerm( matcher.getMaxDataTerm() );
+    cpuMatcher->setDataWeight( matcher.getDataWeight() );
+    cpuMatcher->setMaxDiscTerm( matcher.getMaxDiscTerm() );
+    cpuMatcher->setDiscSingleJump( matcher.getDiscSingleJump() );
+
+    return cpuMatcher->processDisparity( left, right );
+
+}
+
+static std::vector< double > beliefPropagationParameters( const cv::cuda::StereoBeliefPropagation &matcher )
+{
+    return { double( matcher.getNumDisparities() ), double( matcher.getNumIters() ), double( matcher.getNumLevels() ),
+             matcher.getMaxDataTerm(), matcher.getDataWeight(), matcher.getMaxDiscTerm(), matcher.getDiscSingleJump(),
+             double( matcher.getMsgType() ) };
+}
+
+// Overlapping regions are replaced by their bounding rect, so no pixel is processed twice
+static std::vector< cv::Rect > mergeRegions( const std::vector< cv::Rect > &regions, const cv::Size &frameSize )
+{
+    cv::Rect frameRect( cv::Point(), frameSize );
+
+    std::vector< cv::Rect > ret;
+
+    for ( auto &i : regions ) {
+        auto region = i & frameRect;
+
+        if ( !region.empty() )
+            ret.push_back( region );
+
+    }
+
+    bool merged = true;
+
+    while ( merged ) {
+        merged = false;
+
+        for ( size_t i = 0; i < ret.size() && !merged; ++i ) {
+
+            for ( size_t j = i + 1; j < ret.size() && !merged; ++j ) {
+
+                if ( !( ret[ i ] & ret[ j ] ).empty() ) {
+                    ret[ i ] |= ret[ j ];
+                    ret.erase( ret.begin() + j );
+
+                    merged = true;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    return ret;
+
+}
+
 // DisparityProcessorBase
 DisparityProcessorBase::DisparityProcessorBase()
 {
 }
 
-CvImage DisparityProcessorBase::preprocess( const CvImage img )
+cv::Range DisparityProcessorBase::disparityRange() const
 {
-    CvImage ret;
+    return cv::Range( 0, 256 );
+}
+
+int DisparityProcessorBase::supportRadius() const
+{
+    // Preprocessing blur
+    return m_preprocessor.getBlurSize() / 2;
+}
+
+std::vector< double > DisparityProcessorBase::parameters() const
+{
+    return std::vector< double >();
+}
+
+cv::Mat DisparityProcessorBase::processRegions( const CvImage &left, const CvImage &right, const std::vector< cv::Rect > &regions )
+{
+    if ( regions.empty() )
+        return processDisparity( left, right );
+
+    cv::Rect frameRect( cv::Point(), left.size() );
+
+    auto range = disparityRange();
+    auto radius = supportRadius();
+
+    // A left pixel x is matched to right pixels from x - range.end + 1 to x - range.start, crops
+    // keep both views aligned so disparities stay the same
+    auto leftMargin = std::max( 0, range.end - 1 ) + radius;
+    auto rightMargin = std::max( 0, -range.start ) + radius;
+
+    // Crops are equalized with the tables of the whole frames, not by their own histograms
+    m_preprocessor.setEqualizationFrames( left, right );
+
+    cv::Mat ret;
+
+    for ( auto &region : mergeRegions( regions, left.size() ) ) {
+        cv::Rect crop( cv::Point( region.x - leftMargin, region.y - radius ), cv::Point( region.br().x + rightMargin, region.br().y + radius ) );
+        crop &= frameRect;
 
-    cv::cvtColor( img,  ret,  cv::COLOR_BGR2GRAY );
+        auto disparity = processDisparity( left( crop ), right( crop ) );
 
-    cv::equalizeHist( ret, ret );
-    cv::GaussianBlur( ret, ret, cv::Size (5,5), 0);
+        if ( disparity.empty() )
+            continue;
+
+        if ( ret.empty() ) {
+            // Fixed point matchers mark invalid pixels below the minimum disparity
+            auto invalidValue = disparity.type() == CV_16S ? ( range.start - 1 ) * cv::StereoMatcher::DISP_SCALE : 0;
+            ret = cv::Mat( left.size(), disparity.type(), cv::Scalar::all( invalidValue ) );
+        }
+
+        disparity( cv::Rect( region.tl() - crop.tl(), region.size() ) ).copyTo( ret( region ) );
+
+    }
+
+    m_preprocessor.setEqualizationFrames( cv::Mat(), cv::Mat() );
 
     return ret;
 
 }
 
+DisparityPreprocessor &DisparityProcessorBase::preprocessor()
+{
+    return m_preprocessor;
+}
+
+const DisparityPreprocessor &DisparityProcessorBase::preprocessor() const
+{
+    return m_preprocessor;
+}
+
+void DisparityProcessorBase::preprocess( const CvImage &left, const CvImage &right, cv::Mat *leftResult, cv::Mat *rightResult )
+{
+    ProfileZone zone( "preprocessing" );
+
+    m_preprocessor.process( left, right, leftResult, rightResult );
+}
+
 // BMDisparityProcessor
 BMDisparityProcessor::BMDisparityProcessor()
     : DisparityProcessorBase()
@@ -168,8 +313,10 @@ void BMDisparityProcessor::setROI2( const cv::Rect &roi2 )
 
 cv::Mat BMDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
 {
-    CvImage leftGray = preprocess( left );
-    CvImage rightGray = preprocess( right );
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
 
     cv::Mat leftDisp;
 
@@ -209,6 +356,29 @@ cv::Mat BMDisparityProcessor::processDisparity( const CvImage &left, const CvIma
 
 }
 
+cv::Range BMDisparityProcessor::disparityRange() const
+{
+    return cv::Range( getMinDisparity(), getMinDisparity() + getNumDisparities() );
+}
+
+int BMDisparityProcessor::supportRadius() const
+{
+    return DisparityProcessorBase::supportRadius() + std::max( getBlockSize(), getPreFilterSize() ) / 2;
+}
+
+std::vector< double > BMDisparityProcessor::parameters() const
+{
+    auto roi1 = getROI1();
+    auto roi2 = getROI2();
+
+    return { double( getMinDisparity() ), double( getNumDisparities() ), double( getBlockSize() ),
+             double( getSpeckleWindowSize() ), double( getSpeckleRange() ), double( getDisp12MaxDiff() ),
+             double( getPreFilterType() ), double( getPreFilterSize() ), double( getPreFilterCap() ),
+             double( getTextureThreshold() ), double( getUniquenessRatio() ),
+             double( roi1.x ), double( roi1.y ), double( roi1.width ), double( roi1.height ),
+             double( roi2.x ), double( roi2.y ), double( roi2.width ), double( roi2.height ) };
+}
+
 // BMGPUDisparityProcessor
 BMGPUDisparityProcessor::BMGPUDisparityProcessor()
     : DisparityProcessorBase()
@@ -219,6 +389,7 @@ BMGPUDisparityProcessor::BMGPUDisparityProcessor()
 void BMGPUDisparityProcessor::initialize()
 {
     m_matcher = cv::cuda::createStereoBM();
+    m_filter = cv::cuda::createDisparityBilateralFilter( m_matcher->getNumDisparities(), 5, 1 );
 }
 
 int BMGPUDisparityProcessor::getNumDisparities() const
@@ -273,8 +444,10 @@ void BMGPUDisparityProcessor::setTextureThreshold( const int textureThreshold )
 
 cv::Mat BMGPUDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
 {
-    cv::Mat leftGray = preprocess( left );
-    cv::Mat rightGray = preprocess( right );
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
 
     cv::cuda::GpuMat leftGPU;
     cv::cuda::GpuMat rightGPU;
@@ -286,8 +459,8 @@ cv::Mat BMGPUDisparityProcessor::processDisparity( const CvImage &left, const Cv
 
     m_matcher->compute( leftGPU, rightGPU, dispGPU );
 
-    cv::Ptr < cv::cuda::DisparityBilateralFilter > dispFilter = cv::cuda::createDisparityBilateralFilter( m_matcher->getNumDisparities(), 5, 1 );
-    dispFilter->apply( dispGPU, leftGPU, dispGPU );
+    m_filter->setNumDisparities( m_matcher->getNumDisparities() );
+    m_filter->apply( dispGPU, leftGPU, dispGPU );
 
     cv::cuda::normalize( dispGPU, dispGPU, 0, 255, cv::NORM_MINMAX, CV_8U );
     cv::Mat res( leftGray.size(), CV_8U );
@@ -304,6 +477,12 @@ cv::Mat BMGPUDisparityProcessor::processDisparity( const CvImage &left, const Cv
 
 }
 
+std::vector< double > BMGPUDisparityProcessor::parameters() const
+{
+    return { double( getNumDisparities() ), double( getBlockSize() ), double( getPreFilterType() ),
+             double( getPreFilterCap() ), double( getTextureThreshold() ) };
+}
+
 // GMDisparityProcessor
 GMDisparityProcessor::GMDisparityProcessor()
     : DisparityProcessorBase()
@@ -428,8 +607,10 @@ void GMDisparityProcessor::setP2(int p2)
 
 cv::Mat GMDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
 {
-    CvImage leftGray = preprocess( left );
-    CvImage rightGray = preprocess( right );
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
 
     cv::Mat leftDisp;
 
@@ -439,6 +620,24 @@ cv::Mat GMDisparityProcessor::processDisparity( const CvImage &left, const CvIma
 
 }
 
+cv::Range GMDisparityProcessor::disparityRange() const
+{
+    return cv::Range( getMinDisparity(), getMinDisparity() + getNumDisparities() );
+}
+
+int GMDisparityProcessor::supportRadius() const
+{
+    // Path aggregation is cut at the crop border, the block radius keeps matching windows whole
+    return DisparityProcessorBase::supportRadius() + getBlockSize() / 2;
+}
+
+std::vector< double > GMDisparityProcessor::parameters() const
+{
+    return { double( getMode() ), double( getMinDisparity() ), double( getNumDisparities() ), double( getBlockSize() ),
+             double( getSpeckleWindowSize() ), double( getSpeckleRange() ), double( getDisp12MaxDiff() ),
+             double( getPreFilterCap() ), double( getUniquenessRatio() ), double( getP1() ), double( getP2() ) };
+}
+
 // BPDisparityProcessor
 BPDisparityProcessor::BPDisparityProcessor()
     : DisparityProcessorBase()
@@ -449,6 +648,7 @@ BPDisparityProcessor::BPDisparityProcessor()
 void BPDisparityProcessor::initialize()
 {
     m_matcher = cv::cuda::createStereoBeliefPropagation();
+    m_cpuMatcher = std::make_shared< BPCPUDisparityProcessor >();
 
     setMsgType( CV_16S );
 }
@@ -535,11 +735,13 @@ void BPDisparityProcessor::setMsgType( const int value )
 
 cv::Mat BPDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
 {
-    CvImage leftGray;
-    CvImage rightGray;
+    if ( !hasCudaDevice() )
+        return processOnCpu( *m_matcher, m_preprocessor, m_cpuMatcher.get(), left, right );
 
-    leftGray = preprocess( left );
-    rightGray = preprocess( right );
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
 
     cv::resize( leftGray, leftGray, cv::Size(), 0.5, 0.5 );
     cv::resize( rightGray, rightGray, cv::Size(), 0.5, 0.5 );
@@ -564,6 +766,11 @@ cv::Mat BPDisparityProcessor::processDisparity( const CvImage &left, const CvIma
 
 }
 
+std::vector< double > BPDisparityProcessor::parameters() const
+{
+    return beliefPropagationParameters( *m_matcher );
+}
+
 // CSBPDisparityProcessor
 CSBPDisparityProcessor::CSBPDisparityProcessor()
     : DisparityProcessorBase()
@@ -574,15 +781,18 @@ CSBPDisparityProcessor::CSBPDisparityProcessor()
 void CSBPDisparityProcessor::initialize()
 {
     m_matcher = cv::cuda::createStereoConstantSpaceBP();
+    m_cpuMatcher = std::make_shared< BPCPUDisparityProcessor >();
 }
 
 cv::Mat CSBPDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
 {
-    CvImage leftGray;
-    CvImage rightGray;
+    if ( !hasCudaDevice() )
+        return processOnCpu( *m_matcher, m_preprocessor, m_cpuMatcher.get(), left, right );
 
-    leftGray = preprocess( left );
-    rightGray = preprocess( right );
+    cv::Mat leftGray;
+    cv::Mat rightGray;
+
+    preprocess( left, right, &leftGray, &rightGray );
 
     cv::cuda::GpuMat leftGPU;
     cv::cuda::GpuMat rightGPU;
@@ -604,6 +814,16 @@ cv::Mat CSBPDisparityProcessor::processDisparity( const CvImage &left, const CvI
 
 }
 
+std::vector< double > CSBPDisparityProcessor::parameters() const
+{
+    auto ret = beliefPropagationParameters( *m_matcher );
+
+    ret.insert( ret.end(), { double( m_matcher->getNrPlane() ), double( m_matcher->getUseLocalInitDataCost() ) } );
+
+    return ret;
+
+}
+
 // StereoProcessorBase
 StereoProcessorBase::StereoProcessorBase()
 {
@@ -624,12 +844,37 @@ void StereoProcessorBase::setDisparityProcessor( const std::shared_ptr< Disparit
     m_disparityProcessor = proc;
 }
 
-cv::Mat StereoProcessorBase::processDisparity( const CvImage &left, const CvImage &right )
+const std::shared_ptr< DisparityRefinement > &StereoProcessorBase::refinement() const
+{
+    return m_refinement;
+}
+
+void StereoProcessorBase::setRefinement( const std::shared_ptr< DisparityRefinement > &value )
+{
+    m_refinement = value;
+}
+
+cv::Mat StereoProcessorBase::processDisparity( const CvImage &left, const CvImage &right, const std::vector< cv::Rect > &regions )
 {
     if ( !m_disparityProcessor )
         return cv::Mat();
 
-    return m_disparityProcessor->processDisparity( left, right );
+    cv::Mat ret;
+
+    {
+        ProfileZone zone( "disparity" );
+
+        ret = m_disparityProcessor->processRegions( left, right, regions );
+    }
+
+    if ( m_refinement ) {
+        ProfileZone zone( "disparity refinement" );
+
+        ret = m_refinement->process( ret, left, right, m_disparityProcessor->disparityRange() );
+    }
+
+    return ret;
+
 }
 
 // StereoProcessor
@@ -645,6 +890,8 @@ StereoProcessor::StereoProcessor( const std::shared_ptr< DisparityProcessorBase
 void StereoProcessor::setDisparityToDepthMatrix( const cv::Mat &mat )
 {
     m_disparityToDepthMatrix = mat;
+
+    updateDepthLut();
 }
 
 const cv::Mat &StereoProcessor::disparityToDepthMatrix() const
@@ -652,15 +899,16 @@ const cv::Mat &StereoProcessor::disparityToDepthMatrix() const
     return m_disparityToDepthMatrix;
 }
 
-pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::processPointCloud( const CvImage &left, const CvImage &right )
+pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::processPointCloud( const CvImage &left, const CvImage &right,
+                                                                             const std::vector< cv::Rect > &regions )
 {
-    auto disparity = processDisparity( left, right );
+    auto disparity = processDisparity( left, right, regions );
 
     if ( !disparity.empty() ) {
-        auto points = reprojectPoints( disparity );
+        auto depth = reprojectDepth( disparity, regions );
 
-        if ( !points.empty() )
-            return producePointCloud( points, left );
+        if ( !depth.empty() )
+            return produceDepthPointCloud( depth, left, regions );
 
     }
 
@@ -668,15 +916,16 @@ pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::processPointCloud( con
 
 }
 
-std::list< ColorPoint3d > StereoProcessor::processPointList( const CvImage &left, const CvImage &right )
+std::list< ColorPoint3d > StereoProcessor::processPointList( const CvImage &left, const CvImage &right,
+                                                             const std::vector< cv::Rect > &regions )
 {
-    auto disparity = processDisparity( left, right );
+    auto disparity = processDisparity( left, right, regions );
 
     if ( !disparity.empty() ) {
-        auto points = reprojectPoints( disparity );
+        auto depth = reprojectDepth( disparity, regions );
 
-        if ( !points.empty() )
-            return producePointList( points, left );
+        if ( !depth.empty() )
+            return produceDepthPointList( depth, left, regions );
 
     }
 
@@ -684,15 +933,83 @@ std::list< ColorPoint3d > StereoProcessor::processPointList( const CvImage &left
 
 }
 
-cv::Mat StereoProcessor::reprojectPoints( const cv::Mat &disparity )
+// Rectified Q has no pixel terms in its Z and W rows, so the depth depends on the disparity only:
+// Z = Q(2,3) / ( Q(3,2) * d + Q(3,3) ), X = ( Q(0,0) * x + Q(0,3) ) * Z / Q(2,3), Y likewise
+void StereoProcessor::updateDepthLut()
+{
+    m_depthLut.clear();
+
+    if ( m_disparityToDepthMatrix.empty() )
+        return;
+
+    cv::Mat_< double > q;
+    m_disparityToDepthMatrix.convertTo( q, CV_64F );
+
+    if ( std::abs( q( 2, 3 ) ) < DOUBLE_EPS )
+        return;
+
+    m_depthCoefficients = cv::Vec4d( q( 0, 0 ), q( 0, 3 ), q( 1, 1 ), q( 1, 3 ) ) / q( 2, 3 );
+
+    // Every non negative CV_16S disparity, zero disparity is infinitely far
+    m_depthLut.resize( std::numeric_limits< int16_t >::max() + 1, 0 );
+
+    for ( size_t i = 1; i < m_depthLut.size(); ++i ) {
+        // Calibration is in meters
+        auto depth = 1000. * q( 2, 3 ) / ( q( 3, 2 ) * i / 16. + q( 3, 3 ) );
+
+        if ( depth >= 0.5 && depth < std::numeric_limits< uint16_t >::max() + 0.5 )
+            m_depthLut[ i ] = static_cast< uint16_t >( depth + 0.5 );
+
+    }
+
+}
+
+cv::Point3f StereoProcessor::depthPoint( const int x, const int y, const uint16_t depth ) const
 {
+    auto z = depth / 1000.;
+
+    return cv::Point3f( ( m_depthCoefficients[ 0 ] * x + m_depthCoefficients[ 1 ] ) * z,
+                        ( m_depthCoefficients[ 2 ] * y + m_depthCoefficients[ 3 ] ) * z, z );
+}
+
+cv::Mat StereoProcessor::reprojectPoints( const cv::Mat &disparity, const std::vector< cv::Rect > &regions )
+{
+    ProfileZone zone( "reprojection" );
+
     cv::Mat points;
 
-    cv::Mat disparity32F;
+    if ( regions.empty() ) {
+        cv::Mat disparity32F;
+
+        disparity.convertTo( disparity32F, CV_32F, 1./16 );
+
+        cv::reprojectImageTo3D( disparity32F, points, m_disparityToDepthMatrix );
+
+        return points;
+
+    }
+
+    // Points outside the regions have zero depth and are skipped as invalid
+    points = cv::Mat( disparity.size(), CV_32FC3, cv::Scalar::all( 0 ) );
+
+    cv::Mat disparityToDepthMatrix;
+    m_disparityToDepthMatrix.convertTo( disparityToDepthMatrix, CV_64F );
+
+    for ( auto &region : mergeRegions( regions, disparity.size() ) ) {
+        cv::Mat disparity32F;
 
-    disparity.convertTo( disparity32F, CV_32F, 1./16 );
+        disparity( region ).convertTo( disparity32F, CV_32F, 1./16 );
 
-    cv::reprojectImageTo3D( disparity32F, points, m_disparityToDepthMatrix );
+        // Region pixel coordinates start from zero, shift them back to the frame
+        cv::Mat shift = cv::Mat::eye( 4, 4, CV_64F );
+        shift.at< double >( 0, 3 ) = region.x;
+        shift.at< double >( 1, 3 ) = region.y;
+
+        cv::Mat regionPoints = points( region );
+
+        cv::reprojectImageTo3D( disparity32F, regionPoints, disparityToDepthMatrix * shift );
+
+    }
 
     return points;
 }
@@ -702,32 +1019,147 @@ bool isValidPoint( const cv::Vec3f& pt )
     return pt[2] != MISSING_Z && pt[2] > 0. && !std::isinf( pt[2] );
 }
 
-pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::producePointCloud( const cv::Mat &points, const CvImage &leftImage )
+static std::vector< cv::Rect > pointRegions( const cv::Mat &points, const std::vector< cv::Rect > &regions )
+{
+    if ( regions.empty() )
+        return std::vector< cv::Rect >( 1, cv::Rect( cv::Point(), points.size() ) );
+
+    return mergeRegions( regions, points.size() );
+}
+
+cv::Mat StereoProcessor::reprojectDepth( const cv::Mat &disparity, const std::vector< cv::Rect > &regions )
+{
+    ProfileZone zone( "depth" );
+
+    if ( m_depthLut.empty() )
+        return cv::Mat();
+
+    cv::Mat fixedDisparity = disparity;
+
+    if ( disparity.type() != CV_16S )
+        disparity.convertTo( fixedDisparity, CV_16S );
+
+    // Pixels outside the regions have zero depth and are skipped as invalid
+    cv::Mat ret = regions.empty() ? cv::Mat( disparity.size(), CV_16U ) : cv::Mat( disparity.size(), CV_16U, cv::Scalar::all( 0 ) );
+
+    auto lut = m_depthLut.data();
+
+    for ( auto &region : pointRegions( ret, regions ) ) {
+
+        parallelFor( region.y, region.br().y, [ & ]( const int y ) {
+            auto src = fixedDisparity.ptr< int16_t >( y );
+            auto dst = ret.ptr< uint16_t >( y );
+
+            for ( int x = region.x; x < region.br().x; ++x )
+                dst[ x ] = lut[ std::max< int16_t >( src[ x ], 0 ) ];
+
+        }, TaskScheduler::TRACKING, 16 );
+
+    }
+
+    return ret;
+
+}
+
+pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::produceDepthPointCloud( const cv::Mat &depth, const CvImage &leftImage,
+                                                                                  const std::vector< cv::Rect > &regions )
+{
+    pcl::PointCloud< pcl::PointXYZRGB >::Ptr pointCloud = pcl::PointCloud< pcl::PointXYZRGB >::Ptr( new pcl::PointCloud< pcl::PointXYZRGB > );
+
+    for ( auto &region : pointRegions( depth, regions ) ) {
+
+        for ( int rows = region.y; rows < region.br().y; ++rows ) {
+
+            auto depthRow = depth.ptr< uint16_t >( rows );
+            auto imageRow = leftImage.ptr< cv::Vec3b >( rows );
+
+            for ( int cols = region.x; cols < region.br().x; ++cols ) {
+
+                if ( depthRow[ cols ] ) {
+                    auto point = depthPoint( cols, rows, depthRow[ cols ] );
+
+                    pcl::PointXYZRGB pclPoint;
+                    pclPoint.x = point.x;
+                    pclPoint.y = point.y;
+                    pclPoint.z = point.z;
+
+                    auto &intensity = imageRow[ cols ];
+                    pclPoint.r = intensity[ 2 ];
+                    pclPoint.g = intensity[ 1 ];
+                    pclPoint.b = intensity[ 0 ];
+                    pointCloud->push_back( pclPoint );
+
+                }
+
+            }
+
+        }
+
+    }
+
+    return pointCloud;
+
+}
+
+std::list< ColorPoint3d > StereoProcessor::produceDepthPointList( const cv::Mat &depth, const CvImage &leftImage,
+                                                                  const std::vector< cv::Rect > &regions )
+{
+    std::list< ColorPoint3d > ret;
+
+    for ( auto &region : pointRegions( depth, regions ) ) {
+
+        for ( int rows = region.y; rows < region.br().y; ++rows ) {
+
+            auto depthRow = depth.ptr< uint16_t >( rows );
+            auto imageRow = leftImage.ptr< cv::Vec3b >( rows );
+
+            for ( int cols = region.x; cols < region.br().x; ++cols ) {
+
+                if ( depthRow[ cols ] ) {
+                    auto &intensity = imageRow[ cols ];
+                    cv::Scalar color( intensity[ 0 ], intensity[ 1 ], intensity[ 2 ], 255 );
+
+                    ret.push_back( ColorPoint3d( depthPoint( cols, rows, depthRow[ cols ] ), color ) );
+
+                }
+
+            }
+
+        }
+
+    }
+
+    return ret;
+
+}
+
+pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::producePointCloud( const cv::Mat &points, const CvImage &leftImage,
+                                                                             const std::vector< cv::Rect > &regions )
 {
     pcl::PointCloud< pcl::PointXYZRGB >::Ptr pointCloud = pcl::PointCloud< pcl::PointXYZRGB >::Ptr( new pcl::PointCloud< pcl::PointXYZRGB > );
 
-    CvImage rgbLeftImage;
+    for ( auto &region : pointRegions( points, regions ) ) {
 
-    cv::cvtColor( leftImage, rgbLeftImage, cv::COLOR_BGR2RGB );
+        for (int rows = region.y; rows < region.br().y; ++rows) {
 
-    for (int rows = 0; rows < points.rows; ++rows) {
+            for (int cols = region.x; cols < region.br().x; ++cols) {
 
-        for (int cols = 0; cols < points.cols; ++cols) {
+                cv::Point3f point = points.at< cv::Point3f >( rows, cols );
 
-            cv::Point3f point = points.at< cv::Point3f >( rows, cols );
+                if ( isValidPoint( point ) ) {
 
-            if ( isValidPoint( point ) ) {
+                    pcl::PointXYZRGB pclPoint;
+                    pclPoint.x = point.x;
+                    pclPoint.y = point.y;
+                    pclPoint.z = point.z;
 
-                pcl::PointXYZRGB pclPoint;
-                pclPoint.x = point.x;
-                pclPoint.y = point.y;
-                pclPoint.z = point.z;
+                    cv::Vec3b intensity = leftImage.at< cv::Vec3b >( rows, cols );
+                    pclPoint.r = intensity[ 2 ];
+                    pclPoint.g = intensity[ 1 ];
+                    pclPoint.b = intensity[ 0 ];
+                    pointCloud->push_back( pclPoint );
 
-                cv::Vec3b intensity = rgbLeftImage.at< cv::Vec3b >( rows, cols );
-                pclPoint.r = intensity[ 0 ];
-                pclPoint.g = intensity[ 1 ];
-                pclPoint.b = intensity[ 2 ];
-                pointCloud->push_back( pclPoint );
+                }
 
             }
 
@@ -739,27 +1171,28 @@ pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoProcessor::producePointCloud( con
 
 }
 
-std::list< ColorPoint3d > StereoProcessor::producePointList( const cv::Mat &points, const CvImage &leftImage )
+std::list< ColorPoint3d > StereoProcessor::producePointList( const cv::Mat &points, const CvImage &leftImage,
+                                                             const std::vector< cv::Rect > &regions )
 {
     std::list< ColorPoint3d > ret;
 
-    CvImage rgbLeftImage;
+    for ( auto &region : pointRegions( points, regions ) ) {
 
-    cv::cvtColor( leftImage, rgbLeftImage, cv::COLOR_BGR2RGB );
+        for (int rows = region.y; rows < region.br().y; ++rows) {
 
-    for (int rows = 0; rows < points.rows; ++rows) {
+            for (int cols = region.x; cols < region.br().x; ++cols) {
 
-        for (int cols = 0; cols < points.cols; ++cols) {
+                cv::Point3f point = points.at< cv::Point3f >( rows, cols );
 
-            cv::Point3f point = points.at< cv::Point3f >( rows, cols );
+                if ( isValidPoint( point ) ) {
 
-            if ( isValidPoint( point ) ) {
+                    cv::Vec3b intensity = leftImage.at< cv::Vec3b >( rows, cols );
+                    cv::Scalar color( intensity[ 0 ], intensity[ 1 ], intensity[ 2 ], 255 );
+                    ColorPoint3d colorPoint( point, color ) ;
 
-                cv::Vec3b intensity = rgbLeftImage.at< cv::Vec3b >( rows, cols );
-                cv::Scalar color( intensity[ 2 ], intensity[ 1 ], intensity[ 0 ], 255 );
-                ColorPoint3d colorPoint( point, color ) ;
+                    ret.push_back( colorPoint );
 
-                ret.push_back( colorPoint );
+                }
 
             }
 
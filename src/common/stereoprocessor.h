@@ -14,8 +14,12 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
+#include "disparitypreprocessor.h"
 #include "rectificationprocessor.h"
 
+class BPCPUDisparityProcessor;
+class DisparityRefinement;
+
 class DisparityProcessorBase
 {
 public:
@@ -23,8 +27,26 @@ public:
 
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) = 0;
 
+    // Disparity inside the regions only, the rest of the frame is invalid. Empty regions mean the whole frame
+    cv::Mat processRegions( const CvImage &left, const CvImage &right, const std::vector< cv::Rect > &regions );
+
+    // Searched disparities and matching support radius, region crops are padded by them
+    virtual cv::Range disparityRange() const;
+    virtual int supportRadius() const;
+
+    // Values of everything the result depends on besides the images, equal values give equal results.
+    // Empty when unknown, such results are never reused
+    virtual std::vector< double > parameters() const;
+
+    // Gray conversion, equalization and blur before matching, used by the processors that need them
+    DisparityPreprocessor &preprocessor();
+    const DisparityPreprocessor &preprocessor() const;
+
 protected:
-    CvImage preprocess( const CvImage img );
+    DisparityPreprocessor m_preprocessor;
+
+    // Results are valid until the next call
+    void preprocess( const CvImage &left, const CvImage &right, cv::Mat *leftResult, cv::Mat *rightResult );
 };
 
 class BMDisparityProcessor : public DisparityProcessorBase
@@ -73,6 +95,10 @@ public:
 
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
 
+    virtual cv::Range disparityRange() const override;
+    virtual int supportRadius() const override;
+    virtual std::vector< double > parameters() const override;
+
 protected:
 //    cv::Ptr< cv::ximgproc::DisparityWLSFilter > m_wlsFilter;
     cv::Ptr< cv::StereoBM > m_leftMatcher;
@@ -104,9 +130,11 @@ public:
     void setTextureThreshold( const int textureThreshold );
 
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
+    virtual std::vector< double > parameters() const override;
 
 protected:
     cv::Ptr< cv::cuda::StereoBM > m_matcher;
+    cv::Ptr< cv::cuda::DisparityBilateralFilter > m_filter;
 
 private:
     void initialize();
@@ -153,6 +181,10 @@ public:
 
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
 
+    virtual cv::Range disparityRange() const override;
+    virtual int supportRadius() const override;
+    virtual std::vector< double > parameters() const override;
+
 protected:
     cv::Ptr< cv::StereoSGBM > m_matcher;
 
@@ -191,10 +223,14 @@ public:
     void setMsgType( const int value );
 
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
+    virtual std::vector< double > parameters() const override;
 
 protected:
     cv::Ptr< cv::cuda::StereoBeliefPropagation > m_matcher;
 
+    // Used with the same parameters when there is no CUDA device
+    std::shared_ptr< BPCPUDisparityProcessor > m_cpuMatcher;
+
 private:
     void initialize();
 
@@ -206,10 +242,13 @@ public:
     CSBPDisparityProcessor();
 
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
+    virtual std::vector< double > parameters() const override;
 
 protected:
     cv::Ptr< cv::cuda::StereoConstantSpaceBP > m_matcher;
 
+    std::shared_ptr< BPCPUDisparityProcessor > m_cpuMatcher;
+
 private:
     void initialize();
 
@@ -224,10 +263,15 @@ public:
     const std::shared_ptr< DisparityProcessorBase > &disparityProcessor() const;
     void setDisparityProcessor( const std::shared_ptr< DisparityProcessorBase > &proc );
 
-    cv::Mat processDisparity( const CvImage &left, const CvImage &right );
+    // Applied to the disparity of any processor, none by default
+    const std::shared_ptr< DisparityRefinement > &refinement() const;
+    void setRefinement( const std::shared_ptr< DisparityRefinement > &value );
+
+    cv::Mat processDisparity( const CvImage &left, const CvImage &right, const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
 
 protected:
     std::shared_ptr< DisparityProcessorBase > m_disparityProcessor;
+    std::shared_ptr< DisparityRefinement > m_refinement;
 
 };
 
@@ -240,15 +284,36 @@ public:
     void setDisparityToDepthMatrix( const cv::Mat & mat );
     const cv::Mat &disparityToDepthMatrix() const;
 
-    pcl::PointCloud< pcl::PointXYZRGB >::Ptr processPointCloud( const CvImage &left, const CvImage &right );
-    std::list< ColorPoint3d > processPointList( const CvImage &left, const CvImage &right );
+    // Empty regions mean the whole frame
+    pcl::PointCloud< pcl::PointXYZRGB >::Ptr processPointCloud( const CvImage &left, const CvImage &right,
+                                                                const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+    std::list< ColorPoint3d > processPointList( const CvImage &left, const CvImage &right,
+                                                const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+
+    // Point of a depth image pixel, X and Y are recovered only for the pixels that need them
+    cv::Point3f depthPoint( const int x, const int y, const uint16_t depth ) const;
 
 protected:
     cv::Mat m_disparityToDepthMatrix;
 
-    cv::Mat reprojectPoints( const cv::Mat &disparity );
-    pcl::PointCloud< pcl::PointXYZRGB >::Ptr producePointCloud( const cv::Mat &points, const CvImage &leftImage );
-    std::list< ColorPoint3d > producePointList( const cv::Mat &points, const CvImage &leftImage );
+    // Millimeters by fixed point disparity, and X, Y coefficients of the depth in meters
+    std::vector< uint16_t > m_depthLut;
+    cv::Vec4d m_depthCoefficients;
+
+    void updateDepthLut();
+
+    // CV_16U depth in millimeters, 0 where the disparity is invalid or the point is farther than the 16 bit range
+    cv::Mat reprojectDepth( const cv::Mat &disparity, const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+    pcl::PointCloud< pcl::PointXYZRGB >::Ptr produceDepthPointCloud( const cv::Mat &depth, const CvImage &leftImage,
+                                                                     const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+    std::list< ColorPoint3d > produceDepthPointList( const cv::Mat &depth, const CvImage &leftImage,
+                                                     const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+
+    cv::Mat reprojectPoints( const cv::Mat &disparity, const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+    pcl::PointCloud< pcl::PointXYZRGB >::Ptr producePointCloud( const cv::Mat &points, const CvImage &leftImage,
+                                                                const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
+    std::list< ColorPoint3d > producePointList( const cv::Mat &points, const CvImage &leftImage,
+                                                const std::vector< cv::Rect > &regions = std::vector< cv::Rect >() );
 
 };
 
@@ -0,0 +1,655 @@
+#include "precompiled.h"
+
+#include "syntheticdata.h"
+
+#include "defs.h"
+#include "taskscheduler.h"
+
+static const int MAX_TEXTURE_SIZE = 4096;
+
+static cv::Matx33d toMatx33d( const cv::Mat &mat )
+{
+    cv::Mat_< double > ret;
+    mat.convertTo( ret, CV_64F );
+
+    return cv::Matx33d( ret.ptr< double >() );
+}
+
+static cv::Vec3d toVec3d( const cv::Mat &mat )
+{
+    cv::Mat_< double > ret;
+    mat.convertTo( ret, CV_64F );
+
+    return cv::Vec3d( ret.ptr< double >() );
+}
+
+static cv::Size textureSize( const cv::Size &frameSize, const double multiplier )
+{
+    auto scale = std::min( multiplier, static_cast< double >( MAX_TEXTURE_SIZE ) / std::max( frameSize.width, frameSize.height ) );
+
+    return cv::Size( cvRound( frameSize.width * scale ), cvRound( frameSize.height * scale ) );
+}
+
+static cv::Vec3b sampleTexture( const cv::Mat &texture, const double x, const double y )
+{
+    auto x0 = static_cast< int >( std::floor( x ) );
+    auto y0 = static_cast< int >( std::floor( y ) );
+
+    auto fx = x - x0;
+    auto fy = y - y0;
+
+    auto pixel = [ &texture ]( const int col, const int row ) {
+        return cv::Vec3d( texture.at< cv::Vec3b >( std::min( std::max( row, 0 ), texture.rows - 1 ), std::min( std::max( col, 0 ), texture.cols - 1 ) ) );
+    };
+
+    cv::Vec3d value = ( 1. - fy ) * ( ( 1. - fx ) * pixel( x0, y0 ) + fx * pixel( x0 + 1, y0 ) )
+                        + fy * ( ( 1. - fx ) * pixel( x0, y0 + 1 ) + fx * pixel( x0 + 1, y0 + 1 ) );
+
+    return cv::Vec3b( cv::saturate_cast< uchar >( value[ 0 ] ), cv::saturate_cast< uchar >( value[ 1 ] ), cv::saturate_cast< uchar >( value[ 2 ] ) );
+
+}
+
+StereoCalibrationDataShort syntheticStereoCalibration( const cv::Size &frameSize, const double baseline, const double distortion )
+{
+    StereoCalibrationDataShort ret;
+
+    auto focal = 0.8 * frameSize.width;
+
+    cv::Mat cameraMatrix = ( cv::Mat_< double >( 3, 3 ) << focal, 0., 0.5 * ( frameSize.width - 1 ),
+                                                            0., focal, 0.5 * ( frameSize.height - 1 ),
+                                                            0., 0., 1. );
+
+    cv::Mat distortionCoefficients = ( cv::Mat_< double >( 1, 5 ) << distortion, 0., 0., 0., 0. );
+
+    cv::Mat rotationMatrix = cv::Mat::eye( 3, 3, CV_64F );
+    cv::Mat translationVector = ( cv::Mat_< double >( 3, 1 ) << -baseline, 0., 0. );
+
+    cv::Mat translationCross = ( cv::Mat_< double >( 3, 3 ) << 0., 0., 0.,
+                                                                0., 0., baseline,
+                                                                0., -baseline, 0. );
+
+    cv::Mat essentialMatrix = translationCross * rotationMatrix;
+    cv::Mat fundamentalMatrix = cameraMatrix.inv().t() * essentialMatrix * cameraMatrix.inv();
+
+    cv::Mat leftRectifyMatrix, rightRectifyMatrix, leftProjectionMatrix, rightProjectionMatrix, disparityToDepthMatrix;
+    cv::Rect leftROI, rightROI;
+
+    cv::stereoRectify( cameraMatrix, distortionCoefficients, cameraMatrix, distortionCoefficients, frameSize, rotationMatrix, translationVector,
+                       leftRectifyMatrix, rightRectifyMatrix, leftProjectionMatrix, rightProjectionMatrix, disparityToDepthMatrix,
+                       cv::CALIB_ZERO_DISPARITY, 0, frameSize, &leftROI, &rightROI );
+
+    MonocularCalibrationDataShort cameraResults;
+
+    cameraResults.setFrameSize( frameSize );
+    cameraResults.setCameraMatrix( cameraMatrix );
+    cameraResults.setDistortionCoefficients( distortionCoefficients );
+    cameraResults.setError( 0. );
+    cameraResults.setOk( true );
+
+    ret.setLeftCameraResults( cameraResults );
+    ret.setRightCameraResults( cameraResults );
+
+    ret.setRotationMatrix( rotationMatrix );
+    ret.setTranslationVector( translationVector );
+    ret.setFundamentalMatrix( fundamentalMatrix );
+    ret.setEssentialMatrix( essentialMatrix );
+
+    ret.setLeftRectifyMatrix( leftRectifyMatrix );
+    ret.setRightRectifyMatrix( rightRectifyMatrix );
+    ret.setLeftProjectionMatrix( leftProjectionMatrix );
+    ret.setRightProjectionMatrix( rightProjectionMatrix );
+
+    ret.setLeftROI( leftROI );
+    ret.setRightROI( rightROI );
+
+    ret.setError( 0. );
+    ret.setOk( true );
+
+    return ret;
+
+}
+
+CvImage syntheticTexture( const cv::Size &size, const unsigned int seed )
+{
+    cv::RNG rng( seed );
+
+    // Coarse blobs give trackable corners, fine noise gives matching texture
+    cv::Mat coarse( std::max( 1, size.height / 8 ), std::max( 1, size.width / 8 ), CV_8UC3 );
+    rng.fill( coarse, cv::RNG::UNIFORM, 0, 256 );
+
+    cv::Mat fine( size, CV_8UC3 );
+    rng.fill( fine, cv::RNG::UNIFORM, 0, 256 );
+
+    cv::Mat ret;
+    cv::resize( coarse, ret, size, 0, 0, cv::INTER_CUBIC );
+
+    cv::addWeighted( ret, 0.75, fine, 0.25, 0., ret );
+
+    return ret;
+
+}
+
+StampedStereoImage syntheticStereoPair( const CvImage &texture, const cv::Rect &view, const int disparity )
+{
+    auto rightView = view + cv::Point( disparity, 0 );
+    auto bounds = cv::Rect( cv::Point(), texture.size() );
+
+    if ( ( view & bounds ) != view || ( rightView & bounds ) != rightView )
+        return StampedStereoImage();
+
+    auto time = std::chrono::system_clock::now();
+
+    // A point at column x in the left view is seen at x - disparity in the right one
+    StampedImage leftImage( time, CvImage( texture( view ).clone() ) );
+    StampedImage rightImage( time, CvImage( texture( rightView ).clone() ) );
+
+    return StampedStereoImage( leftImage, rightImage );
+
+}
+
+// SyntheticBoard
+cv::Vec3d SyntheticBoard::center() const
+{
+    return origin + uAxis * ( 0.5 * size.width ) + vAxis * ( 0.5 * size.height );
+}
+
+cv::Matx33d SyntheticBoard::facingRotation() const
+{
+    auto normal = uAxis.cross( vAxis );
+
+    // Texture columns go to the image right, rows go down and the board faces the camera
+    return cv::Matx33d( uAxis[ 0 ], uAxis[ 1 ], uAxis[ 2 ],
+                        vAxis[ 0 ], vAxis[ 1 ], vAxis[ 2 ],
+                        normal[ 0 ], normal[ 1 ], normal[ 2 ] );
+}
+
+SyntheticBoard syntheticCheckerboard( const cv::Size &count, const double size, const int squarePixels )
+{
+    SyntheticBoard ret;
+
+    // Inner corners are counted, so there is one more square in each direction, plus a white square margin
+    cv::Size squares( count.width + 1, count.height + 1 );
+
+    ret.texture = CvImage( cv::Size( ( squares.width + 2 ) * squarePixels, ( squares.height + 2 ) * squarePixels ), CV_8UC3, cv::Scalar::all( 255 ) );
+
+    for ( int i = 0; i < squares.height; ++i )
+        for ( int j = 0; j < squares.width; ++j )
+            if ( ( i + j ) % 2 == 0 )
+                cv::rectangle( ret.texture, cv::Rect( ( j + 1 ) * squarePixels, ( i + 1 ) * squarePixels, squarePixels, squarePixels ), cv::Scalar::all( 0 ), cv::FILLED );
+
+    ret.origin = cv::Vec3d( -2. * size, -2. * size, 0. );
+    ret.uAxis = cv::Vec3d( 1., 0., 0. );
+    ret.vAxis = cv::Vec3d( 0., 1., 0. );
+    ret.size = cv::Size2d( ( squares.width + 2 ) * size, ( squares.height + 2 ) * size );
+
+    return ret;
+
+}
+
+SyntheticBoard syntheticCircleGrid( const cv::Size &count, const double size, const bool asymmetric, const int spacingPixels )
+{
+    SyntheticBoard ret;
+
+    const int shift = 4;
+    const double radius = 0.3 * spacingPixels;
+
+    auto columns = asymmetric ? 2 * count.width : count.width;
+
+    ret.texture = CvImage( cv::Size( ( columns + 1 ) * spacingPixels, ( count.height + 1 ) * spacingPixels ), CV_8UC3, cv::Scalar::all( 255 ) );
+
+    for ( int i = 0; i < count.height; ++i )
+        for ( int j = 0; j < count.width; ++j ) {
+            auto column = asymmetric ? 2 * j + i % 2 : j;
+
+            // Same layout as TemplateProcessor::calcCorners, shifted by the one spacing margin
+            cv::Point2d center( ( column + 1 ) * spacingPixels - 0.5, ( i + 1 ) * spacingPixels - 0.5 );
+
+            cv::circle( ret.texture, cv::Point( cvRound( center.x * ( 1 << shift ) ), cvRound( center.y * ( 1 << shift ) ) ), cvRound( radius * ( 1 << shift ) ),
+                            cv::Scalar::all( 0 ), cv::FILLED, cv::LINE_AA, shift );
+
+        }
+
+    ret.origin = cv::Vec3d( -size, -size, 0. );
+    ret.uAxis = cv::Vec3d( 1., 0., 0. );
+    ret.vAxis = cv::Vec3d( 0., 1., 0. );
+    ret.size = cv::Size2d( ( columns + 1 ) * size, ( count.height + 1 ) * size );
+
+    return ret;
+
+}
+
+SyntheticBoard syntheticArucoBoard( const ArucoProcessor &processor, const int rowsCount )
+{
+    SyntheticBoard ret;
+
+    // 177 pixel markers make the marker interval a whole number of pixels
+    const int markerPixels = 177;
+
+    auto intervalPixels = cvRound( markerPixels * processor.intervalMultiplier() );
+    auto stepPixels = markerPixels + intervalPixels;
+    auto columns = processor.markersInRow();
+
+    auto pixelsPerUnit = markerPixels / processor.size();
+
+    ret.texture = CvImage( cv::Size( ( columns - 1 ) * stepPixels + markerPixels + 2 * intervalPixels, ( rowsCount - 1 ) * stepPixels + markerPixels + 2 * intervalPixels ),
+                                CV_8UC3, cv::Scalar::all( 255 ) );
+
+    for ( int i = 0; i < rowsCount; ++i )
+        for ( int j = 0; j < columns; ++j ) {
+            cv::Mat marker;
+            cv::aruco::drawMarker( processor.dictionary(), processor.firstId() + i * columns + j, markerPixels, marker, 1 );
+            cv::cvtColor( marker, marker, cv::COLOR_GRAY2BGR );
+
+            marker.copyTo( ret.texture( cv::Rect( intervalPixels + j * stepPixels, intervalPixels + i * stepPixels, markerPixels, markerPixels ) ) );
+
+        }
+
+    auto margin = intervalPixels / pixelsPerUnit;
+
+    // Marker rows run along board X and columns along board Y, as in ArucoProcessor::calcCorners
+    ret.origin = cv::Vec3d( -margin, -margin, 0. );
+    ret.uAxis = cv::Vec3d( 0., 1., 0. );
+    ret.vAxis = cv::Vec3d( 1., 0., 0. );
+    ret.size = cv::Size2d( ret.texture.cols / pixelsPerUnit, ret.texture.rows / pixelsPerUnit );
+
+    return ret;
+
+}
+
+std::vector< SyntheticPose > syntheticBoardPoses( const SyntheticBoard &board, const size_t count, const double distance, const double maxAngle, const unsigned int seed )
+{
+    std::vector< SyntheticPose > ret;
+
+    cv::RNG rng( seed );
+
+    auto facingRotation = board.facingRotation();
+    auto center = board.center();
+
+    for ( size_t i = 0; i < count; ++i ) {
+        cv::Vec3d axis( rng.uniform( -1., 1. ), rng.uniform( -1., 1. ), rng.uniform( -0.3, 0.3 ) );
+
+        auto angle = rng.uniform( 0., maxAngle ) * CV_PI / 180.;
+
+        cv::Matx33d tilt;
+        cv::Rodrigues( cv::normalize( axis ) * angle, tilt );
+
+        cv::Vec3d target( rng.uniform( -0.15, 0.15 ) * distance, rng.uniform( -0.1, 0.1 ) * distance, rng.uniform( 0.8, 1.2 ) * distance );
+
+        SyntheticPose pose;
+
+        pose.rotation = tilt * facingRotation;
+        pose.translation = target - pose.rotation * center;
+
+        ret.push_back( pose );
+
+    }
+
+    return ret;
+
+}
+
+// SyntheticSurface
+SyntheticSurface::SyntheticSurface( const CvImage &texture, const cv::Vec3d &origin, const cv::Vec3d &uAxis, const cv::Vec3d &vAxis, const cv::Size2d &size )
+    : m_texture( texture ), m_origin( origin ), m_uAxis( cv::normalize( uAxis ) ), m_vAxis( cv::normalize( vAxis ) ), m_size( size )
+{
+    initialize();
+}
+
+void SyntheticSurface::initialize()
+{
+    m_normal = cv::normalize( m_uAxis.cross( m_vAxis ) );
+}
+
+bool SyntheticSurface::intersect( const cv::Vec3d &origin, const cv::Vec3d &direction, double *distance, cv::Vec3b *color ) const
+{
+    auto denominator = direction.dot( m_normal );
+
+    if ( std::abs( denominator ) < DOUBLE_EPS )
+        return false;
+
+    auto parameter = ( m_origin - origin ).dot( m_normal ) / denominator;
+
+    if ( parameter <= 0. )
+        return false;
+
+    cv::Vec3d offset = origin + parameter * direction - m_origin;
+
+    auto u = offset.dot( m_uAxis );
+    auto v = offset.dot( m_vAxis );
+
+    if ( u < 0. || v < 0. || u > m_size.width || v > m_size.height )
+        return false;
+
+    *distance = parameter;
+    *color = sampleTexture( m_texture, u / m_size.width * m_texture.cols - 0.5, v / m_size.height * m_texture.rows - 0.5 );
+
+    return true;
+
+}
+
+// SyntheticScene
+SyntheticScene::SyntheticScene()
+{
+    initialize();
+}
+
+void SyntheticScene::initialize()
+{
+    m_background = cv::Vec3b( 128, 128, 128 );
+}
+
+void SyntheticScene::setBackground( const cv::Vec3b &value )
+{
+    m_background = value;
+}
+
+const cv::Vec3b &SyntheticScene::background() const
+{
+    return m_background;
+}
+
+void SyntheticScene::addSurface( const SyntheticSurface &surface )
+{
+    m_surfaces.push_back( surface );
+}
+
+void SyntheticScene::addPlane( const CvImage &texture, const cv::Vec3d &center, const cv::Matx33d &rotation, const cv::Size2d &size )
+{
+    auto origin = center - rotation * cv::Vec3d( 0.5 * size.width, 0.5 * size.height, 0. );
+
+    addSurface( SyntheticSurface( texture, origin, rotation * cv::Vec3d( 1., 0., 0. ), rotation * cv::Vec3d( 0., 1., 0. ), size ) );
+}
+
+void SyntheticScene::addBox( const CvImage &texture, const cv::Vec3d &center, const cv::Matx33d &rotation, const cv::Vec3d &size )
+{
+    cv::Vec3d half = size * 0.5;
+
+    auto xAxis = rotation * cv::Vec3d( 1., 0., 0. );
+    auto yAxis = rotation * cv::Vec3d( 0., 1., 0. );
+    auto zAxis = rotation * cv::Vec3d( 0., 0., 1. );
+
+    auto corner = [ & ]( const double x, const double y, const double z ) {
+        return center + rotation * cv::Vec3d( x, y, z );
+    };
+
+    for ( auto sign : { -1., 1. } ) {
+        addSurface( SyntheticSurface( texture, corner( sign * half[ 0 ], -half[ 1 ], -half[ 2 ] ), yAxis, zAxis, cv::Size2d( size[ 1 ], size[ 2 ] ) ) );
+        addSurface( SyntheticSurface( texture, corner( -half[ 0 ], sign * half[ 1 ], -half[ 2 ] ), xAxis, zAxis, cv::Size2d( size[ 0 ], size[ 2 ] ) ) );
+        addSurface( SyntheticSurface( texture, corner( -half[ 0 ], -half[ 1 ], sign * half[ 2 ] ), xAxis, yAxis, cv::Size2d( size[ 0 ], size[ 1 ] ) ) );
+
+    }
+
+}
+
+void SyntheticScene::addBoard( const SyntheticBoard &board, const SyntheticPose &pose )
+{
+    addSurface( SyntheticSurface( board.texture, pose.rotation * board.origin + pose.translation, pose.rotation * board.uAxis, pose.rotation * board.vAxis, board.size ) );
+}
+
+const std::vector< SyntheticSurface > &SyntheticScene::surfaces() const
+{
+    return m_surfaces;
+}
+
+bool SyntheticScene::trace( const cv::Vec3d &origin, const cv::Vec3d &direction, cv::Vec3d *point, cv::Vec3b *color ) const
+{
+    bool ret = false;
+
+    double nearest = std::numeric_limits< double >::max();
+
+    for ( auto &i : m_surfaces ) {
+        double distance;
+        cv::Vec3b surfaceColor;
+
+        if ( i.intersect( origin, direction, &distance, &surfaceColor ) && distance < nearest ) {
+            nearest = distance;
+            *color = surfaceColor;
+            ret = true;
+        }
+
+    }
+
+    if ( ret )
+        *point = origin + nearest * direction;
+
+    return ret;
+
+}
+
+// Depths are chosen by disparity, so every calibration gets a similar disparity range
+SyntheticScene syntheticPlaneScene( const StereoCalibrationDataShort &calibration, const unsigned int seed )
+{
+    SyntheticScene ret;
+
+    cv::RNG rng( seed );
+
+    auto frameSize = calibration.leftCameraResults().frameSize();
+    auto focal = calibration.leftCameraResults().fx();
+    auto baseline = cv::norm( calibration.translationVector() );
+
+    auto depth = focal * baseline / 32.;
+
+    cv::Matx33d rotation;
+    cv::Rodrigues( cv::Vec3d( rng.uniform( -0.2, 0.2 ), rng.uniform( -0.4, 0.4 ), 0. ), rotation );
+
+    cv::Size2d size( 3. * depth * frameSize.width / focal, 3. * depth * frameSize.height / focal );
+
+    ret.addPlane( syntheticTexture( textureSize( frameSize, 3. ), seed ), cv::Vec3d( 0., 0., depth ), rotation, size );
+
+    return ret;
+
+}
+
+SyntheticScene syntheticBoxScene( const StereoCalibrationDataShort &calibration, const int boxesCount, const unsigned int seed )
+{
+    SyntheticScene ret;
+
+    cv::RNG rng( seed );
+
+    auto frameSize = calibration.leftCameraResults().frameSize();
+    auto focal = calibration.leftCameraResults().fx();
+    auto baseline = cv::norm( calibration.translationVector() );
+
+    auto backgroundDepth = focal * baseline / 16.;
+
+    cv::Size2d backgroundSize( 3. * backgroundDepth * frameSize.width / focal, 3. * backgroundDepth * frameSize.height / focal );
+
+    ret.addPlane( syntheticTexture( textureSize( frameSize, 3. ), seed ), cv::Vec3d( 0., 0., backgroundDepth ), cv::Matx33d::eye(), backgroundSize );
+
+    for ( int i = 0; i < boxesCount; ++i ) {
+        auto depth = focal * baseline / rng.uniform( 24., 64. );
+
+        auto viewWidth = depth * frameSize.width / focal;
+        auto viewHeight = depth * frameSize.height / focal;
+
+        auto side = rng.uniform( 0.15, 0.3 ) * viewWidth;
+
+        cv::Vec3d center( rng.uniform( -0.3, 0.3 ) * viewWidth, rng.uniform( -0.3, 0.3 ) * viewHeight, depth + 0.5 * side );
+
+        cv::Matx33d rotation;
+        cv::Rodrigues( cv::Vec3d( rng.uniform( -0.6, 0.6 ), rng.uniform( -0.6, 0.6 ), rng.uniform( -0.6, 0.6 ) ), rotation );
+
+        ret.addBox( syntheticTexture( cv::Size( 256, 256 ), seed + i + 1 ), center, rotation, cv::Vec3d( side, rng.uniform( 0.6, 1.4 ) * side, side ) );
+
+    }
+
+    return ret;
+
+}
+
+// SyntheticStereoRenderer
+SyntheticStereoRenderer::SyntheticStereoRenderer( const StereoCalibrationDataShort &calibration )
+    : m_calibration( calibration )
+{
+    initialize();
+}
+
+void SyntheticStereoRenderer::initialize()
+{
+    m_rectified = true;
+    m_samplesCount = 2;
+}
+
+void SyntheticStereoRenderer::setRectified( const bool value )
+{
+    m_rectified = value;
+}
+
+bool SyntheticStereoRenderer::rectified() const
+{
+    return m_rectified;
+}
+
+void SyntheticStereoRenderer::setSamplesCount( const int value )
+{
+    m_samplesCount = std::max( 1, value );
+}
+
+int SyntheticStereoRenderer::samplesCount() const
+{
+    return m_samplesCount;
+}
+
+const StereoCalibrationDataShort &SyntheticStereoRenderer::calibration() const
+{
+    return m_calibration;
+}
+
+SyntheticStereoFrame SyntheticStereoRenderer::render( const SyntheticScene &scene ) const
+{
+    SyntheticStereoFrame ret;
+
+    ret.leftImage = renderView( scene, leftView(), &ret.depth, m_rectified ? &ret.disparity : nullptr );
+    ret.rightImage = renderView( scene, rightView() );
+
+    return ret;
+
+}
+
+SyntheticStereoRenderer::View SyntheticStereoRenderer::leftView() const
+{
+    View ret;
+
+    if ( m_rectified ) {
+        ret.cameraMatrix = toMatx33d( m_calibration.leftProjectionMatrix().cameraMatrix() );
+        ret.rotation = toMatx33d( m_calibration.leftRectifyMatrix() ).t();
+    }
+    else {
+        ret.cameraMatrix = toMatx33d( m_calibration.leftCameraResults().cameraMatrix() );
+        ret.distortion = m_calibration.leftCameraResults().distortionCoefficients();
+        ret.rotation = cv::Matx33d::eye();
+    }
+
+    ret.center = cv::Vec3d( 0., 0., 0. );
+
+    return ret;
+
+}
+
+SyntheticStereoRenderer::View SyntheticStereoRenderer::rightView() const
+{
+    View ret;
+
+    auto rotation = toMatx33d( m_calibration.rotationMatrix() );
+    auto translation = toVec3d( m_calibration.translationVector() );
+
+    if ( m_rectified ) {
+        ret.cameraMatrix = toMatx33d( m_calibration.rightProjectionMatrix().cameraMatrix() );
+        ret.rotation = rotation.t() * toMatx33d( m_calibration.rightRectifyMatrix() ).t();
+    }
+    else {
+        ret.cameraMatrix = toMatx33d( m_calibration.rightCameraResults().cameraMatrix() );
+        ret.distortion = m_calibration.rightCameraResults().distortionCoefficients();
+        ret.rotation = rotation.t();
+    }
+
+    ret.center = -( rotation.t() * translation );
+
+    return ret;
+
+}
+
+CvImage SyntheticStereoRenderer::renderView( const SyntheticScene &scene, const View &view, cv::Mat *depth, cv::Mat *disparity ) const
+{
+    auto frameSize = m_calibration.leftCameraResults().frameSize();
+
+    CvImage ret( frameSize, CV_8UC3 );
+
+    if ( depth )
+        *depth = cv::Mat::zeros( frameSize, CV_32F );
+
+    if ( disparity )
+        *disparity = cv::Mat::zeros( frameSize, CV_32F );
+
+    auto right = rightView();
+
+    auto worldToView = view.rotation.t();
+    auto worldToRight = right.rotation.t();
+
+    auto samplesCount = m_samplesCount;
+    auto raysCount = samplesCount * samplesCount;
+
+    parallelFor( 0, frameSize.height, [ & ]( const int y ) {
+        std::vector< cv::Point2d > pixels;
+        pixels.reserve( frameSize.width * ( raysCount + 1 ) );
+
+        // Supersampled rays give the color, the pixel center ray gives depth and disparity
+        for ( int x = 0; x < frameSize.width; ++x ) {
+            for ( int i = 0; i < samplesCount; ++i )
+                for ( int j = 0; j < samplesCount; ++j )
+                    pixels.push_back( cv::Point2d( x - 0.5 + ( j + 0.5 ) / samplesCount, y - 0.5 + ( i + 0.5 ) / samplesCount ) );
+
+            pixels.push_back( cv::Point2d( x, y ) );
+
+        }
+
+        std::vector< cv::Point2d > normalized;
+        cv::undistortPoints( pixels, normalized, view.cameraMatrix, view.distortion );
+
+        size_t index = 0;
+
+        for ( int x = 0; x < frameSize.width; ++x ) {
+            cv::Vec3d sum;
+
+            for ( int i = 0; i < raysCount; ++i, ++index ) {
+                cv::Vec3d point;
+                cv::Vec3b color;
+
+                if ( !scene.trace( view.center, view.rotation * cv::Vec3d( normalized[ index ].x, normalized[ index ].y, 1. ), &point, &color ) )
+                    color = scene.background();
+
+                sum += cv::Vec3d( color );
+
+            }
+
+            sum /= raysCount;
+
+            ret.at< cv::Vec3b >( y, x ) = cv::Vec3b( cv::saturate_cast< uchar >( sum[ 0 ] ), cv::saturate_cast< uchar >( sum[ 1 ] ), cv::saturate_cast< uchar >( sum[ 2 ] ) );
+
+            auto &center = normalized[ index++ ];
+
+            cv::Vec3d point;
+            cv::Vec3b color;
+
+            if ( ( depth || disparity ) && scene.trace( view.center, view.rotation * cv::Vec3d( center.x, center.y, 1. ), &point, &color ) ) {
+
+                if ( depth )
+                    depth->at< float >( y, x ) = ( worldToView * ( point - view.center ) )[ 2 ];
+
+                if ( disparity ) {
+                    auto rightPoint = worldToRight * ( point - right.center );
+
+                    if ( rightPoint[ 2 ] > 0. )
+                        disparity->at< float >( y, x ) = x - ( right.cameraMatrix( 0, 0 ) * rightPoint[ 0 ] / rightPoint[ 2 ] + right.cameraMatrix( 0, 2 ) );
+
+                }
+
+            }
+
+        }
+
+    } );
+
+    return ret;
+
+}
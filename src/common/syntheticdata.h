@@ -0,0 +1,144 @@
+#pragma once
+
+#include "calibrationdatabase.h"
+#include "image.h"
+#include "markerprocessor.h"
+
+StereoCalibrationDataShort syntheticStereoCalibration( const cv::Size &frameSize, const double baseline = 100., const double distortion = 0. );
+
+CvImage syntheticTexture( const cv::Size &size, const unsigned int seed = 0 );
+
+StampedStereoImage syntheticStereoPair( const CvImage &texture, const cv::Rect &view, const int disparity );
+
+struct SyntheticPose
+{
+    // Object to left camera transformation
+    cv::Matx33d rotation;
+    cv::Vec3d translation;
+};
+
+struct SyntheticBoard
+{
+    CvImage texture;
+
+    // Board coordinates of the texture top left corner and directions of texture columns and rows
+    cv::Vec3d origin;
+    cv::Vec3d uAxis;
+    cv::Vec3d vAxis;
+
+    // Board units covered by the texture
+    cv::Size2d size;
+
+    cv::Vec3d center() const;
+    cv::Matx33d facingRotation() const;
+};
+
+SyntheticBoard syntheticCheckerboard( const cv::Size &count, const double size, const int squarePixels = 64 );
+SyntheticBoard syntheticCircleGrid( const cv::Size &count, const double size, const bool asymmetric, const int spacingPixels = 64 );
+SyntheticBoard syntheticArucoBoard( const ArucoProcessor &processor, const int rowsCount );
+
+std::vector< SyntheticPose > syntheticBoardPoses( const SyntheticBoard &board, const size_t count, const double distance, const double maxAngle, const unsigned int seed = 0 );
+
+class SyntheticSurface
+{
+public:
+    SyntheticSurface( const CvImage &texture, const cv::Vec3d &origin, const cv::Vec3d &uAxis, const cv::Vec3d &vAxis, const cv::Size2d &size );
+
+    bool intersect( const cv::Vec3d &origin, const cv::Vec3d &direction, double *distance, cv::Vec3b *color ) const;
+
+protected:
+    CvImage m_texture;
+
+    cv::Vec3d m_origin;
+    cv::Vec3d m_uAxis;
+    cv::Vec3d m_vAxis;
+    cv::Vec3d m_normal;
+
+    cv::Size2d m_size;
+
+private:
+    void initialize();
+
+};
+
+class SyntheticScene
+{
+public:
+    SyntheticScene();
+
+    void setBackground( const cv::Vec3b &value );
+    const cv::Vec3b &background() const;
+
+    void addSurface( const SyntheticSurface &surface );
+
+    void addPlane( const CvImage &texture, const cv::Vec3d &center, const cv::Matx33d &rotation, const cv::Size2d &size );
+    void addBox( const CvImage &texture, const cv::Vec3d &center, const cv::Matx33d &rotation, const cv::Vec3d &size );
+    void addBoard( const SyntheticBoard &board, const SyntheticPose &pose );
+
+    const std::vector< SyntheticSurface > &surfaces() const;
+
+    bool trace( const cv::Vec3d &origin, const cv::Vec3d &direction, cv::Vec3d *point, cv::Vec3b *color ) const;
+
+protected:
+    std::vector< SyntheticSurface > m_surfaces;
+
+    cv::Vec3b m_background;
+
+private:
+    void initialize();
+
+};
+
+SyntheticScene syntheticPlaneScene( const StereoCalibrationDataShort &calibration, const unsigned int seed = 0 );
+SyntheticScene syntheticBoxScene( const StereoCalibrationDataShort &calibration, const int boxesCount = 4, const unsigned int seed = 0 );
+
+struct SyntheticStereoFrame
+{
+    CvImage leftImage;
+    CvImage rightImage;
+
+    // CV_32F, zero where no surface was hit; disparity is filled for rectified renders only
+    cv::Mat depth;
+    cv::Mat disparity;
+};
+
+class SyntheticStereoRenderer
+{
+public:
+    SyntheticStereoRenderer( const StereoCalibrationDataShort &calibration );
+
+    void setRectified( const bool value );
+    bool rectified() const;
+
+    void setSamplesCount( const int value );
+    int samplesCount() const;
+
+    const StereoCalibrationDataShort &calibration() const;
+
+    SyntheticStereoFrame render( const SyntheticScene &scene ) const;
+
+protected:
+    struct View
+    {
+        cv::Matx33d cameraMatrix;
+        cv::Mat distortion;
+
+        // Camera to left camera transformation
+        cv::Matx33d rotation;
+        cv::Vec3d center;
+    };
+
+    StereoCalibrationDataShort m_calibration;
+
+    bool m_rectified;
+    int m_samplesCount;
+
+    View leftView() const;
+    View rightView() const;
+
+    CvImage renderView( const SyntheticScene &scene, const View &view, cv::Mat *depth = nullptr, cv::Mat *disparity = nullptr ) const;
+
+private:
+    void initialize();
+
+};
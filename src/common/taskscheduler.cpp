@@ -0,0 +1,271 @@
+#include "precompiled.h"
+
+#include "taskscheduler.h"
+
+// TaskScheduler
+thread_local int TaskScheduler::m_workerIndex = -1;
+
+TaskScheduler::TaskScheduler( const unsigned int threadsCount )
+    : m_stop( false ), m_pendingCount( 0 ), m_nextWorker( 0 )
+{
+    initialize( threadsCount );
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    stopThreads();
+}
+
+void TaskScheduler::initialize( const unsigned int threadsCount )
+{
+    for ( unsigned int i = 0; i < threadsCount; ++i )
+        m_workers.push_back( std::make_unique< Worker >() );
+
+    for ( unsigned int i = 0; i < threadsCount; ++i )
+        m_threads.emplace_back( &TaskScheduler::workerLoop, this, i );
+
+}
+
+TaskScheduler &TaskScheduler::instance()
+{
+    static TaskScheduler scheduler( std::max( 2u, std::thread::hardware_concurrency() ) );
+
+    return scheduler;
+}
+
+unsigned int TaskScheduler::threadsCount() const
+{
+    return std::max< size_t >( 1, m_workers.size() );
+}
+
+void TaskScheduler::setThreadsCount( const unsigned int value )
+{
+    if ( value == m_workers.size() )
+        return;
+
+    stopThreads();
+
+    m_threads.clear();
+    m_workers.clear();
+
+    m_stop = false;
+    m_nextWorker = 0;
+
+    initialize( value );
+
+}
+
+void TaskScheduler::stopThreads()
+{
+    {
+        std::lock_guard< std::mutex > lock( m_sleepMutex );
+        m_stop = true;
+    }
+
+    m_sleepCondition.notify_all();
+
+    for ( auto &i : m_threads )
+        i.join();
+
+}
+
+void TaskScheduler::submit( const Task &task, const Priority priority )
+{
+    // Without workers the task runs right away, exceptions are dropped like on a worker
+    if ( m_workers.empty() ) {
+        try {
+            task();
+        }
+        catch ( ... ) {
+        }
+
+        return;
+
+    }
+
+    // Tasks spawned by a worker stay local to it, external ones are spread round-robin
+    size_t worker = m_workerIndex >= 0 ? m_workerIndex : m_nextWorker++ % m_workers.size();
+
+    {
+        std::lock_guard< std::mutex > lock( m_sleepMutex );
+        ++m_pendingCount;
+    }
+
+    {
+        std::lock_guard< std::mutex > lock( m_workers[ worker ]->mutex );
+        m_workers[ worker ]->queues[ priority ].push_back( task );
+    }
+
+    m_sleepCondition.notify_one();
+
+}
+
+bool TaskScheduler::runPendingTask( const Priority priority )
+{
+    Task task;
+
+    size_t index = m_workerIndex >= 0 ? m_workerIndex : m_workers.size();
+
+    if ( !popTask( index, priority + 1, &task ) )
+        return false;
+
+    try {
+        task();
+    }
+    catch ( ... ) {
+    }
+
+    return true;
+
+}
+
+bool TaskScheduler::popTask( const size_t worker, const size_t prioritiesCount, Task *task )
+{
+    for ( size_t priority = 0; priority < prioritiesCount; ++priority ) {
+
+        if ( worker < m_workers.size() ) {
+            auto &current = *m_workers[ worker ];
+
+            std::lock_guard< std::mutex > lock( current.mutex );
+
+            auto &queue = current.queues[ priority ];
+
+            if ( !queue.empty() ) {
+                *task = std::move( queue.back() );
+                queue.pop_back();
+                --m_pendingCount;
+
+                return true;
+
+            }
+
+        }
+
+        if ( stealTask( worker, priority, task ) )
+            return true;
+
+    }
+
+    return false;
+
+}
+
+bool TaskScheduler::stealTask( const size_t thief, const size_t priority, Task *task )
+{
+    auto count = m_workers.size();
+
+    for ( size_t i = 1; i <= count; ++i ) {
+        auto victim = ( thief + i ) % count;
+
+        if ( victim == thief )
+            continue;
+
+        auto &current = *m_workers[ victim ];
+
+        std::lock_guard< std::mutex > lock( current.mutex );
+
+        auto &queue = current.queues[ priority ];
+
+        if ( !queue.empty() ) {
+            *task = std::move( queue.front() );
+            queue.pop_front();
+            --m_pendingCount;
+
+            return true;
+
+        }
+
+    }
+
+    return false;
+
+}
+
+void TaskScheduler::workerLoop( const size_t index )
+{
+    m_workerIndex = index;
+
+    while ( !m_stop ) {
+
+        if ( !runPendingTask() ) {
+            std::unique_lock< std::mutex > lock( m_sleepMutex );
+            m_sleepCondition.wait( lock, [ this ] { return m_stop || m_pendingCount > 0; } );
+        }
+
+    }
+
+}
+
+// TaskGroup
+TaskGroup::TaskGroup( const TaskScheduler::Priority priority )
+    : m_priority( priority ), m_pendingCount( 0 )
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    try {
+        wait();
+    }
+    catch ( ... ) {
+    }
+
+}
+
+void TaskGroup::run( const TaskScheduler::Task &task )
+{
+    ++m_pendingCount;
+
+    TaskScheduler::instance().submit( [ this, task ] {
+        try {
+            task();
+        }
+        catch ( ... ) {
+            std::lock_guard< std::mutex > lock( m_exceptionMutex );
+
+            if ( !m_exception )
+                m_exception = std::current_exception();
+
+        }
+
+        // Under the lock, so a waiter cannot return and destroy the group before the notification
+        std::lock_guard< std::mutex > lock( m_waitMutex );
+
+        if ( --m_pendingCount == 0 )
+            m_waitCondition.notify_all();
+
+    }, m_priority );
+
+}
+
+void TaskGroup::wait()
+{
+    // The waiting thread executes queued work of its own priority or higher, so nested groups cannot starve
+    // the pool and a latency critical waiter is not held by background work. With nothing to run all tasks
+    // of the group are already running elsewhere
+    while ( m_pendingCount > 0 ) {
+
+        if ( TaskScheduler::instance().runPendingTask( m_priority ) )
+            continue;
+
+        std::unique_lock< std::mutex > lock( m_waitMutex );
+        m_waitCondition.wait( lock, [ this ] { return m_pendingCount == 0; } );
+
+    }
+
+    {
+        // The last task may still hold the lock after the count reached zero
+        std::lock_guard< std::mutex > lock( m_waitMutex );
+    }
+
+    std::exception_ptr exception;
+
+    {
+        std::lock_guard< std::mutex > lock( m_exceptionMutex );
+        std::swap( exception, m_exception );
+    }
+
+    if ( exception )
+        std::rethrow_exception( exception );
+
+}
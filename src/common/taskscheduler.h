@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskScheduler
+{
+public:
+    enum Priority { CAPTURE, TRACKING, VISUALIZATION };
+
+    using Task = std::function< void() >;
+
+    static TaskScheduler &instance();
+
+    ~TaskScheduler();
+
+    // Worker threads, at least one for sizing work: without workers tasks run on the submitting thread
+    unsigned int threadsCount() const;
+
+    // Restarts the pool with this many workers, only while no task is queued or running
+    void setThreadsCount( const unsigned int value );
+
+    void submit( const Task &task, const Priority priority = TRACKING );
+
+    // Runs one queued task of the given or a higher priority, false when there is none
+    bool runPendingTask( const Priority priority = VISUALIZATION );
+
+protected:
+    TaskScheduler( const unsigned int threadsCount );
+
+    static const size_t m_prioritiesCount = VISUALIZATION + 1;
+
+    struct Worker
+    {
+        std::array< std::deque< Task >, m_prioritiesCount > queues;
+        std::mutex mutex;
+    };
+
+    std::vector< std::unique_ptr< Worker > > m_workers;
+    std::vector< std::thread > m_threads;
+
+    std::atomic< bool > m_stop;
+    std::atomic< size_t > m_pendingCount;
+    std::atomic< size_t > m_nextWorker;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+
+    static thread_local int m_workerIndex;
+
+    bool popTask( const size_t worker, const size_t prioritiesCount, Task *task );
+    bool stealTask( const size_t thief, const size_t priority, Task *task );
+
+    void workerLoop( const size_t index );
+
+    void stopThreads();
+
+private:
+    void initialize( const unsigned int threadsCount );
+
+};
+
+class TaskGroup
+{
+public:
+    TaskGroup( const TaskScheduler::Priority priority = TaskScheduler::TRACKING );
+    ~TaskGroup();
+
+    void run( const TaskScheduler::Task &task );
+
+    void wait();
+
+protected:
+    TaskScheduler::Priority m_priority;
+
+    std::atomic< int > m_pendingCount;
+
+    // Signalled by the last finished task
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+
+    std::mutex m_exceptionMutex;
+    std::exception_ptr m_exception;
+
+};
+
+template < class Function >
+void parallelFor( const int begin, const int end, const Function &function,
+                  const TaskScheduler::Priority priority = TaskScheduler::TRACKING, const int grainSize = 1 );
+
+#include "taskscheduler.inl"
@@ -0,0 +1,33 @@
+template < class Function >
+void parallelFor( const int begin, const int end, const Function &function, const TaskScheduler::Priority priority, const int grainSize )
+{
+    if ( end <= begin )
+        return;
+
+    auto grain = std::max( 1, grainSize );
+
+    auto chunkSize = std::max( grain, ( end - begin ) / static_cast< int >( 4 * TaskScheduler::instance().threadsCount() ) );
+
+    if ( end - begin <= chunkSize ) {
+        for ( int i = begin; i < end; ++i )
+            function( i );
+
+        return;
+
+    }
+
+    TaskGroup group( priority );
+
+    for ( int chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize ) {
+        auto chunkEnd = std::min( end, chunkBegin + chunkSize );
+
+        group.run( [ &function, chunkBegin, chunkEnd ] {
+            for ( int i = chunkBegin; i < chunkEnd; ++i )
+                function( i );
+        } );
+
+    }
+
+    group.wait();
+
+}
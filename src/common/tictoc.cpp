@@ -10,12 +10,17 @@ TicToc::TicToc()
 
 void TicToc::tic()
 {
-    m_start = std::chrono::steady_clock::now();
+    m_start = Clock::now();
 }
 
 double TicToc::toc()
 {
-    return std::chrono::duration< double >( std::chrono::steady_clock::now() - m_start ).count();
+    return std::chrono::duration< double >( Clock::now() - m_start ).count();
+}
+
+const TicToc::TimePoint &TicToc::startTime() const
+{
+    return m_start;
 }
 
 void TicToc::report()
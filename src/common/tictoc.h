@@ -7,13 +7,18 @@
 class TicToc
 {
   public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = std::chrono::time_point< Clock >;
+
     TicToc();
 
     void tic();
     double toc();
 
+    const TimePoint &startTime() const;
+
     void report();
 
   protected:
-    std::chrono::time_point< std::chrono::steady_clock > m_start;
+    TimePoint m_start;
 };
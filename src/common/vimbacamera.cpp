@@ -3,6 +3,7 @@
 #include "vimbacamera.h"
 
 #include "functions.h"
+#include "frametrace.h"
 
 #include <unistd.h>
 
@@ -36,6 +37,7 @@ void FrameObserver::FrameReceived ( const AVT::VmbAPI::FramePtr pFrame )
         {
 
             auto time = std::chrono::system_clock::now();
+            auto trace = FrameTrace::create();
 
             VmbUchar_t *pImage;
             VmbUint32_t nWidth = 0;
@@ -48,6 +50,7 @@ void FrameObserver::FrameReceived ( const AVT::VmbAPI::FramePtr pFrame )
             m_framesMutex.lock();
             m_sourceMat = cv::Mat( nHeight, nWidth, CV_8UC1, pImage );
             m_sourceTime = time;
+            m_sourceTrace = trace;
             m_framesMutex.unlock();
 
             emit receivedFrame();
@@ -68,6 +71,7 @@ StampedImage FrameObserver::getFrame()
 
     if ( !m_sourceMat.empty() ) {
         res.setTime( m_sourceTime );
+        res.setTrace( m_sourceTrace );
         cv::cvtColor( m_sourceMat, res, cv::COLOR_BayerGB2RGB );
     }
 
@@ -93,6 +97,7 @@ StampedImage FrameObserver::getFrameUnsafe() const
 
     if ( !m_sourceMat.empty() ) {
         res.setTime( m_sourceTime );
+        res.setTrace( m_sourceTrace );
         cv::cvtColor( m_sourceMat, res, cv::COLOR_BayerGB2RGB );
     }
 
@@ -242,6 +247,8 @@ StereoCamera::StereoCamera( const std::string &leftIp, const std::string &rightI
 
 void StereoCamera::initialize()
 {
+    m_fetchedTraceId = 0;
+
     connect( &m_leftCamera, &MasterCamera::receivedFrame, this, &StereoCamera::updateFrame );
     connect( &m_rightCamera, &SlaveCamera::receivedFrame, this, &StereoCamera::updateFrame );
 }
@@ -265,6 +272,25 @@ void StereoCamera::updateFrame()
     if ( !leftFrame.empty() && !rightFrame.empty() ) {
 
         m_framesMutex.lock();
+
+        if ( !m_framesQueue.empty() ) {
+            auto &lastTrace = m_framesQueue.back().trace();
+
+            // Both cameras signal every pair, the second signal finds it already queued
+            if ( lastTrace.id() == leftFrame.trace().id() ) {
+                m_framesMutex.unlock();
+                return;
+            }
+
+            if ( lastTrace.id() != m_fetchedTraceId )
+                LatencyMonitor::instance().drop( lastTrace, "camera" );
+
+        }
+
+        // Both views share the master camera trace
+        rightFrame.setTrace( leftFrame.trace() );
+        leftFrame.trace().mark( "pairing" );
+
         m_framesQueue.push( StampedStereoImage( leftFrame, rightFrame ) );
         m_framesMutex.unlock();
 
@@ -282,6 +308,7 @@ StampedStereoImage StereoCamera::getFrame()
 
     if( !m_framesQueue.empty() ) {
         res = m_framesQueue.back();
+        m_fetchedTraceId = res.trace().id();
     }
 
     m_framesMutex.unlock();
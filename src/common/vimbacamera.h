@@ -41,6 +41,7 @@ protected:
 
     cv::Mat m_sourceMat;
     std::chrono::time_point< std::chrono::system_clock > m_sourceTime;
+    FrameTrace m_sourceTrace;
 
     static int m_currentNumber;
     static const std::chrono::time_point< std::chrono::system_clock > m_startTime;
@@ -145,6 +146,8 @@ protected:
     LimitedQueue< StampedStereoImage > m_framesQueue;
     QMutex m_framesMutex;
 
+    uint64_t m_fetchedTraceId;
+
 private:
     void initialize();
 
@@ -0,0 +1,294 @@
+#include "src/common/precompiled.h"
+
+#include "src/common/markerprocessor.h"
+#include "src/common/syntheticdata.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+
+#include <iostream>
+
+static std::string frameFileName( const QDir &dir, const QString &folder, const size_t index, const QString &extension )
+{
+    return dir.filePath( folder + "/" + QString( "%1." ).arg( index, 4, 10, QChar( '0' ) ) + extension ).toStdString();
+}
+
+static bool parseSize( const QString &value, cv::Size *size )
+{
+    auto parts = value.toLower().split( "x" );
+
+    if ( parts.size() != 2 )
+        return false;
+
+    *size = cv::Size( parts[ 0 ].toInt(), parts[ 1 ].toInt() );
+
+    return size->width > 0 && size->height > 0;
+
+}
+
+// Rectified renders need no further rectification, so their calibration maps both views onto themselves
+static StereoCalibrationDataShort rectifiedCalibration( const StereoCalibrationDataShort &calibration )
+{
+    auto ret = calibration;
+
+    cv::Mat leftCameraMatrix = calibration.leftProjectionMatrix().cameraMatrix().clone();
+    cv::Mat rightCameraMatrix = calibration.rightProjectionMatrix().cameraMatrix().clone();
+
+    ret.leftCameraResults().setCameraMatrix( leftCameraMatrix );
+    ret.leftCameraResults().setDistortionCoefficients( cv::Mat::zeros( 1, 5, CV_64F ) );
+    ret.rightCameraResults().setCameraMatrix( rightCameraMatrix );
+    ret.rightCameraResults().setDistortionCoefficients( cv::Mat::zeros( 1, 5, CV_64F ) );
+
+    // The right projection matrix is K [ I | t ] in the rectified frame
+    cv::Mat translationVector = rightCameraMatrix.inv() * calibration.rightProjectionMatrix().projectionMatrix().col( 3 );
+
+    auto x = translationVector.at< double >( 0 );
+    auto y = translationVector.at< double >( 1 );
+    auto z = translationVector.at< double >( 2 );
+
+    cv::Mat translationCross = ( cv::Mat_< double >( 3, 3 ) << 0., -z, y,
+                                                                z, 0., -x,
+                                                                -y, x, 0. );
+
+    ret.setRotationMatrix( cv::Mat::eye( 3, 3, CV_64F ) );
+    ret.setTranslationVector( translationVector );
+    ret.setEssentialMatrix( translationCross );
+    ret.setFundamentalMatrix( rightCameraMatrix.inv().t() * translationCross * leftCameraMatrix.inv() );
+
+    ret.setLeftRectifyMatrix( cv::Mat::eye( 3, 3, CV_64F ) );
+    ret.setRightRectifyMatrix( cv::Mat::eye( 3, 3, CV_64F ) );
+
+    return ret;
+
+}
+
+static bool saveStereo( const QDir &dir, const StereoCalibrationDataShort &calibration, const bool rectified, const QString &sceneType,
+                            const size_t framesCount, const int samplesCount, const unsigned int seed )
+{
+    SyntheticStereoRenderer renderer( calibration );
+
+    renderer.setRectified( rectified );
+    renderer.setSamplesCount( samplesCount );
+
+    for ( size_t i = 0; i < framesCount; ++i ) {
+        auto scene = sceneType == "plane" ? syntheticPlaneScene( calibration, seed + i ) : syntheticBoxScene( calibration, 4, seed + i );
+
+        auto frame = renderer.render( scene );
+
+        if ( !cv::imwrite( frameFileName( dir, "left", i, "png" ), frame.leftImage )
+                || !cv::imwrite( frameFileName( dir, "right", i, "png" ), frame.rightImage )
+                || !cv::imwrite( frameFileName( dir, "depth", i, "pfm" ), frame.depth ) )
+            return false;
+
+        if ( rectified && !cv::imwrite( frameFileName( dir, "disparity", i, "pfm" ), frame.disparity ) )
+            return false;
+
+        std::cout << "Frame " << i + 1 << " of " << framesCount << std::endl;
+
+    }
+
+    return true;
+
+}
+
+static bool saveCalibration( const QDir &dir, const StereoCalibrationDataShort &calibration, const SyntheticBoard &board,
+                                const size_t framesCount, const int samplesCount, const unsigned int seed )
+{
+    SyntheticStereoRenderer renderer( calibration );
+
+    renderer.setRectified( false );
+    renderer.setSamplesCount( samplesCount );
+
+    // The board takes about half of the view width at the mean distance
+    auto distance = calibration.leftCameraResults().fx() * std::max( board.size.width, board.size.height ) / ( 0.5 * calibration.leftCameraResults().frameWidth() );
+
+    auto poses = syntheticBoardPoses( board, framesCount, distance, 30., seed );
+
+    cv::FileStorage storage( dir.filePath( "poses.yaml" ).toStdString(), cv::FileStorage::WRITE );
+
+    if ( !storage.isOpened() )
+        return false;
+
+    storage << "framesCount" << static_cast< int >( poses.size() );
+
+    for ( size_t i = 0; i < poses.size(); ++i ) {
+        SyntheticScene scene;
+        scene.addBoard( board, poses[ i ] );
+
+        auto frame = renderer.render( scene );
+
+        if ( !cv::imwrite( frameFileName( dir, "left", i, "png" ), frame.leftImage )
+                || !cv::imwrite( frameFileName( dir, "right", i, "png" ), frame.rightImage ) )
+            return false;
+
+        storage << QString( "pose_%1" ).arg( i, 4, 10, QChar( '0' ) ).toStdString() << "{"
+                << "rotation" << cv::Mat( poses[ i ].rotation )
+                << "translation" << cv::Mat( poses[ i ].translation ) << "}";
+
+        std::cout << "Frame " << i + 1 << " of " << framesCount << std::endl;
+
+    }
+
+    return true;
+
+}
+
+int main( int argc, char **argv )
+{
+    QCoreApplication application( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Synthetic stereo and calibration target dataset generator" );
+    parser.addHelpOption();
+    parser.addPositionalArgument( "output", "Output folder." );
+
+    QCommandLineOption modeOption( QStringList() << "m" << "mode", "Dataset type: stereo or calibration.", "mode", "stereo" );
+    QCommandLineOption calibrationOption( QStringList() << "c" << "calibration", "Stereo calibration file, a synthetic camera is used otherwise.", "file" );
+    QCommandLineOption resolutionOption( "resolution", "Synthetic camera resolution.", "WxH", "640x480" );
+    QCommandLineOption baselineOption( "baseline", "Synthetic camera baseline.", "length", "100" );
+    QCommandLineOption distortionOption( "distortion", "Synthetic camera radial distortion k1.", "k1", "0" );
+    QCommandLineOption framesOption( QStringList() << "n" << "frames", "Frames count.", "count", "10" );
+    QCommandLineOption sceneOption( "scene", "Stereo scene: plane or box.", "scene", "box" );
+    QCommandLineOption rawOption( "raw", "Render unrectified stereo pairs." );
+    QCommandLineOption templateOption( "template", "Calibration target: checkerboard, circles, asym_circles or aruco.", "type", "checkerboard" );
+    QCommandLineOption countOption( "count", "Target points count, or ArUco rows count as the height.", "WxH", "9x6" );
+    QCommandLineOption sizeOption( "size", "Target square, spacing or marker size.", "length", "30" );
+    QCommandLineOption samplesOption( "samples", "Rays per pixel side.", "count", "2" );
+    QCommandLineOption seedOption( QStringList() << "s" << "seed", "Random generator seed.", "seed", "0" );
+
+    parser.addOption( modeOption );
+    parser.addOption( calibrationOption );
+    parser.addOption( resolutionOption );
+    parser.addOption( baselineOption );
+    parser.addOption( distortionOption );
+    parser.addOption( framesOption );
+    parser.addOption( sceneOption );
+    parser.addOption( rawOption );
+    parser.addOption( templateOption );
+    parser.addOption( countOption );
+    parser.addOption( sizeOption );
+    parser.addOption( samplesOption );
+    parser.addOption( seedOption );
+
+    parser.process( application );
+
+    if ( parser.positionalArguments().size() != 1 )
+        parser.showHelp( 1 );
+
+    StereoCalibrationDataShort calibration;
+
+    if ( parser.isSet( calibrationOption ) ) {
+        calibration = StereoCalibrationDataShort( parser.value( calibrationOption ).toStdString() );
+
+        if ( !calibration.isOk() ) {
+            std::cerr << "Can't load calibration " << parser.value( calibrationOption ).toStdString() << std::endl;
+            return 1;
+        }
+
+    }
+    else {
+        cv::Size resolution;
+
+        if ( !parseSize( parser.value( resolutionOption ), &resolution ) ) {
+            std::cerr << "Wrong resolution " << parser.value( resolutionOption ).toStdString() << std::endl;
+            return 1;
+        }
+
+        calibration = syntheticStereoCalibration( resolution, parser.value( baselineOption ).toDouble(), parser.value( distortionOption ).toDouble() );
+
+    }
+
+    QDir dir( parser.positionalArguments().front() );
+
+    auto mode = parser.value( modeOption );
+    auto framesCount = parser.value( framesOption ).toUInt();
+    auto samplesCount = parser.value( samplesOption ).toInt();
+    auto seed = parser.value( seedOption ).toUInt();
+
+    bool rectified = mode == "stereo" && !parser.isSet( rawOption );
+
+    for ( auto &i : { "left", "right" } )
+        dir.mkpath( i );
+
+    if ( mode == "stereo" ) {
+        dir.mkpath( "depth" );
+
+        if ( rectified )
+            dir.mkpath( "disparity" );
+
+    }
+
+    // Ground truth calibration goes next to the images, in the format the disparity and slam apps load
+    auto savedCalibration = rectified ? rectifiedCalibration( calibration ) : calibration;
+
+    if ( !savedCalibration.saveYaml( dir.filePath( "calibration.yaml" ).toStdString() ) ) {
+        std::cerr << "Can't save calibration to " << dir.path().toStdString() << std::endl;
+        return 1;
+    }
+
+    bool result = false;
+
+    if ( mode == "stereo" ) {
+        auto sceneType = parser.value( sceneOption );
+
+        if ( sceneType != "plane" && sceneType != "box" ) {
+            std::cerr << "Unknown scene " << sceneType.toStdString() << std::endl;
+            return 1;
+        }
+
+        result = saveStereo( dir, calibration, rectified, sceneType, framesCount, samplesCount, seed );
+
+    }
+    else if ( mode == "calibration" ) {
+        cv::Size count;
+
+        if ( !parseSize( parser.value( countOption ), &count ) ) {
+            std::cerr << "Wrong target count " << parser.value( countOption ).toStdString() << std::endl;
+            return 1;
+        }
+
+        auto templateType = parser.value( templateOption );
+        auto size = parser.value( sizeOption ).toDouble();
+
+        SyntheticBoard board;
+
+        if ( templateType == "checkerboard" )
+            board = syntheticCheckerboard( count, size );
+        else if ( templateType == "circles" )
+            board = syntheticCircleGrid( count, size, false );
+        else if ( templateType == "asym_circles" )
+            board = syntheticCircleGrid( count, size, true );
+        else if ( templateType == "aruco" ) {
+            ArucoProcessor processor;
+            processor.setSize( size );
+
+            if ( processor.firstId() + count.height * processor.markersInRow() > processor.dictionary()->bytesList.rows ) {
+                std::cerr << "Too many ArUco rows for the marker dictionary" << std::endl;
+                return 1;
+            }
+
+            board = syntheticArucoBoard( processor, count.height );
+
+        }
+        else {
+            std::cerr << "Unknown template " << templateType.toStdString() << std::endl;
+            return 1;
+        }
+
+        result = saveCalibration( dir, calibration, board, framesCount, samplesCount, seed );
+
+    }
+    else {
+        std::cerr << "Unknown mode " << mode.toStdString() << std::endl;
+        return 1;
+    }
+
+    if ( !result ) {
+        std::cerr << "Can't save dataset to " << dir.path().toStdString() << std::endl;
+        return 1;
+    }
+
+    return 0;
+
+}
@@ -2,6 +2,7 @@
 
 #include "disparitycontrolwidget.h"
 
+#include "src/common/disparityparameters.h"
 #include "src/common/supportwidgets.h"
 
 // IntSliderBox
@@ -195,6 +196,7 @@ void TypeComboBox::initialize()
 {
     addItem( tr( "Block matching" ), Type::BM );
     addItem( tr( "Global matching" ), Type::GM );
+    addItem( tr( "Census matching" ), Type::CENSUS );
     addItem( tr( "GPU Block matching" ), Type::BM_GPU );
     addItem( tr( "Belief Propagation" ), Type::BP );
     addItem( tr( "Constant Space Belief Propagation" ), Type::CSBP );
@@ -206,6 +208,11 @@ TypeComboBox::Type TypeComboBox::currentType() const
     return static_cast<Type>( currentData().toInt() );
 }
 
+void TypeComboBox::setCurrentType( const Type value )
+{
+    setCurrentIndex( findData( value ) );
+}
+
 // TypeLayout
 TypeLayout::TypeLayout( QWidget* parent )
     : QHBoxLayout( parent )
@@ -230,6 +237,11 @@ TypeComboBox::Type TypeLayout::value() const
     return m_typeComboBox->currentType();
 }
 
+void TypeLayout::setValue( const TypeComboBox::Type value )
+{
+    m_typeComboBox->setCurrentType( value );
+}
+
 // GMTypeComboBox
 GMTypeComboBox::GMTypeComboBox( QWidget *parent )
     : QComboBox( parent )
@@ -251,6 +263,11 @@ GMTypeComboBox::Type GMTypeComboBox::currentType() const
     return static_cast<Type>( currentData().toInt() );
 }
 
+void GMTypeComboBox::setCurrentType( const Type value )
+{
+    setCurrentIndex( findData( value ) );
+}
+
 // GMTypeLayout
 GMTypeLayout::GMTypeLayout( QWidget* parent )
     : QHBoxLayout( parent )
@@ -274,6 +291,65 @@ GMTypeComboBox::Type GMTypeLayout::value() const
     return m_typeComboBox->currentType();
 }
 
+void GMTypeLayout::setValue( const GMTypeComboBox::Type value )
+{
+    m_typeComboBox->setCurrentType( value );
+}
+
+// CensusWindowComboBox
+CensusWindowComboBox::CensusWindowComboBox( QWidget *parent )
+    : QComboBox( parent )
+{
+    initialize();
+}
+
+void CensusWindowComboBox::initialize()
+{
+    addItem( tr( "5x5" ), Window::WINDOW_5X5 );
+    addItem( tr( "7x7" ), Window::WINDOW_7X7 );
+    addItem( tr( "9x7" ), Window::WINDOW_9X7 );
+
+    setCurrentWindow( Window::WINDOW_9X7 );
+}
+
+CensusWindowComboBox::Window CensusWindowComboBox::currentWindow() const
+{
+    return static_cast<Window>( currentData().toInt() );
+}
+
+void CensusWindowComboBox::setCurrentWindow( const Window value )
+{
+    setCurrentIndex( findData( value ) );
+}
+
+// CensusWindowLayout
+CensusWindowLayout::CensusWindowLayout( QWidget* parent )
+    : QHBoxLayout( parent )
+{
+    initialize();
+}
+
+void CensusWindowLayout::initialize()
+{
+    m_label = new QLabel( tr("Census window") );
+    addWidget( m_label );
+
+    m_windowComboBox = new CensusWindowComboBox();
+    addWidget( m_windowComboBox );
+
+    connect( m_windowComboBox, static_cast< void ( CensusWindowComboBox::* )( int ) >( &CensusWindowComboBox::currentIndexChanged ), this, &CensusWindowLayout::currentIndexChanged );
+}
+
+CensusWindowComboBox::Window CensusWindowLayout::value() const
+{
+    return m_windowComboBox->currentWindow();
+}
+
+void CensusWindowLayout::setValue( const CensusWindowComboBox::Window value )
+{
+    m_windowComboBox->setCurrentWindow( value );
+}
+
 // BMControlWidget
 BMControlWidget::BMControlWidget( QWidget* parent )
     : QWidget( parent )
@@ -662,6 +738,11 @@ int GMControlWidget::p2() const
     return m_p2Layout->value();
 }
 
+void GMControlWidget::setMode( const GMTypeComboBox::Type value )
+{
+    m_modeLayout->setValue( value );
+}
+
 void GMControlWidget::setPrefilterCap( const int value )
 {
     m_preFilterCapLayout->setValue( value );
@@ -712,6 +793,148 @@ void GMControlWidget::setP2(int p2)
     m_p2Layout->setValue( p2 );
 }
 
+// CensusControlWidget
+CensusControlWidget::CensusControlWidget( QWidget* parent )
+    : QWidget( parent )
+{
+    initialize();
+}
+
+void CensusControlWidget::initialize()
+{
+    auto layout = new QVBoxLayout( this );
+
+    m_windowLayout = new CensusWindowLayout();
+    layout->addLayout( m_windowLayout );
+
+    m_sadWindowSizeLayout = new IntSliderLayout( tr("Aggregation window size" ) );
+    m_sadWindowSizeLayout->setRange( 1, 31, 2 );
+    layout->addLayout( m_sadWindowSizeLayout );
+
+    m_minDisparityLayout = new IntSliderLayout( tr( "Minimum disparity" ) );
+    m_minDisparityLayout->setRange( -255, 255 );
+    layout->addLayout( m_minDisparityLayout );
+
+    m_numDisparitiesLayout = new IntSliderLayout( tr( "Number of disparities" ) );
+    m_numDisparitiesLayout->setRange( 16, 256, 16 );
+    layout->addLayout( m_numDisparitiesLayout );
+
+    m_uniquessRatioLayout = new IntSliderLayout( tr( "Uniquess ratio" ) );
+    m_uniquessRatioLayout->setRange( 0, 99 );
+    layout->addLayout( m_uniquessRatioLayout );
+
+    m_speckleWindowSizeLayout = new IntSliderLayout( tr( "Speckle window size" ) );
+    layout->addLayout( m_speckleWindowSizeLayout );
+
+    m_speckleRangeLayout = new IntSliderLayout( tr( "Speckle range" ) );
+    layout->addLayout( m_speckleRangeLayout );
+
+    // Negative value turns the left-right check off
+    m_disp12MaxDiffLayout = new IntSliderLayout( tr( "Max difference" ) );
+    m_disp12MaxDiffLayout->setRange( -1, 16 );
+    layout->addLayout( m_disp12MaxDiffLayout );
+
+    layout->addStretch();
+
+    setSadWindowSize( 9 );
+    setMinDisparity( 0 );
+    setNumDisparities( 128 );
+    setUniquessRatio( 10 );
+    setSpeckleWindowSize( 50 );
+    setSpeckleRange( 2 );
+    setDisp12MaxDiff( 1 );
+
+    connect( m_windowLayout, &CensusWindowLayout::currentIndexChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_sadWindowSizeLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_minDisparityLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_numDisparitiesLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_uniquessRatioLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_speckleWindowSizeLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_speckleRangeLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+    connect( m_disp12MaxDiffLayout, &IntSliderLayout::valueChanged, this, &CensusControlWidget::valueChanged );
+
+}
+
+CensusWindowComboBox::Window CensusControlWidget::window() const
+{
+    return m_windowLayout->value();
+}
+
+int CensusControlWidget::sadWindowSize() const
+{
+    return m_sadWindowSizeLayout->value();
+}
+
+int CensusControlWidget::minDisparity() const
+{
+    return m_minDisparityLayout->value();
+}
+
+int CensusControlWidget::numDisparities() const
+{
+    return m_numDisparitiesLayout->value();
+}
+
+int CensusControlWidget::uniquessRatio() const
+{
+    return m_uniquessRatioLayout->value();
+}
+
+int CensusControlWidget::speckleWindowSize() const
+{
+    return m_speckleWindowSizeLayout->value();
+}
+
+int CensusControlWidget::speckleRange() const
+{
+    return m_speckleRangeLayout->value();
+}
+
+int CensusControlWidget::disp12MaxDiff() const
+{
+    return m_disp12MaxDiffLayout->value();
+}
+
+void CensusControlWidget::setWindow( const CensusWindowComboBox::Window value )
+{
+    m_windowLayout->setValue( value );
+}
+
+void CensusControlWidget::setSadWindowSize( const int value )
+{
+    m_sadWindowSizeLayout->setValue( value );
+}
+
+void CensusControlWidget::setMinDisparity( const int value )
+{
+    m_minDisparityLayout->setValue( value );
+}
+
+void CensusControlWidget::setNumDisparities( const int value )
+{
+    m_numDisparitiesLayout->setValue( value );
+}
+
+void CensusControlWidget::setUniquessRatio( const int value )
+{
+    m_uniquessRatioLayout->setValue( value );
+}
+
+void CensusControlWidget::setSpeckleWindowSize( const int value )
+{
+    m_speckleWindowSizeLayout->setValue( value );
+}
+
+void CensusControlWidget::setSpeckleRange( const int value )
+{
+    m_speckleRangeLayout->setValue( value );
+}
+
+void CensusControlWidget::setDisp12MaxDiff( const int value )
+{
+    m_disp12MaxDiffLayout->setValue( value );
+}
+
 // BPControlWidget
 BPControlWidget::BPControlWidget( QWidget* parent )
     : QWidget( parent )
@@ -872,7 +1095,136 @@ FilterControlWidget::FilterControlWidget( QWidget* parent )
 
 void FilterControlWidget::initialize()
 {
+    auto layout = new QVBoxLayout( this );
+
+    m_refinementCheck = new QCheckBox( tr( "Edge-aware refinement" ), this );
+    layout->addWidget( m_refinementCheck );
+
+    m_subpixelCheck = new QCheckBox( tr( "Sub-pixel refinement" ), this );
+    layout->addWidget( m_subpixelCheck );
+
+    m_maxHoleWidthLayout = new IntSliderLayout( tr( "Max hole width" ) );
+    m_maxHoleWidthLayout->setRange( 0, 64 );
+    layout->addLayout( m_maxHoleWidthLayout );
+
+    m_iterationsLayout = new IntSliderLayout( tr( "Filter iterations" ) );
+    m_iterationsLayout->setRange( 0, 5 );
+    layout->addLayout( m_iterationsLayout );
+
+    m_spatialSigmaLayout = new DoubleSliderLayout( tr( "Spatial sigma" ) );
+    m_spatialSigmaLayout->setRange( 1, 100 );
+    layout->addLayout( m_spatialSigmaLayout );
+
+    m_colorSigmaLayout = new DoubleSliderLayout( tr( "Color sigma" ) );
+    m_colorSigmaLayout->setRange( 1, 255 );
+    layout->addLayout( m_colorSigmaLayout );
+
+    m_disparitySigmaLayout = new DoubleSliderLayout( tr( "Disparity sigma" ) );
+    m_disparitySigmaLayout->setRange( 0.1, 20, 0.1 );
+    layout->addLayout( m_disparitySigmaLayout );
+
+    m_regionSizeLayout = new IntSliderLayout( tr( "Region of interest, %" ) );
+    m_regionSizeLayout->setRange( 10, 100 );
+    layout->addLayout( m_regionSizeLayout );
+
+    setRefinementEnabled( false );
+    setSubpixelEnabled( true );
+    setMaxHoleWidth( 16 );
+    setIterations( 2 );
+    setSpatialSigma( 10. );
+    setColorSigma( 20. );
+    setDisparitySigma( 2. );
+    setRegionSize( 100 );
+
+    connect( m_refinementCheck, &QCheckBox::toggled, this, &FilterControlWidget::valueChanged );
+    connect( m_subpixelCheck, &QCheckBox::toggled, this, &FilterControlWidget::valueChanged );
+    connect( m_maxHoleWidthLayout, &IntSliderLayout::valueChanged, this, &FilterControlWidget::valueChanged );
+    connect( m_iterationsLayout, &IntSliderLayout::valueChanged, this, &FilterControlWidget::valueChanged );
+    connect( m_spatialSigmaLayout, &DoubleSliderLayout::valueChanged, this, &FilterControlWidget::valueChanged );
+    connect( m_colorSigmaLayout, &DoubleSliderLayout::valueChanged, this, &FilterControlWidget::valueChanged );
+    connect( m_disparitySigmaLayout, &DoubleSliderLayout::valueChanged, this, &FilterControlWidget::valueChanged );
+    connect( m_regionSizeLayout, &IntSliderLayout::valueChanged, this, &FilterControlWidget::valueChanged );
+
+}
+
+bool FilterControlWidget::isRefinementEnabled() const
+{
+    return m_refinementCheck->isChecked();
+}
+
+bool FilterControlWidget::isSubpixelEnabled() const
+{
+    return m_subpixelCheck->isChecked();
+}
+
+int FilterControlWidget::maxHoleWidth() const
+{
+    return m_maxHoleWidthLayout->value();
+}
+
+int FilterControlWidget::iterations() const
+{
+    return m_iterationsLayout->value();
+}
+
+double FilterControlWidget::spatialSigma() const
+{
+    return m_spatialSigmaLayout->value();
+}
+
+double FilterControlWidget::colorSigma() const
+{
+    return m_colorSigmaLayout->value();
+}
+
+double FilterControlWidget::disparitySigma() const
+{
+    return m_disparitySigmaLayout->value();
+}
+
+int FilterControlWidget::regionSize() const
+{
+    return m_regionSizeLayout->value();
+}
+
+void FilterControlWidget::setRefinementEnabled( const bool value )
+{
+    m_refinementCheck->setChecked( value );
+}
+
+void FilterControlWidget::setSubpixelEnabled( const bool value )
+{
+    m_subpixelCheck->setChecked( value );
+}
+
+void FilterControlWidget::setMaxHoleWidth( const int value )
+{
+    m_maxHoleWidthLayout->setValue( value );
+}
+
+void FilterControlWidget::setIterations( const int value )
+{
+    m_iterationsLayout->setValue( value );
+}
+
+void FilterControlWidget::setSpatialSigma( const double value )
+{
+    m_spatialSigmaLayout->setValue( value );
+}
+
+void FilterControlWidget::setColorSigma( const double value )
+{
+    m_colorSigmaLayout->setValue( value );
+}
+
+void FilterControlWidget::setDisparitySigma( const double value )
+{
+    m_disparitySigmaLayout->setValue( value );
+}
 
+void FilterControlWidget::setRegionSize( const int value )
+{
+    m_regionSizeLayout->setValue( value );
 }
 
 // DisparityControlWidget
@@ -901,6 +1253,7 @@ void DisparityControlWidget::initialize()
     m_bpControlWidget = new BPControlWidget( this );
     m_csbpControlWidget = new CSBPControlWidget( this );
     m_elasControlWidget = new ElasControlWidget( this );
+    m_censusControlWidget = new CensusControlWidget( this );
 
     m_bmControlIndex = m_stack->addWidget( m_bmControlWidget );
     m_gmControlIndex = m_stack->addWidget( m_gmControlWidget );
@@ -908,10 +1261,12 @@ void DisparityControlWidget::initialize()
     m_bpControlIndex = m_stack->addWidget( m_bpControlWidget );
     m_csbpControlIndex = m_stack->addWidget( m_csbpControlWidget );
     m_elasControlIndex = m_stack->addWidget( m_elasControlWidget );
+    m_censusControlIndex = m_stack->addWidget( m_censusControlWidget );
 
     m_filterControlWidget = new FilterControlWidget( this );
 
     layout->addWidget( m_stack );
+    layout->addWidget( m_filterControlWidget );
 
     connect( m_typeLayout, &TypeLayout::currentIndexChanged, this, &DisparityControlWidget::updateStackedWidget );
 
@@ -923,6 +1278,8 @@ void DisparityControlWidget::initialize()
     connect( m_bpControlWidget, &BPControlWidget::valueChanged, this, &DisparityControlWidget::valueChanged );
     connect( m_csbpControlWidget, &CSBPControlWidget::valueChanged, this, &DisparityControlWidget::valueChanged );
     connect( m_elasControlWidget, &ElasControlWidget::valueChanged, this, &DisparityControlWidget::valueChanged );
+    connect( m_censusControlWidget, &CensusControlWidget::valueChanged, this, &DisparityControlWidget::valueChanged );
+    connect( m_filterControlWidget, &FilterControlWidget::valueChanged, this, &DisparityControlWidget::valueChanged );
 
     updateStackedWidget();
 
@@ -958,6 +1315,16 @@ ElasControlWidget *DisparityControlWidget::elasControlWidget() const
     return m_elasControlWidget;
 }
 
+CensusControlWidget *DisparityControlWidget::censusControlWidget() const
+{
+    return m_censusControlWidget;
+}
+
+FilterControlWidget *DisparityControlWidget::filterControlWidget() const
+{
+    return m_filterControlWidget;
+}
+
 bool DisparityControlWidget::isBmMethod() const
 {
     return m_typeLayout->value() == TypeComboBox::BM;
@@ -988,6 +1355,58 @@ bool DisparityControlWidget::isElasMethod() const
     return m_typeLayout->value() == TypeComboBox::ELAS;
 }
 
+bool DisparityControlWidget::isCensusMethod() const
+{
+    return m_typeLayout->value() == TypeComboBox::CENSUS;
+}
+
+void DisparityControlWidget::setParameters( const DisparityParameters &parameters )
+{
+    // Report a single change instead of one per control
+    blockSignals( true );
+
+    if ( parameters.method() == DisparityParameters::Method::BM ) {
+        auto &values = parameters.bmParameters();
+
+        m_bmControlWidget->setSadWindowSize( values.blockSize );
+        m_bmControlWidget->setMinDisparity( values.minDisparity );
+        m_bmControlWidget->setNumDisparities( values.numDisparities );
+        m_bmControlWidget->setPrefilterSize( values.preFilterSize );
+        m_bmControlWidget->setPrefilterCap( values.preFilterCap );
+        m_bmControlWidget->setTextureThreshold( values.textureThreshold );
+        m_bmControlWidget->setUniquessRatio( values.uniquenessRatio );
+        m_bmControlWidget->setSpeckleWindowSize( values.speckleWindowSize );
+        m_bmControlWidget->setSpeckleRange( values.speckleRange );
+        m_bmControlWidget->setDisp12MaxDiff( values.disp12MaxDiff );
+
+        m_typeLayout->setValue( TypeComboBox::BM );
+
+    }
+    else {
+        auto &values = parameters.gmParameters();
+
+        m_gmControlWidget->setMode( static_cast< GMTypeComboBox::Type >( values.mode ) );
+        m_gmControlWidget->setSadWindowSize( values.blockSize );
+        m_gmControlWidget->setMinDisparity( values.minDisparity );
+        m_gmControlWidget->setNumDisparities( values.numDisparities );
+        m_gmControlWidget->setPrefilterCap( values.preFilterCap );
+        m_gmControlWidget->setUniquessRatio( values.uniquenessRatio );
+        m_gmControlWidget->setSpeckleWindowSize( values.speckleWindowSize );
+        m_gmControlWidget->setSpeckleRange( values.speckleRange );
+        m_gmControlWidget->setDisp12MaxDiff( values.disp12MaxDiff );
+        m_gmControlWidget->setP1( values.p1 );
+        m_gmControlWidget->setP2( values.p2 );
+
+        m_typeLayout->setValue( TypeComboBox::GM );
+
+    }
+
+    blockSignals( false );
+
+    emit valueChanged();
+
+}
+
 void DisparityControlWidget::activateBmWidget() const
 {
     m_stack->setCurrentIndex( m_bmControlIndex );
@@ -1018,6 +1437,11 @@ void DisparityControlWidget::activateElasWidget() const
     m_stack->setCurrentIndex( m_elasControlIndex );
 }
 
+void DisparityControlWidget::activateCensusWidget() const
+{
+    m_stack->setCurrentIndex( m_censusControlIndex );
+}
+
 void DisparityControlWidget::activateWidget( const TypeComboBox::Type type ) const
 {
     switch( type ) {
@@ -1039,6 +1463,9 @@ void DisparityControlWidget::activateWidget( const TypeComboBox::Type type ) con
     case TypeComboBox::ELAS :
         activateElasWidget();
         break;
+    case TypeComboBox::CENSUS :
+        activateCensusWidget();
+        break;
 
     }
 }
@@ -7,6 +7,9 @@
 
 #include <opencv2/opencv.hpp>
 
+class DisparityParameters;
+
+class QCheckBox;
 class QHBoxLayout;
 class QLabel;
 class QSlider;
@@ -90,11 +93,12 @@ class TypeComboBox : public QComboBox
     Q_OBJECT
 
 public:
-    enum Type { BM, GM, BM_GPU, BP, CSBP, ELAS };
+    enum Type { BM, GM, BM_GPU, BP, CSBP, ELAS, CENSUS };
 
     explicit TypeComboBox( QWidget *parent = nullptr );
 
     Type currentType() const;
+    void setCurrentType( const Type value );
 
 private:
     void initialize();
@@ -109,6 +113,7 @@ public:
     explicit TypeLayout( QWidget* parent = nullptr );
 
     TypeComboBox::Type value() const;
+    void setValue( const TypeComboBox::Type value );
 
 signals:
     void currentIndexChanged( int index );
@@ -136,6 +141,7 @@ public:
     explicit GMTypeComboBox( QWidget *parent = nullptr );
 
     Type currentType() const;
+    void setCurrentType( const Type value );
 
 private:
     void initialize();
@@ -150,6 +156,7 @@ public:
     explicit GMTypeLayout( QWidget* parent = nullptr );
 
     GMTypeComboBox::Type value() const;
+    void setValue( const GMTypeComboBox::Type value );
 
 signals:
     void currentIndexChanged( int index );
@@ -163,6 +170,45 @@ private:
 
 };
 
+class CensusWindowComboBox : public QComboBox
+{
+    Q_OBJECT
+
+public:
+    enum Window { WINDOW_5X5, WINDOW_7X7, WINDOW_9X7 };
+
+    explicit CensusWindowComboBox( QWidget *parent = nullptr );
+
+    Window currentWindow() const;
+    void setCurrentWindow( const Window value );
+
+private:
+    void initialize();
+
+};
+
+class CensusWindowLayout : public QHBoxLayout
+{
+    Q_OBJECT
+
+public:
+    explicit CensusWindowLayout( QWidget* parent = nullptr );
+
+    CensusWindowComboBox::Window value() const;
+    void setValue( const CensusWindowComboBox::Window value );
+
+signals:
+    void currentIndexChanged( int index );
+
+protected:
+    QPointer< QLabel > m_label;
+    QPointer< CensusWindowComboBox > m_windowComboBox;
+
+private:
+    void initialize();
+
+};
+
 class BMControlWidget : public QWidget
 {
     Q_OBJECT
@@ -266,6 +312,7 @@ signals:
     void valueChanged();
 
 public slots:
+    void setMode( const GMTypeComboBox::Type value );
     void setPrefilterCap( const int value );
     void setSadWindowSize( const int value );
     void setMinDisparity( const int value );
@@ -294,6 +341,49 @@ private:
     void initialize();
 };
 
+class CensusControlWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    CensusControlWidget( QWidget* parent = nullptr );
+
+    CensusWindowComboBox::Window window() const;
+    int sadWindowSize() const;
+    int minDisparity() const;
+    int numDisparities() const;
+    int uniquessRatio() const;
+    int speckleWindowSize() const;
+    int speckleRange() const;
+    int disp12MaxDiff() const;
+
+signals:
+    void valueChanged();
+
+public slots:
+    void setWindow( const CensusWindowComboBox::Window value );
+    void setSadWindowSize( const int value );
+    void setMinDisparity( const int value );
+    void setNumDisparities( const int value );
+    void setUniquessRatio( const int value );
+    void setSpeckleWindowSize( const int value );
+    void setSpeckleRange( const int value );
+    void setDisp12MaxDiff( const int value );
+
+protected:
+    QPointer< CensusWindowLayout > m_windowLayout;
+    QPointer< IntSliderLayout > m_sadWindowSizeLayout;
+    QPointer< IntSliderLayout > m_minDisparityLayout;
+    QPointer< IntSliderLayout > m_numDisparitiesLayout;
+    QPointer< IntSliderLayout > m_uniquessRatioLayout;
+    QPointer< IntSliderLayout > m_speckleWindowSizeLayout;
+    QPointer< IntSliderLayout > m_speckleRangeLayout;
+    QPointer< IntSliderLayout > m_disp12MaxDiffLayout;
+
+private:
+    void initialize();
+};
+
 class BPControlWidget : public QWidget
 {
     Q_OBJECT
@@ -377,6 +467,40 @@ class FilterControlWidget : public QWidget
 public:
     FilterControlWidget( QWidget* parent = nullptr );
 
+    bool isRefinementEnabled() const;
+    bool isSubpixelEnabled() const;
+    int maxHoleWidth() const;
+    int iterations() const;
+    double spatialSigma() const;
+    double colorSigma() const;
+    double disparitySigma() const;
+
+    // Side of the centered region disparity is computed in, percent of the frame
+    int regionSize() const;
+
+signals:
+    void valueChanged();
+
+public slots:
+    void setRefinementEnabled( const bool value );
+    void setSubpixelEnabled( const bool value );
+    void setMaxHoleWidth( const int value );
+    void setIterations( const int value );
+    void setSpatialSigma( const double value );
+    void setColorSigma( const double value );
+    void setDisparitySigma( const double value );
+    void setRegionSize( const int value );
+
+protected:
+    QPointer< QCheckBox > m_refinementCheck;
+    QPointer< QCheckBox > m_subpixelCheck;
+    QPointer< IntSliderLayout > m_maxHoleWidthLayout;
+    QPointer< IntSliderLayout > m_iterationsLayout;
+    QPointer< DoubleSliderLayout > m_spatialSigmaLayout;
+    QPointer< DoubleSliderLayout > m_colorSigmaLayout;
+    QPointer< DoubleSliderLayout > m_disparitySigmaLayout;
+    QPointer< IntSliderLayout > m_regionSizeLayout;
+
 private:
     void initialize();
 };
@@ -394,6 +518,8 @@ public:
     BPControlWidget *bpControlWidget() const;
     CSBPControlWidget *csbpControlWidget() const;
     ElasControlWidget *elasControlWidget() const;
+    CensusControlWidget *censusControlWidget() const;
+    FilterControlWidget *filterControlWidget() const;
 
     bool isBmMethod() const;
     bool isGmMethod() const;
@@ -401,6 +527,9 @@ public:
     bool isBpMethod() const;
     bool isCsbpMethod() const;
     bool isElasMethod() const;
+    bool isCensusMethod() const;
+
+    void setParameters( const DisparityParameters &parameters );
 
 signals:
     void valueChanged();
@@ -412,6 +541,7 @@ public slots:
     void activateBpWidget() const;
     void activateCsbpWidget() const;
     void activateElasWidget() const;
+    void activateCensusWidget() const;
     void activateWidget( const TypeComboBox::Type type ) const;
 
 protected slots:
@@ -428,6 +558,7 @@ protected:
     QPointer< BPControlWidget > m_bpControlWidget;
     QPointer< CSBPControlWidget > m_csbpControlWidget;
     QPointer< ElasControlWidget > m_elasControlWidget;
+    QPointer< CensusControlWidget > m_censusControlWidget;
 
     QPointer< FilterControlWidget > m_filterControlWidget;
 
@@ -437,6 +568,7 @@ protected:
     int m_bpControlIndex;
     int m_csbpControlIndex;
     int m_elasControlIndex;
+    int m_censusControlIndex;
 
 private:
     void initialize();
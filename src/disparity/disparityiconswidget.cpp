@@ -23,11 +23,13 @@ void DisparityIcon::initialize()
 void DisparityIcon::setLeftFileName( const QString &fileName )
 {
     m_leftFileName = fileName;
+    m_time = std::chrono::system_clock::now();
 }
 
 void DisparityIcon::setRightFileName(const QString &fileName )
 {
     m_rightFileName = fileName;
+    m_time = std::chrono::system_clock::now();
 }
 
 const QString &DisparityIcon::leftFileName() const
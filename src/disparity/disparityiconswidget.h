@@ -21,6 +21,7 @@ public:
 
     StampedStereoImage stereoFrame() const;
 
+    // Identifies the image pair, renewed when a file changes
     void setTime( const std::chrono::time_point< std::chrono::system_clock > &time );
     const std::chrono::time_point< std::chrono::system_clock > &time() const;
 
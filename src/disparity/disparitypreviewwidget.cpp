@@ -9,9 +9,11 @@
 #include <opencv2/ximgproc.hpp>
 
 #include "src/common/pclwidget.h"
+#include "src/common/frametrace.h"
 
 #include "application.h"
 
+#include "src/common/disparityparameters.h"
 #include "src/common/functions.h"
 #include "src/common/fileslistwidget.h"
 
@@ -94,18 +96,18 @@ void DisparityWidgetBase::initialize()
 {
     setAttribute( Qt::WA_DeleteOnClose );
 
-    auto tabWidget = new QTabWidget( this );
+    m_tabWidget = new QTabWidget( this );
 
     m_view = new DisparityPreviewWidget( this );
-    tabWidget->resize(1200, 800);
+    m_tabWidget->resize(1200, 800);
     m_3dWidget = new ReconstructionViewWidget( this );
 
-    tabWidget->addTab( m_view, tr( "Disparity" ) );
-    tabWidget->addTab( m_3dWidget, tr( "3D priview" ) );
+    m_tabWidget->addTab( m_view, tr( "Disparity" ) );
+    m_tabWidget->addTab( m_3dWidget, tr( "3D priview" ) );
 
     m_controlWidget = new DisparityControlWidget( this );
 
-    addWidget( tabWidget );
+    addWidget( m_tabWidget );
     addWidget( m_controlWidget );
 
     connect( m_controlWidget, &DisparityControlWidget::valueChanged, this, &DisparityWidgetBase::valueChanged );
@@ -116,12 +118,19 @@ void DisparityWidgetBase::initialize()
     m_bpProcessor = std::shared_ptr< BPDisparityProcessor >( new BPDisparityProcessor );
     m_csbpProcessor = std::shared_ptr< CSBPDisparityProcessor >( new CSBPDisparityProcessor );
     m_elasProcessor = std::shared_ptr< ElasDisparityProcessor >( new ElasDisparityProcessor );
+    m_censusProcessor = std::shared_ptr< CensusDisparityProcessor >( new CensusDisparityProcessor );
+
+    m_refinement = std::shared_ptr< DisparityRefinement >( new DisparityRefinement );
 
     m_processor = std::shared_ptr< StereoResultProcessor >( new StereoResultProcessor );
 
     m_processorThread.setProcessor( m_processor );
 
+    m_outputs = 0;
+    updateOutputs();
+
     connect( &m_processorThread, &ProcessorThread::frameProcessed, this, &DisparityWidgetBase::updateFrame );
+    connect( m_tabWidget, &QTabWidget::currentChanged, this, &DisparityWidgetBase::updateOutputs );
 
 }
 
@@ -145,6 +154,16 @@ BPControlWidget *DisparityWidgetBase::bpControlWidget() const
     return m_controlWidget->bpControlWidget();
 }
 
+CensusControlWidget *DisparityWidgetBase::censusControlWidget() const
+{
+    return m_controlWidget->censusControlWidget();
+}
+
+FilterControlWidget *DisparityWidgetBase::filterControlWidget() const
+{
+    return m_controlWidget->filterControlWidget();
+}
+
 void DisparityWidgetBase::loadCalibrationFile( const QString &fileName )
 {
     m_processor->loadYaml( fileName.toStdString() );
@@ -163,10 +182,37 @@ void DisparityWidgetBase::loadCalibrationDialog()
         loadCalibrationFile( file );
 }
 
+bool DisparityWidgetBase::loadParametersFile( const QString &fileName )
+{
+    DisparityParameters parameters( fileName.toStdString() );
+
+    if ( parameters.isOk() )
+        m_controlWidget->setParameters( parameters );
+
+    return parameters.isOk();
+
+}
+
+void DisparityWidgetBase::loadParametersDialog()
+{
+    auto file = QFileDialog::getOpenFileName(
+                        this,
+                        tr( "Select disparity parameters file" ),
+                        QString(),
+                        tr( "Disparity parameters files (*.yaml)" )
+                );
+
+    if ( !file.isEmpty() && !loadParametersFile( file ) )
+        QMessageBox::warning( this, tr( "Disparity parameters" ), tr( "Can't load disparity parameters from %1" ).arg( file ) );
+
+}
+
 void DisparityWidgetBase::processFrame( const StampedStereoImage &frame )
 {
      if ( !frame.empty() ) {
 
+        m_frame = frame;
+
         if ( m_controlWidget->isBmMethod() ) {
             m_bmProcessor->setBlockSize( bmControlWidget()->sadWindowSize() );
             m_bmProcessor->setMinDisparity( bmControlWidget()->minDisparity() );
@@ -206,6 +252,19 @@ void DisparityWidgetBase::processFrame( const StampedStereoImage &frame )
 
             m_processor->setDisparityProcessor( m_gmProcessor );
 
+        }
+        else if ( m_controlWidget->isCensusMethod() ) {
+            m_censusProcessor->setWindow( static_cast< CensusDisparityProcessor::Window >( censusControlWidget()->window() ) );
+            m_censusProcessor->setBlockSize( censusControlWidget()->sadWindowSize() );
+            m_censusProcessor->setMinDisparity( censusControlWidget()->minDisparity() );
+            m_censusProcessor->setNumDisparities( censusControlWidget()->numDisparities() );
+            m_censusProcessor->setUniquenessRatio( censusControlWidget()->uniquessRatio() );
+            m_censusProcessor->setSpeckleWindowSize( censusControlWidget()->speckleWindowSize() );
+            m_censusProcessor->setSpeckleRange( censusControlWidget()->speckleRange() );
+            m_censusProcessor->setDisp12MaxDiff( censusControlWidget()->disp12MaxDiff() );
+
+            m_processor->setDisparityProcessor( m_censusProcessor );
+
         }
         else if ( m_controlWidget->isBpMethod() ) {
             m_bpProcessor->setNumDisparities( bpControlWidget()->numDisparities() );
@@ -228,26 +287,79 @@ void DisparityWidgetBase::processFrame( const StampedStereoImage &frame )
 
         }
 
+        if ( filterControlWidget()->isRefinementEnabled() ) {
+            m_refinement->setSubpixelEnabled( filterControlWidget()->isSubpixelEnabled() );
+            m_refinement->setMaxHoleWidth( filterControlWidget()->maxHoleWidth() );
+            m_refinement->setIterations( filterControlWidget()->iterations() );
+            m_refinement->setSpatialSigma( filterControlWidget()->spatialSigma() );
+            m_refinement->setColorSigma( filterControlWidget()->colorSigma() );
+            m_refinement->setDisparitySigma( filterControlWidget()->disparitySigma() );
+
+            m_processor->setRefinement( m_refinement );
+
+        }
+        else
+            m_processor->setRefinement( nullptr );
+
+        std::vector< cv::Rect > regions;
+
+        auto regionSize = filterControlWidget()->regionSize();
+        auto croppedSize = m_processor->croppedSize();
+
+        if ( regionSize < 100 && !croppedSize.empty() ) {
+            cv::Size size( croppedSize.width * regionSize / 100, croppedSize.height * regionSize / 100 );
+            regions.push_back( cv::Rect( cv::Point( ( croppedSize.width - size.width ) / 2, ( croppedSize.height - size.height ) / 2 ), size ) );
+        }
+
+        if ( regions != m_processor->regions() )
+            m_processor->setRegions( regions );
+
         m_processorThread.process( frame );
 
     }
 
 }
 
+void DisparityWidgetBase::updateOutputs()
+{
+    // Only the products of the shown tab are computed
+    auto outputs = m_tabWidget->currentWidget() == m_3dWidget ? StereoResultProcessor::POINT_CLOUD
+                                                               : StereoResultProcessor::PREVIEW | StereoResultProcessor::COLORIZED_DISPARITY;
+
+    if ( outputs == m_outputs )
+        return;
+
+    m_processor->unsubscribe( m_outputs );
+    m_processor->subscribe( outputs );
+
+    m_outputs = outputs;
+
+    // A still image gets no new frame, the last one produces the new outputs from its memoized disparity
+    processFrame( m_frame );
+
+}
+
 void DisparityWidgetBase::updateFrame()
 {
     auto result = m_processorThread.result();
 
-    m_view->rectifyView()->setImage( result.previewImage() );
+    if ( !result.previewImage().empty() )
+        m_view->rectifyView()->setImage( result.previewImage() );
 
-    m_view->disparityView()->setImage( result.colorizedDisparity() );
+    if ( !result.colorizedDisparity().empty() ) {
+        m_view->disparityView()->setImage( result.colorizedDisparity() );
+
+        LatencyMonitor::instance().finish( result.frame().trace(), "disparity view" );
+
+    }
 
     if ( result.pointCloud() && !result.pointCloud()->empty() ) {
         m_3dWidget->setPointCloud( result.pointCloud() );
         m_3dWidget->update();
 
-    }
+        LatencyMonitor::instance().finish( result.frame().trace(), "point cloud view" );
 
+    }
 
 }
 
@@ -260,6 +372,9 @@ CameraDisparityWidget::CameraDisparityWidget( const QString &leftCameraIp, const
 
 void CameraDisparityWidget::initialize()
 {
+    // Consecutive camera frames are similar, ELAS verifies the previous support points instead of searching them again
+    m_elasProcessor->setSupportReuse( true );
+
     connect( &m_camera, &StereoCamera::receivedFrame, this, &CameraDisparityWidget::updateFrame );
 }
 
@@ -319,10 +434,16 @@ void ImageDisparityWidget::loadCalibrationFile( const QString &fileName )
     m_disparityWidget->loadCalibrationFile( fileName );
 }
 
+bool ImageDisparityWidget::loadParametersFile( const QString &fileName )
+{
+    return m_disparityWidget->loadParametersFile( fileName );
+}
+
 void ImageDisparityWidget::addIcon( const QString &leftFileName, const QString &rightFileName )
 {
-    CvImage leftImg = cv::imread( leftFileName.toStdString() );
-    CvImage rightImg = cv::imread( rightFileName.toStdString() );
+    // Icons only need a thumbnail, full frames are reloaded from the files on activation
+    CvImage leftImg = cv::imread( leftFileName.toStdString(), cv::IMREAD_REDUCED_COLOR_4 );
+    CvImage rightImg = cv::imread( rightFileName.toStdString(), cv::IMREAD_REDUCED_COLOR_4 );
 
     if ( !leftImg.empty() && !rightImg.empty() ) {
         m_iconsWidget->addIcon( new DisparityIcon( makeOverlappedPreview( leftImg, rightImg ) , leftFileName, rightFileName, QObject::tr("Frame") + " " + QString::number( m_iconCount++ ) ) );
@@ -337,6 +458,11 @@ void ImageDisparityWidget::loadCalibrationDialog()
     updateFrame();
 }
 
+void ImageDisparityWidget::loadParametersDialog()
+{
+    m_disparityWidget->loadParametersDialog();
+}
+
 void ImageDisparityWidget::importDialog()
 {
     StereoFilesListDialog dlg( this );
@@ -358,6 +484,7 @@ void ImageDisparityWidget::importDialog()
 void ImageDisparityWidget::clearIcons()
 {
     m_iconsWidget->clear();
+    m_frame = StampedStereoImage();
 
     dropIconCount();
 }
@@ -373,6 +500,10 @@ void ImageDisparityWidget::updateFrame()
 
 void ImageDisparityWidget::updateFrame( DisparityIcon* icon )
 {
-    m_disparityWidget->processFrame( icon->stereoFrame() );
+    if ( m_frame.empty() || m_frame.leftImage().time() != icon->time() )
+        m_frame = icon->stereoFrame();
+
+    m_disparityWidget->processFrame( m_frame );
+
 }
 
@@ -8,17 +8,22 @@
 #include "processorthread.h"
 #include "elasprocessor.h"
 
+#include "src/common/censusprocessor.h"
+#include "src/common/disparityrefinement.h"
 #include "src/common/vimbacamera.h"
 
 #include "src/common/pclwidget.h"
 #include "src/common/calibrationdatabase.h"
 
 class ImageWidget;
+class QTabWidget;
 class DisparityControlWidget;
 class BMControlWidget;
 class BMGPUControlWidget;
 class GMControlWidget;
 class BPControlWidget;
+class CensusControlWidget;
+class FilterControlWidget;
 class DisparityIcon;
 class DisparityIconsWidget;
 
@@ -65,8 +70,11 @@ public:
     GMControlWidget *gmControlWidget() const;
     BMGPUControlWidget *bmGpuControlWidget() const;
     BPControlWidget *bpControlWidget() const;
+    CensusControlWidget *censusControlWidget() const;
+    FilterControlWidget *filterControlWidget() const;
 
     void loadCalibrationFile( const QString &fileName );
+    bool loadParametersFile( const QString &fileName );
 
 signals:
     void valueChanged();
@@ -75,11 +83,14 @@ public slots:
     void processFrame( const StampedStereoImage &frame );
 
     void loadCalibrationDialog();
+    void loadParametersDialog();
 
 private slots:
     void updateFrame();
+    void updateOutputs();
 
 protected:
+    QPointer< QTabWidget > m_tabWidget;
     QPointer< DisparityPreviewWidget > m_view;
     QPointer< DisparityControlWidget > m_controlWidget;
     QPointer< ReconstructionViewWidget > m_3dWidget;
@@ -92,9 +103,18 @@ protected:
     std::shared_ptr< BPDisparityProcessor > m_bpProcessor;
     std::shared_ptr< CSBPDisparityProcessor > m_csbpProcessor;
     std::shared_ptr< ElasDisparityProcessor > m_elasProcessor;
+    std::shared_ptr< CensusDisparityProcessor > m_censusProcessor;
+
+    std::shared_ptr< DisparityRefinement > m_refinement;
 
     std::shared_ptr< StereoResultProcessor > m_processor;
 
+    // Processor outputs the visible tab subscribed to
+    int m_outputs;
+
+    // Last processed frame, processed again when the outputs change
+    StampedStereoImage m_frame;
+
     ProcessorThread m_processorThread;
 
     // std::chrono::time_point< std::chrono::system_clock > m_time;
@@ -135,12 +155,14 @@ public:
     GMControlWidget *gmControlWidget() const;
 
     void loadCalibrationFile( const QString &fileName );
+    bool loadParametersFile( const QString &fileName );
     void addIcon( const QString &leftFileName, const QString &rightFileName );
 
     int m_iconCount;
 
 public slots:
     void loadCalibrationDialog();
+    void loadParametersDialog();
     void importDialog();
 
     void clearIcons();
@@ -153,6 +175,9 @@ protected:
     QPointer< DisparityWidgetBase > m_disparityWidget;
     QPointer< DisparityIconsWidget > m_iconsWidget;
 
+    // Last loaded pair, parameter changes process it again without decoding the files
+    StampedStereoImage m_frame;
+
 private:
     void initialize();
 
@@ -43,6 +43,11 @@ void CameraDisparityDocument::loadCalibrationDialog()
     widget()->loadCalibrationDialog();
 }
 
+void CameraDisparityDocument::loadParametersDialog()
+{
+    widget()->loadParametersDialog();
+}
+
 // ImageDisparityDocument
 ImageDisparityDocument::ImageDisparityDocument( QWidget* parent )
     : DisparityDocumentBase( parent )
@@ -70,6 +75,11 @@ void ImageDisparityDocument::loadCalibrationDialog()
     widget()->loadCalibrationDialog();
 }
 
+void ImageDisparityDocument::loadParametersDialog()
+{
+    widget()->loadParametersDialog();
+}
+
 void ImageDisparityDocument::importDialog()
 {
     widget()->importDialog();
@@ -18,6 +18,7 @@ public:
 
 public slots:
     virtual void loadCalibrationDialog() = 0;
+    virtual void loadParametersDialog() = 0;
 
 private:
     void initialize();
@@ -38,6 +39,7 @@ public:
 
 public slots:
     virtual void loadCalibrationDialog() override;
+    virtual void loadParametersDialog() override;
 
 private:
     void initialize( const QString &leftCameraIp, const QString &rightCameraIp );
@@ -57,6 +59,7 @@ public:
 
 public slots:
     virtual void loadCalibrationDialog() override;
+    virtual void loadParametersDialog() override;
     void importDialog();
 
     void clearIcons();
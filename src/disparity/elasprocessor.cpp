@@ -3,8 +3,19 @@
 #include "elasprocessor.h"
 
 #include "src/common/functions.h"
+#include "src/common/taskscheduler.h"
 
 #include "src/libelas/StereoEfficientLargeScale.h"
+#include "src/libelas/parallel.h"
+
+// Columns replicated on both sides, so pixels near the image edges still find matches
+static const int BORDER = 200;
+
+// libelas loops on the shared scheduler
+static void elasParallelForHook( const int32_t begin, const int32_t end, const std::function< void( int32_t ) > &body, const int32_t grain )
+{
+    parallelFor( begin, end, body, TaskScheduler::TRACKING, grain );
+}
 
 // ElasDisparityProcessor
 ElasDisparityProcessor::ElasDisparityProcessor()
@@ -15,16 +26,77 @@ ElasDisparityProcessor::ElasDisparityProcessor()
 
 void ElasDisparityProcessor::initialize()
 {
+    setParallelForHook( &elasParallelForHook, TaskScheduler::instance().threadsCount() );
+
     m_matcher = cv::Ptr< StereoEfficientLargeScale >( new StereoEfficientLargeScale() );
 }
 
+int ElasDisparityProcessor::getNumDisparities() const
+{
+    return m_matcher->elas.disparityMax() + 1;
+}
+
+void ElasDisparityProcessor::setNumDisparities( const int value )
+{
+    m_matcher->elas.setDisparityRange( 0, std::max( 1, value ) - 1 );
+}
+
+int ElasDisparityProcessor::getTileHeight() const
+{
+    return m_matcher->getTileHeight();
+}
+
+void ElasDisparityProcessor::setTileHeight( const int value )
+{
+    m_matcher->setTiles( value, m_matcher->getTileOverlap() );
+}
+
+int ElasDisparityProcessor::getTileOverlap() const
+{
+    return m_matcher->getTileOverlap();
+}
+
+void ElasDisparityProcessor::setTileOverlap( const int value )
+{
+    m_matcher->setTiles( m_matcher->getTileHeight(), value );
+}
+
+bool ElasDisparityProcessor::getSupportReuse() const
+{
+    return m_matcher->elas.supportReuse();
+}
+
+void ElasDisparityProcessor::setSupportReuse( const bool value )
+{
+    m_matcher->elas.setSupportReuse( value );
+}
+
 cv::Mat ElasDisparityProcessor::processDisparity( const CvImage &left, const CvImage &right )
 {
     cv::Mat dest;
 
-    m_matcher->operator()( left, right, dest, 200 );
+    m_matcher->operator()( left, right, dest, BORDER );
 
     return dest;
 
 }
 
+cv::Range ElasDisparityProcessor::disparityRange() const
+{
+    return cv::Range( 0, getNumDisparities() );
+}
+
+int ElasDisparityProcessor::supportRadius() const
+{
+    // Support points interpolation grid, so the region keeps its own support points
+    return 20;
+}
+
+std::vector< double > ElasDisparityProcessor::parameters() const
+{
+    // Reused support points make the result depend on the previous frame
+    if ( getSupportReuse() )
+        return std::vector< double >();
+
+    return { double( getNumDisparities() ), double( getTileHeight() ), double( getTileOverlap() ) };
+}
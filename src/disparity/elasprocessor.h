@@ -9,8 +9,26 @@ class ElasDisparityProcessor : public DisparityProcessorBase
 public:
     ElasDisparityProcessor();
 
+    int getNumDisparities() const;
+    void setNumDisparities( const int value );
+
+    // Rows per tile for large images, zero processes the whole image at once
+    int getTileHeight() const;
+    void setTileHeight( const int value );
+
+    int getTileOverlap() const;
+    void setTileOverlap( const int value );
+
+    // Video input: seed support points with the previous frame, not used in tiled mode
+    bool getSupportReuse() const;
+    void setSupportReuse( const bool value );
+
     virtual cv::Mat processDisparity( const CvImage &left, const CvImage &right ) override;
 
+    virtual cv::Range disparityRange() const override;
+    virtual int supportRadius() const override;
+    virtual std::vector< double > parameters() const override;
+
 protected:
     cv::Ptr< StereoEfficientLargeScale > m_matcher;
 
@@ -4,7 +4,9 @@
 
 #include "disparitypreviewwidget.h"
 #include "documentwidget.h"
+#include "src/common/frametrace.h"
 #include "src/common/ipwidget.h"
+#include "src/common/profiler.h"
 
 #include "disparitychoicedialog.h"
 
@@ -97,6 +99,15 @@ void MainWindow::loadCalibrationDialog()
 
 }
 
+void MainWindow::loadParametersDialog()
+{
+    auto doc = currentDisparityDocument();
+
+    if ( doc )
+        doc->loadParametersDialog();
+
+}
+
 
 void MainWindow::importDialog()
 {
@@ -111,6 +122,43 @@ void MainWindow::exportDialog()
 {
 }
 
+void MainWindow::saveLatencyDialog()
+{
+    auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save frame latency statistics" ), QString(),
+                                                  tr( "Frame latency statistics (*.csv)" ), nullptr,
+                                                  QFileDialog::DontUseNativeDialog );
+
+    if ( !fileName.isEmpty() )
+        LatencyMonitor::instance().saveCsv( fileName.toStdString() );
+
+}
+
+void MainWindow::saveProfileDialog()
+{
+    auto csvFilter = tr( "Profile statistics (*.csv)" );
+    auto jsonFilter = tr( "Profile statistics (*.json)" );
+    auto traceFilter = tr( "Chrome trace (*.json)" );
+
+    QString selectedFilter;
+
+    auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save profile" ), QString(),
+                                                  csvFilter + ";;" + jsonFilter + ";;" + traceFilter, &selectedFilter,
+                                                  QFileDialog::DontUseNativeDialog );
+
+    if ( !fileName.isEmpty() ) {
+        auto &profiler = Profiler::instance();
+
+        if ( selectedFilter == traceFilter )
+            profiler.saveChromeTrace( fileName.toStdString() );
+        else if ( selectedFilter == jsonFilter )
+            profiler.saveJson( fileName.toStdString() );
+        else
+            profiler.saveCsv( fileName.toStdString() );
+
+    }
+
+}
+
 void MainWindow::clearIcons()
 {
     auto doc = currentImageDisparityDocument();
@@ -133,10 +181,14 @@ void MainWindow::setupActions()
 {
     m_newDisparityDocumentAction = new QAction( QIcon( ":/resources/images/new.ico" ), tr( "New disparity document" ), this );
     m_loadCalibrationAction = new QAction( QIcon( ":/resources/images/open.ico" ), tr( "Load calibration file" ), this );
+    m_loadParametersAction = new QAction( QIcon( ":/resources/images/open.ico" ), tr( "Load disparity parameters" ), this );
 
     m_importAction = new QAction( QIcon( ":/resources/images/export.ico" ), tr( "Import" ), this );
     m_exportAction = new QAction( QIcon( ":/resources/images/import.ico" ), tr( "Export" ), this );
 
+    m_saveLatencyAction = new QAction( QIcon( ":/resources/images/save.ico" ), tr( "Save frame latency" ), this );
+    m_saveProfileAction = new QAction( QIcon( ":/resources/images/export.ico" ), tr( "Save profile" ), this );
+
     m_clearIconsAction = new QAction( QIcon( ":/resources/images/trash.ico" ), tr( "Clear" ), this );
 
     m_settingsAction = new QAction( QIcon( ":/resources/images/settings.ico" ), tr( "Settings" ), this );
@@ -146,10 +198,14 @@ void MainWindow::setupActions()
     connect( m_newDisparityDocumentAction, &QAction::triggered, this, &MainWindow::choiceDisparityDialog );
 
     connect( m_loadCalibrationAction, &QAction::triggered, this, &MainWindow::loadCalibrationDialog );
+    connect( m_loadParametersAction, &QAction::triggered, this, &MainWindow::loadParametersDialog );
 
     connect( m_importAction, &QAction::triggered, this, &MainWindow::importDialog );
     connect( m_exportAction, &QAction::triggered, this, &MainWindow::exportDialog );
 
+    connect( m_saveLatencyAction, &QAction::triggered, this, &MainWindow::saveLatencyDialog );
+    connect( m_saveProfileAction, &QAction::triggered, this, &MainWindow::saveProfileDialog );
+
     connect( m_clearIconsAction, &QAction::triggered, this, &MainWindow::clearIcons );
     connect( m_settingsAction, &QAction::triggered, this, &MainWindow::settingsDialog );
     connect( m_exitAction, &QAction::triggered, this, &MainWindow::close );
@@ -164,6 +220,7 @@ void MainWindow::setupMenus()
     fileMenu->addAction( m_newDisparityDocumentAction );
     fileMenu->addSeparator();
     fileMenu->addAction( m_loadCalibrationAction );
+    fileMenu->addAction( m_loadParametersAction );
     fileMenu->addSeparator();
     fileMenu->addAction( m_importAction );
     fileMenu->addAction( m_exportAction );
@@ -173,6 +230,9 @@ void MainWindow::setupMenus()
     auto actionsMenu = m_menuBar->addMenu( tr( "Actions" ) );
     actionsMenu->addAction( m_clearIconsAction );
     actionsMenu->addSeparator();
+    actionsMenu->addAction( m_saveLatencyAction );
+    actionsMenu->addAction( m_saveProfileAction );
+    actionsMenu->addSeparator();
     actionsMenu->addAction( m_settingsAction );
 
     auto helpMenu = m_menuBar->addMenu( tr( "Help" ) );
@@ -34,10 +34,14 @@ public slots:
     void addCameraDisparityDialog();
 
     void loadCalibrationDialog();
+    void loadParametersDialog();
 
     void importDialog();
     void exportDialog();
 
+    void saveLatencyDialog();
+    void saveProfileDialog();
+
     void clearIcons();
     void settingsDialog();
 
@@ -48,10 +52,14 @@ protected:
 
     QPointer< QAction > m_newDisparityDocumentAction;
     QPointer< QAction > m_loadCalibrationAction;
+    QPointer< QAction > m_loadParametersAction;
 
     QPointer< QAction > m_importAction;
     QPointer< QAction > m_exportAction;
 
+    QPointer< QAction > m_saveLatencyAction;
+    QPointer< QAction > m_saveProfileAction;
+
     QPointer< QAction > m_clearIconsAction;
 
     QPointer< QAction > m_settingsAction;
@@ -2,33 +2,42 @@
 
 #include "processorthread.h"
 
+#include "src/common/frametrace.h"
 #include "src/common/functions.h"
 
 // ProcessorThread
 ProcessorThread::ProcessorThread( QObject *parent )
-    : QThread( parent )
+    : QObject( parent )
 {
     initialize();
 }
 
 void ProcessorThread::initialize()
 {
+    m_busy = false;
 }
 
 bool ProcessorThread::process( const StampedStereoImage &frame )
 {
     bool res = false;
+    bool idle = false;
 
-    if ( m_processMutex.tryLock() ) {
-        if ( !isRunning() ) {
-            m_frame = frame;
-            start();
-            res = true;
-        }
+    if ( m_busy.compare_exchange_strong( idle, true ) ) {
+        m_frame = frame;
+        m_frame.trace().mark( "queue" );
+
+        m_tasks.run( [ this ] {
+            run();
+            m_busy = false;
+        } );
+
+        res = true;
 
-        m_processMutex.unlock();
     }
 
+    if ( !res )
+        LatencyMonitor::instance().drop( frame.trace(), "disparity" );
+
     return res;
 
 }
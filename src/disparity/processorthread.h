@@ -2,11 +2,15 @@
 
 #include "stereoresultprocessor.h"
 #include "src/common/rectificationprocessor.h"
+#include "src/common/taskscheduler.h"
 
-#include <QThread>
+#include <QObject>
 #include <QMutex>
 
-class ProcessorThread : public QThread
+#include <atomic>
+
+// Processes one frame at a time as a task of the shared scheduler, frames arriving meanwhile are dropped
+class ProcessorThread : public QObject
 {
     Q_OBJECT
 
@@ -24,14 +28,17 @@ signals:
 
 protected:
     StampedStereoImage m_frame;
-    QMutex m_processMutex;
+    std::atomic< bool > m_busy;
 
     StereoResult m_result;
     QMutex m_resultMutex;
 
     std::shared_ptr< StereoResultProcessor > m_processor;
 
-    virtual void run() override;
+    // Declared last, so a running frame finishes before the other members are destroyed
+    TaskGroup m_tasks;
+
+    void run();
 
 private:
     void initialize();
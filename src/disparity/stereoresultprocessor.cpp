@@ -3,6 +3,7 @@
 #include "stereoresultprocessor.h"
 
 #include "src/common/functions.h"
+#include "src/common/profiler.h"
 
 // StereoResult
 StereoResult::StereoResult()
@@ -22,12 +23,16 @@ void StereoResult::setPreviewImage( const CvImage &value )
 void StereoResult::setDisparity( const cv::Mat &value )
 {
     m_disparity = value;
-    m_colorizedDisparity = colorizeDisparity( m_disparity );
 }
 
-void StereoResult::setPoints( const cv::Mat &value )
+void StereoResult::setColorizedDisparity( const CvImage &value )
 {
-    m_points = value;
+    m_colorizedDisparity = value;
+}
+
+void StereoResult::setDepth( const cv::Mat &value )
+{
+    m_depth = value;
 }
 
 void StereoResult::setPointCloud( const pcl::PointCloud< pcl::PointXYZRGB >::Ptr &value )
@@ -50,9 +55,9 @@ const CvImage &StereoResult::colorizedDisparity() const
     return m_colorizedDisparity;
 }
 
-const cv::Mat &StereoResult::points() const
+const cv::Mat &StereoResult::depth() const
 {
-    return m_points;
+    return m_depth;
 }
 
 pcl::PointCloud< pcl::PointXYZRGB >::Ptr StereoResult::pointCloud() const
@@ -83,11 +88,50 @@ const StampedImage &StereoResult::rightFrame() const
 // StereoResultProcessor
 StereoResultProcessor::StereoResultProcessor()
 {
+    initialize();
 }
 
 StereoResultProcessor::StereoResultProcessor( const std::shared_ptr< DisparityProcessorBase > &proc )
     : StereoProcessor( proc )
 {
+    initialize();
+}
+
+void StereoResultProcessor::initialize()
+{
+    for ( auto &i : m_subscriptions )
+        i = 0;
+
+    m_calibrationRevision = 0;
+
+}
+
+void StereoResultProcessor::subscribe( const int outputs )
+{
+    for ( int i = 0; i < OUTPUTS_COUNT; ++i )
+        if ( outputs & ( 1 << i ) )
+            ++m_subscriptions[ i ];
+
+}
+
+void StereoResultProcessor::unsubscribe( const int outputs )
+{
+    for ( int i = 0; i < OUTPUTS_COUNT; ++i )
+        if ( outputs & ( 1 << i ) )
+            --m_subscriptions[ i ];
+
+}
+
+int StereoResultProcessor::outputs() const
+{
+    int ret = 0;
+
+    for ( int i = 0; i < OUTPUTS_COUNT; ++i )
+        if ( m_subscriptions[ i ] > 0 )
+            ret |= 1 << i;
+
+    return ret;
+
 }
 
 void StereoResultProcessor::setCalibration( const StereoCalibrationDataShort &data )
@@ -102,6 +146,8 @@ void StereoResultProcessor::setCalibration( const StereoCalibrationDataShort &da
     calibration.projectionMatrix().movePrincipalPoint( principal );
 
     setDisparityToDepthMatrix( calibration.disparityToDepthMatrix() );
+
+    ++m_calibrationRevision;
 }
 
 bool StereoResultProcessor::loadYaml( const std::string &fileName )
@@ -116,43 +162,164 @@ bool StereoResultProcessor::loadYaml( const std::string &fileName )
     return ret;
 }
 
+void StereoResultProcessor::setRegions( const std::vector< cv::Rect > &value )
+{
+    m_regions = value;
+}
+
+const std::vector< cv::Rect > &StereoResultProcessor::regions() const
+{
+    return m_regions;
+}
+
+cv::Size StereoResultProcessor::croppedSize() const
+{
+    return m_rectificationProcessor.isValid() ? m_rectificationProcessor.calibration().cropRect().size() : cv::Size();
+}
+
+bool StereoResultProcessor::isCached( const StampedStereoImage &frame ) const
+{
+    auto &leftFrame = frame.leftImage();
+    auto &rightFrame = frame.rightImage();
+
+    return !m_cache.leftCroppedFrame.empty() && m_cache.calibrationRevision == m_calibrationRevision
+            && leftFrame.time() == m_cache.leftTime && rightFrame.time() == m_cache.rightTime
+            && leftFrame.size() == m_cache.leftSize && rightFrame.size() == m_cache.rightSize;
+}
+
+void StereoResultProcessor::clearCache()
+{
+    m_cache = Cache();
+    m_cache.calibrationRevision = 0;
+}
+
+std::vector< double > StereoResultProcessor::disparityKey() const
+{
+    auto ret = m_disparityProcessor->parameters();
+
+    if ( ret.empty() )
+        return ret;
+
+    ret.push_back( static_cast< double >( reinterpret_cast< uintptr_t >( m_disparityProcessor.get() ) ) );
+
+    auto preprocessing = m_disparityProcessor->preprocessor().parameters();
+    ret.insert( ret.end(), preprocessing.begin(), preprocessing.end() );
+
+    for ( auto &i : m_regions )
+        ret.insert( ret.end(), { double( i.x ), double( i.y ), double( i.width ), double( i.height ) } );
+
+    ret.push_back( m_regions.size() );
+
+    if ( m_refinement ) {
+        auto refinement = m_refinement->parameters();
+        ret.insert( ret.end(), refinement.begin(), refinement.end() );
+    }
+
+    ret.push_back( m_refinement != nullptr );
+
+    return ret;
+
+}
+
 StereoResult StereoResultProcessor::process( const StampedStereoImage &frame )
 {
+    ProfileZone zone( "stereo frame" );
+
     StereoResult ret;
 
     ret.setFrame( frame );
 
-    if ( !frame.empty() ) {
+    auto &trace = frame.trace();
+
+    trace.mark( "processing" );
+
+    // Read once, so a frame is consistent while consumers change their subscriptions
+    auto outputs = this->outputs();
 
-        auto leftFrame = frame.leftImage();
-        auto rightFrame = frame.rightImage();
+    if ( !frame.empty() && outputs != 0 && m_rectificationProcessor.isValid() ) {
 
-        if ( m_rectificationProcessor.isValid() ) {
+        if ( !isCached( frame ) ) {
+            auto &leftFrame = frame.leftImage();
+            auto &rightFrame = frame.rightImage();
 
             CvImage leftRectifiedFrame;
             CvImage rightRectifiedFrame;
 
-            CvImage leftCroppedFrame;
-            CvImage rightCroppedFrame;
+            clearCache();
+
+            m_cache.calibrationRevision = m_calibrationRevision;
 
             m_rectificationProcessor.rectify( leftFrame, rightFrame, &leftRectifiedFrame, &rightRectifiedFrame );
-            m_rectificationProcessor.crop( leftRectifiedFrame, rightRectifiedFrame, &leftCroppedFrame, &rightCroppedFrame );
+            m_rectificationProcessor.crop( leftRectifiedFrame, rightRectifiedFrame, &m_cache.leftCroppedFrame, &m_cache.rightCroppedFrame );
+
+            m_cache.leftTime = leftFrame.time();
+            m_cache.rightTime = rightFrame.time();
+            m_cache.leftSize = leftFrame.size();
+            m_cache.rightSize = rightFrame.size();
+
+            trace.mark( "rectification" );
+
+        }
+
+        if ( outputs & PREVIEW ) {
+
+            if ( m_cache.previewImage.empty() ) {
+                m_cache.previewImage = stackImages( m_cache.leftCroppedFrame, m_cache.rightCroppedFrame );
+                drawTraceLines( m_cache.previewImage, 20 );
+            }
+
+            ret.setPreviewImage( m_cache.previewImage );
+
+        }
+
+        if ( m_disparityProcessor && ( outputs & ~PREVIEW ) ) {
+
+            auto key = disparityKey();
+
+            if ( key.empty() || key != m_cache.disparityKey || m_cache.disparity.empty() ) {
+                m_cache.disparity = processDisparity( m_cache.leftCroppedFrame, m_cache.rightCroppedFrame, m_regions );
+                m_cache.disparityKey = key;
+
+                m_cache.colorizedDisparity = CvImage();
+                m_cache.depth = cv::Mat();
+                m_cache.pointCloud.reset();
+
+                trace.mark( "disparity" );
+
+            }
+
+            if ( outputs & DISPARITY )
+                ret.setDisparity( m_cache.disparity );
+
+            if ( outputs & COLORIZED_DISPARITY ) {
+
+                if ( m_cache.colorizedDisparity.empty() ) {
+                    m_colorizer.setRange( m_disparityProcessor->disparityRange() );
+                    m_cache.colorizedDisparity = m_colorizer.process( m_cache.disparity );
+                }
+
+                ret.setColorizedDisparity( m_cache.colorizedDisparity );
+
+            }
+
+            if ( outputs & ( DEPTH | POINT_CLOUD ) ) {
+
+                if ( m_cache.depth.empty() )
+                    m_cache.depth = reprojectDepth( m_cache.disparity, m_regions );
 
-            auto previewImage = stackImages( leftCroppedFrame, rightCroppedFrame );
-            drawTraceLines( previewImage, 20 );
+                if ( outputs & DEPTH )
+                    ret.setDepth( m_cache.depth );
 
-            ret.setPreviewImage( previewImage );
+                if ( outputs & POINT_CLOUD ) {
 
-            if ( m_disparityProcessor ) {
+                    if ( !m_cache.pointCloud )
+                        m_cache.pointCloud = produceDepthPointCloud( m_cache.depth, m_cache.leftCroppedFrame, m_regions );
 
-                auto disparity = processDisparity( leftCroppedFrame, rightCroppedFrame );
-                ret.setDisparity( disparity );
+                    ret.setPointCloud( m_cache.pointCloud );
 
-                cv::Mat points = reprojectPoints( disparity );
-                ret.setPoints( points );
+                }
 
-                auto pointCloud = producePointCloud( points, leftCroppedFrame );
-                ret.setPointCloud( pointCloud );
+                trace.mark( "reprojection" );
 
             }
 
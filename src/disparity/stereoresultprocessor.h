@@ -1,7 +1,12 @@
 #pragma once
 
+#include "src/common/disparitycolorizer.h"
 #include "src/common/stereoprocessor.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+
 class StereoResult
 {
 public:
@@ -9,13 +14,15 @@ public:
 
     void setPreviewImage( const CvImage &value );
     void setDisparity( const cv::Mat &value );
-    void setPoints( const cv::Mat &value );
+    void setColorizedDisparity( const CvImage &value );
+    void setDepth( const cv::Mat &value );
     void setPointCloud( const pcl::PointCloud< pcl::PointXYZRGB >::Ptr &value );
 
     const CvImage &previewImage() const;
     const cv::Mat &disparity() const;
     const CvImage &colorizedDisparity() const;
-    const cv::Mat &points() const;
+    // CV_16U millimeters, StereoProcessor::depthPoint gives the points
+    const cv::Mat &depth() const;
     pcl::PointCloud< pcl::PointXYZRGB >::Ptr pointCloud() const;
 
     void setFrame( const StampedStereoImage &frame );
@@ -28,7 +35,7 @@ protected:
     CvImage m_previewImage;
     cv::Mat m_disparity;
     CvImage m_colorizedDisparity;
-    cv::Mat m_points;
+    cv::Mat m_depth;
     pcl::PointCloud< pcl::PointXYZRGB >::Ptr m_pointCloud;
 
     StampedStereoImage m_frame;
@@ -41,15 +48,74 @@ private:
 class StereoResultProcessor : public StereoProcessor
 {
 public:
+    enum Output { PREVIEW = 0x1, DISPARITY = 0x2, COLORIZED_DISPARITY = 0x4, DEPTH = 0x8, POINT_CLOUD = 0x10 };
+
     StereoResultProcessor();
     StereoResultProcessor( const std::shared_ptr< DisparityProcessorBase > &proc );
 
     void setCalibration( const StereoCalibrationDataShort &data );
     bool loadYaml( const std::string &fileName );
 
+    // Regions of the cropped rectified frame to compute depth in, empty for the whole frame
+    void setRegions( const std::vector< cv::Rect > &value );
+    const std::vector< cv::Rect > &regions() const;
+
+    // Size of the cropped rectified frame, empty without calibration
+    cv::Size croppedSize() const;
+
+    // Consumers subscribe to the outputs they use, the ones nobody subscribed to are not produced
+    void subscribe( const int outputs );
+    void unsubscribe( const int outputs );
+    int outputs() const;
+
     StereoResult process( const StampedStereoImage &frame );
 
 protected:
+    static const int OUTPUTS_COUNT = 5;
+
     StereoRectificationProcessor m_rectificationProcessor;
 
+    std::vector< cv::Rect > m_regions;
+
+    DisparityColorizer m_colorizer;
+
+    // Subscribers count by output bit
+    std::array< std::atomic< int >, OUTPUTS_COUNT > m_subscriptions;
+
+    // Products of the last frame. A stage runs again only when its input or parameters changed,
+    // so a still processed with new disparity parameters is not rectified again
+    struct Cache
+    {
+        std::chrono::time_point< std::chrono::system_clock > leftTime;
+        std::chrono::time_point< std::chrono::system_clock > rightTime;
+        cv::Size leftSize;
+        cv::Size rightSize;
+        unsigned int calibrationRevision;
+
+        CvImage leftCroppedFrame;
+        CvImage rightCroppedFrame;
+        CvImage previewImage;
+
+        std::vector< double > disparityKey;
+        cv::Mat disparity;
+        CvImage colorizedDisparity;
+        cv::Mat depth;
+        pcl::PointCloud< pcl::PointXYZRGB >::Ptr pointCloud;
+    };
+
+    Cache m_cache;
+
+    // Counts calibration changes, the cache is checked against it on the processing thread
+    std::atomic< unsigned int > m_calibrationRevision;
+
+    bool isCached( const StampedStereoImage &frame ) const;
+    void clearCache();
+
+    // Disparity processor identity, preprocessing and parameters, regions and refinement settings. Empty when the processor
+    // does not know its parameters
+    std::vector< double > disparityKey() const;
+
+private:
+    void initialize();
+
 };
@@ -0,0 +1,355 @@
+#include "src/common/precompiled.h"
+
+#include "src/common/bpprocessor.h"
+#include "src/common/censusprocessor.h"
+#include "src/common/disparityevaluation.h"
+#include "src/common/stereoprocessor.h"
+#include "src/common/taskscheduler.h"
+#include "src/common/tictoc.h"
+
+#include "src/benchmark/benchmark.h"
+#include "src/disparity/elasprocessor.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <omp.h>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static const int DISPARITY_ALIGN = 16;
+
+struct EvaluationResult
+{
+    std::string engine;
+    std::string sample;
+
+    cv::Size size;
+    int numDisparities;
+
+    // milliseconds, median over runs
+    double time;
+
+    // Everything allocated while one frame is processed, freed memory is not subtracted, so it is not the peak
+    double allocationsPerFrame;
+    double bytesPerFrame;
+
+    DisparityMetrics metrics;
+};
+
+static int alignedDisparities( const int maxDisparity )
+{
+    return std::max( DISPARITY_ALIGN, ( maxDisparity + DISPARITY_ALIGN - 1 ) / DISPARITY_ALIGN * DISPARITY_ALIGN );
+}
+
+// Parameters follow the disparity app defaults, the disparity range follows the sample
+static std::shared_ptr< DisparityProcessorBase > createProcessor( const std::string &engine, const int numDisparities )
+{
+    if ( engine == "bm" ) {
+        auto ret = std::make_shared< BMDisparityProcessor >();
+
+        ret->setBlockSize( 7 );
+        ret->setPreFilterSize( 15 );
+        ret->setPreFilterCap( 12 );
+        ret->setMinDisparity( 0 );
+        ret->setNumDisparities( numDisparities );
+        ret->setTextureThreshold( 450 );
+        ret->setUniquenessRatio( 55 );
+        ret->setSpeckleWindowSize( 55 );
+        ret->setSpeckleRange( 5 );
+        ret->setDisp12MaxDiff( 0 );
+
+        return ret;
+
+    }
+    else if ( engine == "sgbm" ) {
+        auto ret = std::make_shared< GMDisparityProcessor >();
+
+        const int blockSize = 11;
+
+        ret->setBlockSize( blockSize );
+        ret->setPreFilterCap( 50 );
+        ret->setMinDisparity( 0 );
+        ret->setNumDisparities( numDisparities );
+        ret->setUniquenessRatio( 30 );
+        ret->setSpeckleWindowSize( 20 );
+        ret->setSpeckleRange( 10 );
+        ret->setDisp12MaxDiff( 0 );
+
+        // OpenCV recommended smoothness penalties for single channel input
+        ret->setP1( 8 * blockSize * blockSize );
+        ret->setP2( 32 * blockSize * blockSize );
+
+        return ret;
+
+    }
+    else if ( engine == "census" ) {
+        auto ret = std::make_shared< CensusDisparityProcessor >();
+
+        ret->setMinDisparity( 0 );
+        ret->setNumDisparities( numDisparities );
+
+        return ret;
+
+    }
+    else if ( engine == "bp" ) {
+        auto ret = std::make_shared< BPCPUDisparityProcessor >();
+
+        ret->setNumDisparities( numDisparities );
+
+        return ret;
+
+    }
+    else if ( engine == "elas" ) {
+        auto ret = std::make_shared< ElasDisparityProcessor >();
+
+        ret->setNumDisparities( numDisparities );
+
+        return ret;
+
+    }
+    else if ( engine == "elas-tiled" ) {
+        auto ret = std::make_shared< ElasDisparityProcessor >();
+
+        ret->setNumDisparities( numDisparities );
+        ret->setTileHeight( 256 );
+        ret->setTileOverlap( 32 );
+
+        return ret;
+
+    }
+
+    return nullptr;
+
+}
+
+static EvaluationResult evaluate( const std::string &engine, const StereoSample &sample, const int runs )
+{
+    EvaluationResult ret;
+    ret.engine = engine;
+    ret.sample = sample.name;
+    ret.size = sample.leftImage.size();
+    ret.numDisparities = alignedDisparities( sample.maxDisparity );
+
+    auto processor = createProcessor( engine, ret.numDisparities );
+
+    // Warm up caches and lazily created matcher buffers
+    processor->processDisparity( sample.leftImage, sample.rightImage );
+
+    AllocationCounter::start();
+    auto disparity = processor->processDisparity( sample.leftImage, sample.rightImage );
+    AllocationCounter::stop();
+
+    ret.allocationsPerFrame = AllocationCounter::count();
+    ret.bytesPerFrame = AllocationCounter::bytes();
+
+    std::vector< double > times;
+
+    for ( int i = 0; i < runs; ++i ) {
+        TicToc timer;
+        processor->processDisparity( sample.leftImage, sample.rightImage );
+        times.push_back( timer.toc() * 1000. );
+    }
+
+    std::nth_element( times.begin(), times.begin() + times.size() / 2, times.end() );
+    ret.time = times[ times.size() / 2 ];
+
+    ret.metrics = evaluateDisparity( disparity, sample.groundTruth );
+
+    return ret;
+
+}
+
+static void printHeader()
+{
+    std::cout << std::left << std::setw( 11 ) << "engine" << std::setw( 20 ) << "sample" << std::right << std::setw( 11 ) << "size"
+              << std::setw( 7 ) << "ndisp" << std::setw( 10 ) << "time, ms" << std::setw( 10 ) << "MB/frame" << std::setw( 9 ) << "density"
+              << std::setw( 8 ) << "bad0.5" << std::setw( 8 ) << "bad1" << std::setw( 8 ) << "bad2" << std::setw( 8 ) << "bad4"
+              << std::setw( 8 ) << "D1" << std::setw( 9 ) << "avg err" << std::setw( 9 ) << "rms err" << std::endl;
+}
+
+static void print( const EvaluationResult &result )
+{
+    std::cout << std::fixed << std::setprecision( 2 );
+
+    std::cout << std::left << std::setw( 11 ) << result.engine << std::setw( 20 ) << result.sample << std::right
+              << std::setw( 11 ) << ( result.size.empty() ? "-" : std::to_string( result.size.width ) + "x" + std::to_string( result.size.height ) )
+              << std::setw( 7 ) << ( result.numDisparities > 0 ? std::to_string( result.numDisparities ) : "-" )
+              << std::setw( 10 ) << result.time << std::setw( 10 ) << result.bytesPerFrame / ( 1024. * 1024. )
+              << std::setw( 9 ) << result.metrics.density << std::setw( 8 ) << result.metrics.bad05 << std::setw( 8 ) << result.metrics.bad1
+              << std::setw( 8 ) << result.metrics.bad2 << std::setw( 8 ) << result.metrics.bad4 << std::setw( 8 ) << result.metrics.d1
+              << std::setw( 9 ) << result.metrics.averageError << std::setw( 9 ) << result.metrics.rmsError << std::endl;
+
+    std::cout << std::defaultfloat;
+}
+
+static EvaluationResult summarize( const std::string &engine, const std::vector< EvaluationResult > &results )
+{
+    EvaluationResult ret = {};
+    ret.engine = engine;
+    ret.sample = "mean";
+
+    size_t count = 0;
+
+    for ( auto &i : results ) {
+
+        if ( i.engine != engine )
+            continue;
+
+        ++count;
+
+        ret.time += i.time;
+        ret.allocationsPerFrame += i.allocationsPerFrame;
+        ret.bytesPerFrame += i.bytesPerFrame;
+
+        ret.metrics.bad05 += i.metrics.bad05;
+        ret.metrics.bad1 += i.metrics.bad1;
+        ret.metrics.bad2 += i.metrics.bad2;
+        ret.metrics.bad4 += i.metrics.bad4;
+        ret.metrics.d1 += i.metrics.d1;
+        ret.metrics.density += i.metrics.density;
+        ret.metrics.averageError += i.metrics.averageError;
+        ret.metrics.rmsError += i.metrics.rmsError;
+
+    }
+
+    if ( count > 0 ) {
+        ret.time /= count;
+        ret.allocationsPerFrame /= count;
+        ret.bytesPerFrame /= count;
+
+        ret.metrics.bad05 /= count;
+        ret.metrics.bad1 /= count;
+        ret.metrics.bad2 /= count;
+        ret.metrics.bad4 /= count;
+        ret.metrics.d1 /= count;
+        ret.metrics.density /= count;
+        ret.metrics.averageError /= count;
+        ret.metrics.rmsError /= count;
+
+    }
+
+    return ret;
+
+}
+
+static bool saveCsv( const std::vector< EvaluationResult > &results, const std::string &fileName )
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    stream << "engine,sample,width,height,num_disparities,time_ms,allocations_per_frame,allocated_bytes_per_frame,density,bad05,bad1,bad2,bad4,d1,average_error,rms_error" << std::endl;
+
+    for ( auto &i : results )
+        stream << i.engine << "," << i.sample << "," << i.size.width << "," << i.size.height << "," << i.numDisparities << ","
+               << i.time << "," << i.allocationsPerFrame << "," << i.bytesPerFrame << "," << i.metrics.density << ","
+               << i.metrics.bad05 << "," << i.metrics.bad1 << "," << i.metrics.bad2 << "," << i.metrics.bad4 << ","
+               << i.metrics.d1 << "," << i.metrics.averageError << "," << i.metrics.rmsError << std::endl;
+
+    return stream.good();
+
+}
+
+int main( int argc, char **argv )
+{
+    QCoreApplication application( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Disparity quality and speed benchmark over Middlebury, KITTI or synthetic datasets" );
+    parser.addHelpOption();
+    parser.addPositionalArgument( "dataset", "Dataset folder." );
+
+    QCommandLineOption enginesOption( QStringList() << "e" << "engines", "Comma separated engines: bm, sgbm, census, bp, elas, elas-tiled.", "list", "bm,sgbm,census,bp,elas" );
+    QCommandLineOption scaleOption( "scale", "Image and ground truth scale.", "factor", "1" );
+    QCommandLineOption runsOption( QStringList() << "r" << "runs", "Timed runs per frame.", "count", "3" );
+    QCommandLineOption threadsOption( QStringList() << "t" << "threads", "OpenCV, OpenMP and task scheduler threads count, all cores if not set.", "count" );
+    QCommandLineOption csvOption( "csv", "Save per-frame results to a CSV file.", "file" );
+
+    parser.addOption( enginesOption );
+    parser.addOption( scaleOption );
+    parser.addOption( runsOption );
+    parser.addOption( threadsOption );
+    parser.addOption( csvOption );
+
+    parser.process( application );
+
+    if ( parser.positionalArguments().size() != 1 )
+        parser.showHelp( 1 );
+
+    std::vector< std::string > engines;
+
+    for ( auto &i : parser.value( enginesOption ).split( ",", QString::SkipEmptyParts ) ) {
+        auto engine = i.trimmed().toLower().toStdString();
+
+        if ( !createProcessor( engine, DISPARITY_ALIGN ) ) {
+            std::cerr << "Unknown engine " << engine << std::endl;
+            return 1;
+        }
+
+        engines.push_back( engine );
+
+    }
+
+    StereoDataset dataset;
+    dataset.setScale( parser.value( scaleOption ).toDouble() );
+
+    if ( !dataset.load( parser.positionalArguments().front().toStdString() ) ) {
+        std::cerr << "Can't find stereo pairs with ground truth in " << parser.positionalArguments().front().toStdString() << std::endl;
+        return 1;
+    }
+
+    if ( parser.isSet( threadsOption ) ) {
+        auto threads = parser.value( threadsOption ).toInt();
+
+        cv::setNumThreads( threads );
+        omp_set_num_threads( threads );
+
+        // The calling thread runs scheduler tasks while it waits for them, so it counts as one of the threads
+        TaskScheduler::instance().setThreadsCount( std::max( 1, threads ) - 1 );
+
+    }
+
+    auto runs = std::max( 1, parser.value( runsOption ).toInt() );
+
+    AllocationCounter::install();
+
+    std::vector< EvaluationResult > results;
+
+    printHeader();
+
+    for ( size_t i = 0; i < dataset.size(); ++i ) {
+        auto sample = dataset.sample( i );
+
+        if ( sample.leftImage.empty() ) {
+            std::cerr << "Can't load sample " << i << std::endl;
+            continue;
+        }
+
+        for ( auto &engine : engines ) {
+            auto result = evaluate( engine, sample, runs );
+
+            print( result );
+
+            results.push_back( result );
+
+        }
+
+    }
+
+    std::cout << std::endl;
+
+    for ( auto &engine : engines )
+        print( summarize( engine, results ) );
+
+    if ( parser.isSet( csvOption ) && !saveCsv( results, parser.value( csvOption ).toStdString() ) ) {
+        std::cerr << "Can't save " << parser.value( csvOption ).toStdString() << std::endl;
+        return 1;
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,254 @@
+#include "src/common/precompiled.h"
+
+#include "disparitytuner.h"
+
+#include "src/common/defs.h"
+#include "src/common/stereoprocessor.h"
+#include "src/common/tictoc.h"
+
+#include <iomanip>
+#include <iostream>
+
+// Grids stay inside the disparity app control ranges, so a tuned file loads without clamping
+static const std::vector< int > NUM_DISPARITIES_VALUES = { 64, 96, 128, 160, 192, 256 };
+
+static cv::Mat rightDisparity( DisparityProcessorBase *processor, const CvImage &leftImage, const CvImage &rightImage )
+{
+    // Matching mirrored images swaps the views and keeps disparities positive
+    CvImage leftFlipped, rightFlipped;
+
+    cv::flip( leftImage, leftFlipped, 1 );
+    cv::flip( rightImage, rightFlipped, 1 );
+
+    cv::Mat ret;
+    cv::flip( processor->processDisparity( rightFlipped, leftFlipped ), ret, 1 );
+
+    return ret;
+
+}
+
+// DisparityTuner
+DisparityTuner::DisparityTuner()
+{
+    initialize();
+}
+
+void DisparityTuner::initialize()
+{
+    m_timeBudget = 0.;
+    m_passesCount = 2;
+    m_verbose = false;
+}
+
+void DisparityTuner::setSamples( const std::vector< StereoSample > &value )
+{
+    m_samples = value;
+}
+
+const std::vector< StereoSample > &DisparityTuner::samples() const
+{
+    return m_samples;
+}
+
+void DisparityTuner::setTimeBudget( const double value )
+{
+    m_timeBudget = value;
+}
+
+double DisparityTuner::timeBudget() const
+{
+    return m_timeBudget;
+}
+
+void DisparityTuner::setPassesCount( const int value )
+{
+    m_passesCount = value;
+}
+
+int DisparityTuner::passesCount() const
+{
+    return m_passesCount;
+}
+
+void DisparityTuner::setVerbose( const bool value )
+{
+    m_verbose = value;
+}
+
+bool DisparityTuner::verbose() const
+{
+    return m_verbose;
+}
+
+bool DisparityTuner::isBetter( const TunerEvaluation &first, const TunerEvaluation &second )
+{
+    if ( first.feasible != second.feasible )
+        return first.feasible;
+
+    // Nothing fits the budget yet, get closer to it first
+    if ( !first.feasible )
+        return first.time < second.time;
+
+    if ( std::abs( first.score - second.score ) > DOUBLE_EPS )
+        return first.score > second.score;
+
+    return first.time < second.time;
+
+}
+
+// With ground truth the score is the percent of pixels within 2 px of it, otherwise
+// the percent of pixels that pass the left-right consistency check
+TunerEvaluation DisparityTuner::evaluate( DisparityProcessorBase *processor ) const
+{
+    TunerEvaluation ret = {};
+
+    if ( m_samples.empty() )
+        return ret;
+
+    // Matchers allocate their buffers on the first call
+    processor->processDisparity( m_samples.front().leftImage, m_samples.front().rightImage );
+
+    for ( auto &i : m_samples ) {
+        TicToc timer;
+        auto disparity = processor->processDisparity( i.leftImage, i.rightImage );
+        ret.time = std::max( ret.time, timer.toc() * 1000. );
+
+        if ( !i.groundTruth.empty() ) {
+            auto metrics = evaluateDisparity( disparity, i.groundTruth );
+
+            ret.score += 100. - metrics.bad2;
+            ret.density += metrics.density;
+
+        }
+        else {
+            ret.score += disparityConsistency( disparity, rightDisparity( processor, i.leftImage, i.rightImage ) );
+            ret.density += 100. * cv::countNonZero( disparityToFloat( disparity ) > 0.f ) / disparity.total();
+
+        }
+
+    }
+
+    ret.score /= m_samples.size();
+    ret.density /= m_samples.size();
+
+    ret.feasible = m_timeBudget <= 0. || ret.time <= m_timeBudget;
+
+    return ret;
+
+}
+
+template < class ParametersType, class ProcessorType >
+ParametersType DisparityTuner::search( const ParametersType &initial, const std::vector< Dimension< ParametersType > > &dimensions,
+                                       TunerEvaluation *evaluation, int *evaluationsCount ) const
+{
+    ProcessorType processor;
+
+    auto best = initial;
+
+    best.apply( &processor );
+    auto bestEvaluation = evaluate( &processor );
+
+    int count = 1;
+
+    // Coordinate descent over the grids, starting from the initial parameters
+    for ( int pass = 0; pass < m_passesCount; ++pass ) {
+        bool improved = false;
+
+        for ( auto &dimension : dimensions ) {
+
+            for ( auto value : dimension.values ) {
+
+                if ( value == best.*dimension.field )
+                    continue;
+
+                auto candidate = best;
+                candidate.*dimension.field = value;
+
+                candidate.apply( &processor );
+                auto candidateEvaluation = evaluate( &processor );
+
+                ++count;
+
+                if ( isBetter( candidateEvaluation, bestEvaluation ) ) {
+                    best = candidate;
+                    bestEvaluation = candidateEvaluation;
+
+                    improved = true;
+
+                    if ( m_verbose )
+                        std::cout << std::fixed << std::setprecision( 2 ) << "pass " << pass + 1 << ": " << dimension.name << " = " << value
+                                  << ", score " << bestEvaluation.score << " %, density " << bestEvaluation.density << " %, time "
+                                  << bestEvaluation.time << " ms" << ( bestEvaluation.feasible ? "" : " (over budget)" ) << std::defaultfloat << std::endl;
+
+                }
+
+            }
+
+        }
+
+        if ( !improved )
+            break;
+
+    }
+
+    *evaluation = bestEvaluation;
+    *evaluationsCount = count;
+
+    return best;
+
+}
+
+TunerResult DisparityTuner::tuneBm( const BMDisparityParameters &initial ) const
+{
+    using Parameters = BMDisparityParameters;
+
+    std::vector< Dimension< Parameters > > dimensions = {
+        { "numDisparities", &Parameters::numDisparities, NUM_DISPARITIES_VALUES },
+        { "blockSize", &Parameters::blockSize, { 5, 7, 9, 11, 15, 19, 25 } },
+        { "preFilterSize", &Parameters::preFilterSize, { 5, 9, 15, 21, 31 } },
+        { "preFilterCap", &Parameters::preFilterCap, { 8, 12, 20, 31, 47, 63 } },
+        { "textureThreshold", &Parameters::textureThreshold, { 0, 50, 150, 300, 450, 700 } },
+        { "uniquenessRatio", &Parameters::uniquenessRatio, { 0, 5, 10, 15, 25, 40, 55 } },
+        { "speckleWindowSize", &Parameters::speckleWindowSize, { 0, 25, 55, 100 } },
+        { "speckleRange", &Parameters::speckleRange, { 1, 2, 5, 10, 20 } },
+        { "disp12MaxDiff", &Parameters::disp12MaxDiff, { 0, 1, 2, 4 } }
+    };
+
+    TunerResult ret;
+
+    auto best = search< Parameters, BMDisparityProcessor >( initial, dimensions, &ret.evaluation, &ret.evaluationsCount );
+
+    ret.parameters.setMethod( DisparityParameters::Method::BM );
+    ret.parameters.setBmParameters( best );
+
+    return ret;
+
+}
+
+TunerResult DisparityTuner::tuneGm( const GMDisparityParameters &initial ) const
+{
+    using Parameters = GMDisparityParameters;
+
+    std::vector< Dimension< Parameters > > dimensions = {
+        { "mode", &Parameters::mode, { cv::StereoSGBM::MODE_SGBM, cv::StereoSGBM::MODE_SGBM_3WAY, cv::StereoSGBM::MODE_HH4, cv::StereoSGBM::MODE_HH } },
+        { "numDisparities", &Parameters::numDisparities, NUM_DISPARITIES_VALUES },
+        { "blockSize", &Parameters::blockSize, { 5, 7, 9, 11, 13 } },
+        { "p1", &Parameters::p1, { 0, 50, 100, 200, 400, 600 } },
+        { "p2", &Parameters::p2, { 0, 200, 400, 600, 800, 1000 } },
+        { "preFilterCap", &Parameters::preFilterCap, { 15, 31, 50, 63 } },
+        { "uniquenessRatio", &Parameters::uniquenessRatio, { 0, 5, 10, 20, 30 } },
+        { "speckleWindowSize", &Parameters::speckleWindowSize, { 0, 20, 50, 100 } },
+        { "speckleRange", &Parameters::speckleRange, { 1, 2, 5, 10 } },
+        { "disp12MaxDiff", &Parameters::disp12MaxDiff, { 0, 1, 2 } }
+    };
+
+    TunerResult ret;
+
+    auto best = search< Parameters, GMDisparityProcessor >( initial, dimensions, &ret.evaluation, &ret.evaluationsCount );
+
+    ret.parameters.setMethod( DisparityParameters::Method::GM );
+    ret.parameters.setGmParameters( best );
+
+    return ret;
+
+}
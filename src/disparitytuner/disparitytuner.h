@@ -0,0 +1,78 @@
+#pragma once
+
+#include "src/common/disparityevaluation.h"
+#include "src/common/disparityparameters.h"
+
+#include <string>
+#include <vector>
+
+class DisparityProcessorBase;
+
+struct TunerEvaluation
+{
+    // Percent of pixels with a good estimate, see DisparityTuner::evaluate
+    double score;
+    double density;
+
+    // milliseconds, slowest frame
+    double time;
+
+    bool feasible;
+};
+
+struct TunerResult
+{
+    DisparityParameters parameters;
+    TunerEvaluation evaluation;
+
+    int evaluationsCount;
+};
+
+class DisparityTuner
+{
+public:
+    DisparityTuner();
+
+    void setSamples( const std::vector< StereoSample > &value );
+    const std::vector< StereoSample > &samples() const;
+
+    // Maximum time per frame in milliseconds, zero for no limit
+    void setTimeBudget( const double value );
+    double timeBudget() const;
+
+    void setPassesCount( const int value );
+    int passesCount() const;
+
+    void setVerbose( const bool value );
+    bool verbose() const;
+
+    TunerResult tuneBm( const BMDisparityParameters &initial = BMDisparityParameters() ) const;
+    TunerResult tuneGm( const GMDisparityParameters &initial = GMDisparityParameters() ) const;
+
+    static bool isBetter( const TunerEvaluation &first, const TunerEvaluation &second );
+
+protected:
+    template < class ParametersType >
+    struct Dimension
+    {
+        const char *name;
+        int ParametersType::*field;
+        std::vector< int > values;
+    };
+
+    std::vector< StereoSample > m_samples;
+
+    double m_timeBudget;
+    int m_passesCount;
+    bool m_verbose;
+
+    TunerEvaluation evaluate( DisparityProcessorBase *processor ) const;
+
+    template < class ParametersType, class ProcessorType >
+    ParametersType search( const ParametersType &initial, const std::vector< Dimension< ParametersType > > &dimensions,
+                           TunerEvaluation *evaluation, int *evaluationsCount ) const;
+
+private:
+    void initialize();
+
+};
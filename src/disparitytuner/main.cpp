@@ -0,0 +1,204 @@
+#include "src/common/precompiled.h"
+
+#include "disparitytuner.h"
+
+#include "src/common/defs.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+
+#include <omp.h>
+
+#include <iomanip>
+#include <iostream>
+
+static std::vector< std::string > imageList( const QString &path )
+{
+    std::vector< std::string > ret;
+
+    QDir dir( path );
+
+    for ( auto &i : dir.entryInfoList( QStringList() << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp" << "*.tif" << "*.tiff", QDir::Files, QDir::Name ) )
+        ret.push_back( i.absoluteFilePath().toStdString() );
+
+    return ret;
+
+}
+
+static std::vector< size_t > sampleIndexes( const size_t count, const size_t maxCount )
+{
+    std::vector< size_t > ret;
+
+    auto resultCount = std::min( count, maxCount );
+
+    // Evenly spread over the recording
+    for ( size_t i = 0; i < resultCount; ++i )
+        ret.push_back( i * count / resultCount );
+
+    return ret;
+
+}
+
+static void printResult( const std::string &name, const TunerResult &result )
+{
+    std::cout << std::fixed << std::setprecision( 2 );
+
+    std::cout << name << ": score " << result.evaluation.score << " %, density " << result.evaluation.density << " %, time "
+              << result.evaluation.time << " ms, " << result.evaluationsCount << " evaluations"
+              << ( result.evaluation.feasible ? "" : ", over budget" ) << std::endl;
+
+    std::cout << std::defaultfloat;
+}
+
+int main( int argc, char **argv )
+{
+    QCoreApplication application( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Block matching and semi-global matching parameter tuner for rectified stereo pairs" );
+    parser.addHelpOption();
+
+    QCommandLineOption datasetOption( QStringList() << "d" << "dataset", "Middlebury, KITTI or synthetic dataset folder with ground truth.", "folder" );
+    QCommandLineOption leftOption( QStringList() << "l" << "left", "Folder with rectified left images.", "folder" );
+    QCommandLineOption rightOption( QStringList() << "r" << "right", "Folder with rectified right images.", "folder" );
+    QCommandLineOption methodOption( QStringList() << "m" << "method", "Tuned method: bm, gm or both.", "method", "both" );
+    QCommandLineOption budgetOption( QStringList() << "b" << "budget", "Maximum time per frame, milliseconds, 0 for no limit.", "ms", "100" );
+    QCommandLineOption framesOption( QStringList() << "n" << "frames", "Maximum frames count used for tuning.", "count", "10" );
+    QCommandLineOption scaleOption( "scale", "Image scale.", "factor", "1" );
+    QCommandLineOption passesOption( "passes", "Maximum coordinate descent passes.", "count", "2" );
+    QCommandLineOption threadsOption( QStringList() << "t" << "threads", "OpenCV and OpenMP threads count, all cores if not set.", "count" );
+    QCommandLineOption outputOption( QStringList() << "o" << "output", "Output parameters file.", "file", "disparity.yaml" );
+
+    parser.addOption( datasetOption );
+    parser.addOption( leftOption );
+    parser.addOption( rightOption );
+    parser.addOption( methodOption );
+    parser.addOption( budgetOption );
+    parser.addOption( framesOption );
+    parser.addOption( scaleOption );
+    parser.addOption( passesOption );
+    parser.addOption( threadsOption );
+    parser.addOption( outputOption );
+
+    parser.process( application );
+
+    auto method = parser.value( methodOption );
+
+    if ( method != "bm" && method != "gm" && method != "both" ) {
+        std::cerr << "Unknown method " << method.toStdString() << std::endl;
+        return 1;
+    }
+
+    auto framesCount = std::max( 1u, parser.value( framesOption ).toUInt() );
+    auto scale = parser.value( scaleOption ).toDouble();
+
+    std::vector< StereoSample > samples;
+
+    if ( parser.isSet( datasetOption ) ) {
+        StereoDataset dataset;
+        dataset.setScale( scale );
+
+        if ( !dataset.load( parser.value( datasetOption ).toStdString() ) ) {
+            std::cerr << "Can't find stereo pairs with ground truth in " << parser.value( datasetOption ).toStdString() << std::endl;
+            return 1;
+        }
+
+        for ( auto i : sampleIndexes( dataset.size(), framesCount ) ) {
+            auto sample = dataset.sample( i );
+
+            if ( !sample.leftImage.empty() )
+                samples.push_back( sample );
+
+        }
+
+    }
+    else if ( parser.isSet( leftOption ) && parser.isSet( rightOption ) ) {
+        auto leftFiles = imageList( parser.value( leftOption ) );
+        auto rightFiles = imageList( parser.value( rightOption ) );
+
+        for ( auto i : sampleIndexes( std::min( leftFiles.size(), rightFiles.size() ), framesCount ) ) {
+            StereoSample sample;
+            sample.name = QFileInfo( QString::fromStdString( leftFiles[ i ] ) ).completeBaseName().toStdString();
+            sample.leftImage = CvImage( leftFiles[ i ] );
+            sample.rightImage = CvImage( rightFiles[ i ] );
+            sample.maxDisparity = 0;
+
+            if ( sample.leftImage.empty() || sample.rightImage.empty() )
+                continue;
+
+            if ( std::abs( scale - 1. ) > DOUBLE_EPS ) {
+                cv::resize( sample.leftImage, sample.leftImage, cv::Size(), scale, scale, cv::INTER_AREA );
+                cv::resize( sample.rightImage, sample.rightImage, cv::Size(), scale, scale, cv::INTER_AREA );
+            }
+
+            samples.push_back( sample );
+
+        }
+
+    }
+    else {
+        std::cerr << "Set a dataset folder or left and right image folders" << std::endl;
+        return 1;
+    }
+
+    if ( samples.empty() ) {
+        std::cerr << "No stereo pairs to tune on" << std::endl;
+        return 1;
+    }
+
+    if ( parser.isSet( threadsOption ) ) {
+        auto threads = parser.value( threadsOption ).toInt();
+
+        cv::setNumThreads( threads );
+        omp_set_num_threads( threads );
+
+    }
+
+    DisparityTuner tuner;
+
+    tuner.setSamples( samples );
+    tuner.setTimeBudget( parser.value( budgetOption ).toDouble() );
+    tuner.setPassesCount( std::max( 1, parser.value( passesOption ).toInt() ) );
+    tuner.setVerbose( true );
+
+    std::cout << "Tuning on " << samples.size() << " frames" << std::endl;
+
+    std::vector< TunerResult > results;
+
+    if ( method != "gm" ) {
+        std::cout << "Block matching" << std::endl;
+
+        results.push_back( tuner.tuneBm() );
+        printResult( "Block matching", results.back() );
+
+    }
+
+    if ( method != "bm" ) {
+        std::cout << "Semi-global matching" << std::endl;
+
+        results.push_back( tuner.tuneGm() );
+        printResult( "Semi-global matching", results.back() );
+
+    }
+
+    auto best = results.front();
+
+    for ( auto &i : results )
+        if ( DisparityTuner::isBetter( i.evaluation, best.evaluation ) )
+            best = i;
+
+    if ( !best.evaluation.feasible )
+        std::cerr << "No parameters fit the time budget, saving the fastest ones found" << std::endl;
+
+    if ( !best.parameters.saveYaml( parser.value( outputOption ).toStdString() ) ) {
+        std::cerr << "Can't save " << parser.value( outputOption ).toStdString() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Saved " << ( best.parameters.method() == DisparityParameters::Method::BM ? "block matching" : "semi-global matching" )
+              << " parameters to " << parser.value( outputOption ).toStdString() << std::endl;
+
+    return 0;
+
+}
@@ -20,23 +20,40 @@ libelas; if not, write to the Free Software Foundation, Inc., 51 Franklin
 Street, Fifth Floor, Boston, MA 02110-1301, USA 
 */
 #include "descriptor.h"
-#include "triangle.h"
 #include "matrix.h"
 
 #include "StereoEfficientLargeScale.h"
+
+#include "parallel.h"
+
 using namespace std;
 
 StereoEfficientLargeScale::StereoEfficientLargeScale()
 {
+	tileHeight = 0;
+	tileOverlap = 32;
 }
-void StereoEfficientLargeScale::operator()(const cv::Mat& leftim, const cv::Mat& rightim, cv::Mat& leftdisp, cv::Mat& rightdisp, int bd)
+
+void StereoEfficientLargeScale::setTiles(int height, int overlap)
 {
-	Mat l,r;
-    if(leftim.channels()==3){cvtColor(leftim,l,cv::COLOR_BGR2GRAY);}
-	else l=leftim;
-    if(rightim.channels()==3)cvtColor(rightim,r,cv::COLOR_BGR2GRAY);
-	else r=rightim;
+	tileHeight = std::max(0,height);
+	tileOverlap = std::max(0,overlap);
+	tileMatchers.clear();
+	elas.resetSupport();
+}
 
+int StereoEfficientLargeScale::getTileHeight() const
+{
+	return tileHeight;
+}
+
+int StereoEfficientLargeScale::getTileOverlap() const
+{
+	return tileOverlap;
+}
+
+void StereoEfficientLargeScale::processImage(Elas& matcher, const cv::Mat& l, const cv::Mat& r, cv::Mat& leftdpf, cv::Mat& rightdpf, int bd)
+{
 	Mat lb,rb;
 	cv::copyMakeBorder(l,lb,0,0,bd,bd,cv::BORDER_REPLICATE);
 	cv::copyMakeBorder(r,rb,0,0,bd,bd,cv::BORDER_REPLICATE);
@@ -44,16 +61,74 @@ void StereoEfficientLargeScale::operator()(const cv::Mat& leftim, const cv::Mat&
 	const cv::Size imsize = lb.size();
 	const int32_t dims[3] = {imsize.width,imsize.height,imsize.width}; // bytes per line = width
 
-	cv::Mat leftdpf = cv::Mat::zeros(imsize,CV_32F);
-	cv::Mat rightdpf = cv::Mat::zeros(imsize,CV_32F);
-	elas.process(lb.data,rb.data,leftdpf.ptr<float>(0),rightdpf.ptr<float>(0),dims);
+	cv::Mat ld = cv::Mat::zeros(imsize,CV_32F);
+	cv::Mat rd = cv::Mat::zeros(imsize,CV_32F);
+	matcher.process(lb.data,rb.data,ld.ptr<float>(0),rd.ptr<float>(0),dims);
+
+	leftdpf = ld(cv::Rect(bd,0,l.cols,l.rows));
+	rightdpf = rd(cv::Rect(bd,0,l.cols,l.rows));
+}
+
+// tile matchers follow the settings of the whole image matcher, a changed setting drops their support seeds
+static void syncTileMatcher(Elas& matcher, const Elas& elas)
+{
+	if (matcher.disparityMin() != elas.disparityMin() || matcher.disparityMax() != elas.disparityMax())
+		matcher.setDisparityRange(elas.disparityMin(),elas.disparityMax());
+	if (matcher.supportReuse() != elas.supportReuse())
+		matcher.setSupportReuse(elas.supportReuse());
+	matcher.setPostprocessMode(elas.postprocessMode());
+}
+
+void StereoEfficientLargeScale::processTiled(const cv::Mat& l, const cv::Mat& r, cv::Mat& leftdpf, cv::Mat& rightdpf, int bd)
+{
+	const int rows = l.rows;
+	const int count = (rows+tileHeight-1)/tileHeight;
+
+	std::vector<cv::Range> processed(count);
+	std::vector<Mat> leftTiles(count), rightTiles(count);
+
+	for (int i=0; i<count; i++)
+		processed[i] = cv::Range(std::max(0,i*tileHeight-tileOverlap),std::min(rows,(i+1)*tileHeight+tileOverlap));
+
+	// every tile keeps its own matcher between frames, so its buffers are bounded by the tile size instead of
+	// the image size and support reuse seeds each tile with its own previous frame
+	if ((int)tileMatchers.size() != count)
+		tileMatchers.assign(count,elas);
+
+	elasParallelFor(0,count,[&](int32_t i) {
+		syncTileMatcher(tileMatchers[i],elas);
+		processImage(tileMatchers[i],l.rowRange(processed[i]),r.rowRange(processed[i]),leftTiles[i],rightTiles[i],bd);
+	});
+
+	leftdpf.create(l.size(),CV_32F);
+	rightdpf.create(l.size(),CV_32F);
+
+	// every row is copied from the tile whose core owns it, the overlap only gives the owner context at its
+	// edges. a ramp blend across the overlap was considered and left out: disparities of two tiles averaged
+	// across a depth edge belong to neither surface
+	elasParallelFor(0,rows,[&](int32_t y) {
+		const int i = y/tileHeight;
+		leftTiles[i].row(y-processed[i].start).copyTo(leftdpf.row(y));
+		rightTiles[i].row(y-processed[i].start).copyTo(rightdpf.row(y));
+	},16);
+}
+
+void StereoEfficientLargeScale::operator()(const cv::Mat& leftim, const cv::Mat& rightim, cv::Mat& leftdisp, cv::Mat& rightdisp, int bd)
+{
+	Mat l,r;
+    if(leftim.channels()==3){cvtColor(leftim,l,cv::COLOR_BGR2GRAY);}
+	else l=leftim;
+    if(rightim.channels()==3)cvtColor(rightim,r,cv::COLOR_BGR2GRAY);
+	else r=rightim;
 
-	Mat disp;
-	Mat(leftdpf(cv::Rect(bd,0,leftim.cols,leftim.rows))).copyTo(disp);
-	disp.convertTo(leftdisp,CV_16S,16);
-	Mat(rightdpf(cv::Rect(bd,0,leftim.cols,leftim.rows))).copyTo(disp);
+	Mat leftdpf,rightdpf;
+	if (tileHeight > 0 && l.rows > tileHeight+tileOverlap)
+		processTiled(l,r,leftdpf,rightdpf,bd);
+	else
+		processImage(elas,l,r,leftdpf,rightdpf,bd);
 
-	disp.convertTo(rightdisp,CV_16S,16);
+	leftdpf.convertTo(leftdisp,CV_16S,16);
+	rightdpf.convertTo(rightdisp,CV_16S,16);
 }
 
 void StereoEfficientLargeScale::operator()(const cv::Mat& leftim, const cv::Mat& rightim, cv::Mat& leftdisp, int bd)
@@ -13,10 +13,23 @@ protected:
 
 	int minDisparity;
 	int disparityRange;
+
+	// tiled mode: horizontal tiles of tileHeight rows, extended by tileOverlap rows on both sides
+	int tileHeight;
+	int tileOverlap;
+	std::vector<Elas> tileMatchers;
+
+	void processImage(Elas& matcher, const cv::Mat& l, const cv::Mat& r, cv::Mat& leftdpf, cv::Mat& rightdpf, int bd);
+	void processTiled(const cv::Mat& l, const cv::Mat& r, cv::Mat& leftdpf, cv::Mat& rightdpf, int bd);
 public:
     Elas elas;
     StereoEfficientLargeScale();
     void operator()(const cv::Mat& leftim, const cv::Mat& rightim, cv::Mat& leftdisp, cv::Mat& rightdisp, int border);
     void operator()(const cv::Mat& leftim, const cv::Mat& rightim, cv::Mat& leftdisp, int border);
+
+    // zero tile height processes the whole image at once
+    void setTiles(int height, int overlap);
+    int getTileHeight() const;
+    int getTileOverlap() const;
 //	void StereoEfficientLargeScale::check(Mat& leftim, Mat& rightim, Mat& disp, StereoEval& eval);
 };
@@ -0,0 +1,326 @@
+/*
+Sweep-hull Delaunay triangulation, see delaunay.h. Triangles are stored as
+vertex triples with positive orientation, halfedge e of triangle e/3 runs from
+tri[e] to the next vertex and halfedges[e] holds its twin in the neighbor
+triangle, -1 on the convex hull.
+*/
+
+#include "delaunay.h"
+
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// twice the signed area of p,q,r, positive for counter-clockwise points
+static inline int64_t orient (const int32_t* p,const int32_t* q,const int32_t* r) {
+	return (int64_t)(q[0]-p[0])*(r[1]-p[1])-(int64_t)(q[1]-p[1])*(r[0]-p[0]);
+}
+
+// true if p lies strictly inside the circumcircle of the counter-clockwise triangle a,b,c
+static inline bool inCircle (const int32_t* a,const int32_t* b,const int32_t* c,const int32_t* p) {
+	int64_t dx = a[0]-p[0], dy = a[1]-p[1];
+	int64_t ex = b[0]-p[0], ey = b[1]-p[1];
+	int64_t fx = c[0]-p[0], fy = c[1]-p[1];
+	int64_t ap = dx*dx+dy*dy;
+	int64_t bp = ex*ex+ey*ey;
+	int64_t cp = fx*fx+fy*fy;
+	return dx*(ey*cp-bp*fy)-dy*(ex*cp-bp*fx)+ap*(ex*fy-ey*fx)>0;
+}
+
+static inline double squaredDistance (double ax,double ay,double bx,double by) {
+	double dx = ax-bx, dy = ay-by;
+	return dx*dx+dy*dy;
+}
+
+// circumcenter offset from a, false for collinear points
+static inline bool circumcenter (const int32_t* a,const int32_t* b,const int32_t* c,double &x,double &y) {
+	double dx = b[0]-a[0], dy = b[1]-a[1];
+	double ex = c[0]-a[0], ey = c[1]-a[1];
+	double den = dx*ey-dy*ex;
+	if (den==0)
+		return false;
+	double bl = dx*dx+dy*dy;
+	double cl = ex*ex+ey*ey;
+	x = (ey*bl-dy*cl)*0.5/den;
+	y = (dx*cl-ex*bl)*0.5/den;
+	return true;
+}
+
+void Delaunay::triangulate (const int32_t* points,int32_t n,vector<int32_t> &triangles) {
+
+	triangles.clear();
+	if (n<3)
+		return;
+
+	// seed triangle: point closest to the bounding box center, its nearest
+	// neighbor and the point giving the smallest circumcircle with them
+	int32_t min_x = points[0], max_x = points[0], min_y = points[1], max_y = points[1];
+	for (int32_t i=1; i<n; i++) {
+		min_x = min(min_x,points[2*i]); max_x = max(max_x,points[2*i]);
+		min_y = min(min_y,points[2*i+1]); max_y = max(max_y,points[2*i+1]);
+	}
+	double bx = 0.5*((double)min_x+max_x);
+	double by = 0.5*((double)min_y+max_y);
+
+	int32_t i0 = 0, i1 = -1, i2 = -1;
+	double min_dist = numeric_limits<double>::max();
+	for (int32_t i=0; i<n; i++) {
+		double d = squaredDistance(points[2*i],points[2*i+1],bx,by);
+		if (d<min_dist) { i0 = i; min_dist = d; }
+	}
+
+	min_dist = numeric_limits<double>::max();
+	for (int32_t i=0; i<n; i++) {
+		double d = squaredDistance(points[2*i],points[2*i+1],points[2*i0],points[2*i0+1]);
+		if (d>0 && d<min_dist) { i1 = i; min_dist = d; }
+	}
+	if (i1<0)
+		return;
+
+	double min_radius = numeric_limits<double>::max();
+	for (int32_t i=0; i<n; i++) {
+		double x,y;
+		if (circumcenter(points+2*i0,points+2*i1,points+2*i,x,y) && x*x+y*y<min_radius) {
+			i2 = i;
+			min_radius = x*x+y*y;
+		}
+	}
+
+	// all points collinear
+	if (i2<0)
+		return;
+
+	if (orient(points+2*i0,points+2*i1,points+2*i2)<0)
+		swap(i1,i2);
+
+	circumcenter(points+2*i0,points+2*i1,points+2*i2,cx,cy);
+	cx += points[2*i0];
+	cy += points[2*i0+1];
+
+	// insertion order by distance from the seed circumcenter, ties are broken
+	// by coordinates so that duplicate points end up next to each other
+	ids.resize(n);
+	dists.resize(n);
+	for (int32_t i=0; i<n; i++) {
+		ids[i]   = i;
+		dists[i] = squaredDistance(points[2*i],points[2*i+1],cx,cy);
+	}
+	sort(ids.begin(),ids.end(),[this,points] (int32_t a,int32_t b) {
+		if (dists[a]!=dists[b]) return dists[a]<dists[b];
+		if (points[2*a]!=points[2*b]) return points[2*a]<points[2*b];
+		return points[2*a+1]<points[2*b+1];
+	});
+
+	// work on a copy in insertion order, neighboring triangles then touch nearby memory
+	xy.resize(2*n);
+	int32_t s0 = 0, s1 = 0, s2 = 0;
+	for (int32_t k=0; k<n; k++) {
+		xy[2*k]   = points[2*ids[k]];
+		xy[2*k+1] = points[2*ids[k]+1];
+		if (ids[k]==i0) s0 = k;
+		if (ids[k]==i1) s1 = k;
+		if (ids[k]==i2) s2 = k;
+	}
+	i0 = s0;
+	i1 = s1;
+	i2 = s2;
+	const int32_t* c = xy.data();
+
+	// at most 2n-5 triangles for n points
+	int32_t max_triangles = max(2*n-5,1);
+	tri.resize(max_triangles*3);
+	halfedges.resize(max_triangles*3);
+	tri_len = 0;
+
+	// convex hull as a linked list, hull_tri holds the halfedge leaving each hull vertex,
+	// the angular hash gives a hull vertex close to a new point
+	hull_prev.resize(n);
+	hull_next.resize(n);
+	hull_tri.resize(n);
+	hash_size = (int32_t)ceil(sqrt((double)n));
+	hull_hash.assign(hash_size,-1);
+
+	hull_start = i0;
+	hull_next[i0] = hull_prev[i2] = i1;
+	hull_next[i1] = hull_prev[i0] = i2;
+	hull_next[i2] = hull_prev[i1] = i0;
+	hull_tri[i0] = 0;
+	hull_tri[i1] = 1;
+	hull_tri[i2] = 2;
+	hull_hash[hashKey(c+2*i0)] = i0;
+	hull_hash[hashKey(c+2*i1)] = i1;
+	hull_hash[hashKey(c+2*i2)] = i2;
+
+	addTriangle(i0,i1,i2,-1,-1,-1);
+
+	for (int32_t i=0; i<n; i++) {
+
+		const int32_t* p = c+2*i;
+
+		// skip duplicates and the seed triangle
+		if (i>0 && p[0]==p[-2] && p[1]==p[-1])
+			continue;
+		if (i==i0 || i==i1 || i==i2)
+			continue;
+
+		// find a hull edge visible from the point, starting close to it
+		int32_t start = 0;
+		int32_t key   = hashKey(p);
+		for (int32_t j=0; j<hash_size; j++) {
+			start = hull_hash[(key+j)%hash_size];
+			if (start!=-1 && start!=hull_next[start])
+				break;
+		}
+
+		start = hull_prev[start];
+		int32_t e = start, q;
+		while (q = hull_next[e], orient(c+2*e,c+2*q,p)>=0) {
+			e = q;
+			if (e==start) {
+				e = -1;
+				break;
+			}
+		}
+
+		// the point coincides with a hull vertex
+		if (e==-1)
+			continue;
+
+		// connect the point to the first visible edge
+		int32_t t = addTriangle(e,i,hull_next[e],-1,-1,hull_tri[e]);
+		hull_tri[i] = legalize(t+2);
+		hull_tri[e] = t;
+
+		// walk forward through the visible edges
+		int32_t nx = hull_next[e];
+		while (q = hull_next[nx], orient(c+2*nx,c+2*q,p)<0) {
+			t = addTriangle(nx,i,q,hull_tri[i],-1,hull_tri[nx]);
+			hull_tri[i] = legalize(t+2);
+			hull_next[nx] = nx;
+			nx = q;
+		}
+
+		// and backward, if the first visible edge was the start of the search
+		if (e==start) {
+			while (q = hull_prev[e], orient(c+2*q,c+2*e,p)<0) {
+				t = addTriangle(q,i,e,-1,hull_tri[e],hull_tri[q]);
+				legalize(t+2);
+				hull_tri[q] = t;
+				hull_next[e] = e;
+				e = q;
+			}
+		}
+
+		// the point replaces the removed hull vertices
+		hull_start = hull_prev[i] = e;
+		hull_next[e] = hull_prev[nx] = i;
+		hull_next[i] = nx;
+
+		hull_hash[hashKey(p)] = i;
+		hull_hash[hashKey(c+2*e)] = e;
+	}
+
+	// back to the caller's point indices
+	triangles.resize(tri_len);
+	for (int32_t k=0; k<tri_len; k++)
+		triangles[k] = ids[tri[k]];
+}
+
+int32_t Delaunay::addTriangle (int32_t i0,int32_t i1,int32_t i2,int32_t a,int32_t b,int32_t c) {
+	int32_t t = tri_len;
+	tri[t]   = i0;
+	tri[t+1] = i1;
+	tri[t+2] = i2;
+	link(t,a);
+	link(t+1,b);
+	link(t+2,c);
+	tri_len += 3;
+	return t;
+}
+
+void Delaunay::link (int32_t a,int32_t b) {
+	halfedges[a] = b;
+	if (b!=-1)
+		halfedges[b] = a;
+}
+
+// flips halfedge a and the edges it uncovers until the triangles around it
+// are locally Delaunay, returns the halfedge preceding a
+int32_t Delaunay::legalize (int32_t a) {
+
+	const int32_t* c = xy.data();
+	int32_t ar = 0;
+	edge_stack.clear();
+
+	while (true) {
+
+		int32_t b  = halfedges[a];
+		int32_t a0 = a-a%3;
+		ar = a0+(a+2)%3;
+
+		if (b==-1) {
+			if (edge_stack.empty())
+				break;
+			a = edge_stack.back();
+			edge_stack.pop_back();
+			continue;
+		}
+
+		int32_t b0 = b-b%3;
+		int32_t al = a0+(a+1)%3;
+		int32_t bl = b0+(b+2)%3;
+
+		int32_t p0 = tri[ar];
+		int32_t pr = tri[a];
+		int32_t pl = tri[al];
+		int32_t p1 = tri[bl];
+
+		if (inCircle(c+2*p0,c+2*pr,c+2*pl,c+2*p1)) {
+
+			tri[a] = p1;
+			tri[b] = p0;
+
+			// the flipped edge was on the hull on the other side, fix its reference
+			int32_t hbl = halfedges[bl];
+			if (hbl==-1) {
+				int32_t e = hull_start;
+				do {
+					if (hull_tri[e]==bl) {
+						hull_tri[e] = a;
+						break;
+					}
+					e = hull_prev[e];
+				} while (e!=hull_start);
+			}
+
+			link(a,hbl);
+			link(b,halfedges[ar]);
+			link(ar,bl);
+
+			edge_stack.push_back(b0+(b+1)%3);
+
+		} else {
+			if (edge_stack.empty())
+				break;
+			a = edge_stack.back();
+			edge_stack.pop_back();
+		}
+	}
+
+	return ar;
+}
+
+// pseudo angle around the seed circumcenter, decreasing counter-clockwise: probing
+// the hash upwards finds a hull vertex just before the point in hull order
+int32_t Delaunay::hashKey (const int32_t* p) const {
+	double dx = p[0]-cx;
+	double dy = cy-p[1];
+	double sum = fabs(dx)+fabs(dy);
+	if (sum==0)
+		return 0;
+	double a = dx/sum;
+	double angle = (dy>0 ? 3-a : 1+a)/4;
+	return (int32_t)floor(angle*hash_size)%hash_size;
+}
@@ -0,0 +1,53 @@
+/*
+Incremental Delaunay triangulation of the ELAS support points. Points are
+inserted in order of distance from a seed triangle, so every new point lies
+outside the current convex hull: it is connected to the visible hull edges,
+found through an angular hash of the hull vertices, and the new edges are
+legalized with Lawson flips. Support points have integer coordinates, the
+orientation and in-circle predicates are evaluated exactly in 64 bit integers.
+*/
+
+#ifndef __DELAUNAY_H__
+#define __DELAUNAY_H__
+
+#include <vector>
+
+#ifndef _MSC_VER
+  #include <stdint.h>
+#else
+  typedef __int32           int32_t;
+  typedef __int64           int64_t;
+#endif
+
+class Delaunay {
+
+public:
+
+  // triangulates n points given as interleaved x,y coordinates, triangles
+  // receives vertex index triples of the convex hull triangulation,
+  // duplicate points are skipped, collinear input gives no triangles
+  void triangulate (const int32_t* xy,int32_t n,std::vector<int32_t> &triangles);
+
+private:
+
+  int32_t addTriangle (int32_t i0,int32_t i1,int32_t i2,int32_t a,int32_t b,int32_t c);
+  void    link (int32_t a,int32_t b);
+  int32_t legalize (int32_t a);
+  int32_t hashKey (const int32_t* p) const;
+
+  // buffers are kept between calls, support point counts barely change between frames
+  std::vector<int32_t> ids;
+  std::vector<double>  dists;
+  std::vector<int32_t> xy;
+  std::vector<int32_t> tri;
+  std::vector<int32_t> halfedges;
+  std::vector<int32_t> hull_prev,hull_next,hull_tri;
+  std::vector<int32_t> hull_hash;
+  std::vector<int32_t> edge_stack;
+  int32_t              tri_len;
+  int32_t              hull_start;
+  int32_t              hash_size;
+  double               cx,cy;
+};
+
+#endif
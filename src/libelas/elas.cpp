@@ -22,10 +22,9 @@ Street, Fifth Floor, Boston, MA 02110-1301, USA
 #include "elas.h"
 
 #include <math.h>
-#include <omp.h>
+#include <algorithm>
 #include "descriptor.h"
-#include "triangle.h"
-#include "matrix.h"
+#include "parallel.h"
 
 using namespace std;
 
@@ -74,38 +73,28 @@ void Elas::process (uint8_t* I1_,uint8_t* I2_,float* D1,float* D2,const int32_t*
 #endif
 
 vector<triangle> tri_1, tri_2;
-#pragma omp parallel num_threads(2)
 	{
-#pragma omp sections
-		{
-#pragma omp section
-			{
-				tri_1 = computeDelaunayTriangulation(p_support,0);
-				computeDisparityPlanes(p_support,tri_1,0);
-				createGrid(p_support,disparity_grid_1,grid_dims,0);
-				//computeDisparity(p_support,tri_1,disparity_grid_1,grid_dims,desc1.I_desc,desc2.I_desc,0,D1);
-			}
-#pragma omp section
-			{
-				tri_2 = computeDelaunayTriangulation(p_support,1);
-				computeDisparityPlanes(p_support,tri_2,1);
-				createGrid(p_support,disparity_grid_2,grid_dims,1);
-				//computeDisparity(p_support,tri_2,disparity_grid_2,grid_dims,desc1.I_desc,desc2.I_desc,1,D2);
-			}
-
-		}
+		// left and right images run on the installed scheduler instead of a private OpenMP team
+		elasParallelFor(0,2,[&](int32_t image) {
+			vector<triangle> &tri = image==0 ? tri_1 : tri_2;
+			int32_t* disparity_grid = image==0 ? disparity_grid_1 : disparity_grid_2;
+			tri = computeDelaunayTriangulation(p_support,image);
+			computeDisparityPlanes(p_support,tri,image);
+			createGrid(p_support,disparity_grid,grid_dims,image);
+		});
 	}
 
 #ifdef PROFILE
 	timer.start("Matching");
 #endif
 
-#pragma omp sections
 	{
-	#pragma omp section
-		computeDisparity(p_support,tri_1,disparity_grid_1,grid_dims,desc1.I_desc,desc2.I_desc,0,D1);
-	#pragma omp section
-		computeDisparity(p_support,tri_2,disparity_grid_2,grid_dims,desc1.I_desc,desc2.I_desc,1,D2);
+		elasParallelFor(0,2,[&](int32_t image) {
+			if (image==0)
+				computeDisparity(p_support,tri_1,disparity_grid_1,grid_dims,desc1.I_desc,desc2.I_desc,0,D1);
+			else
+				computeDisparity(p_support,tri_2,disparity_grid_2,grid_dims,desc1.I_desc,desc2.I_desc,1,D2);
+		});
 	}
 
 #ifdef PROFILE
@@ -123,28 +112,51 @@ vector<triangle> tri_1, tri_2;
 #ifdef PROFILE
   timer.start("Gap Interpolation");
 #endif
-  gapInterpolation(D1);
-  if (!param.postprocess_only_left)
-      gapInterpolation(D2);
+  const bool reference_postprocess = param.postprocess_mode==POSTPROCESS_SCALAR;
+
+  if (reference_postprocess) {
+      gapInterpolation(D1);
+      if (!param.postprocess_only_left)
+          gapInterpolation(D2);
+  } else {
+      gapInterpolationParallel(D1);
+      if (!param.postprocess_only_left)
+          gapInterpolationParallel(D2);
+  }
 
   if (param.filter_adaptive_mean) {
 #ifdef PROFILE
       timer.start("Adaptive Mean");
 #endif
-      adaptiveMean(D1);
-      if (!param.postprocess_only_left)
-          adaptiveMean(D2);
+      if (reference_postprocess) {
+          adaptiveMean(D1);
+          if (!param.postprocess_only_left)
+              adaptiveMean(D2);
+      } else {
+          adaptiveMeanParallel(D1);
+          if (!param.postprocess_only_left)
+              adaptiveMeanParallel(D2);
+      }
   }
 
   if (param.filter_median) {
 #ifdef PROFILE
       timer.start("Median");
 #endif
-      median(D1);
-      if (!param.postprocess_only_left)
-          median(D2);
+      if (reference_postprocess) {
+          median(D1);
+          if (!param.postprocess_only_left)
+              median(D2);
+      } else {
+          medianParallel(D1);
+          if (!param.postprocess_only_left)
+              medianParallel(D2);
+      }
   }
 
+  if (param.support_reuse)
+      storeSupportSeeds(D1);
+
 #ifdef PROFILE
 	timer.plot();
 #endif
@@ -159,7 +171,6 @@ vector<triangle> tri_1, tri_2;
 void Elas::removeInconsistentSupportPoints (int16_t* D_can,int32_t D_can_width,int32_t D_can_height) {
 
 	// for all valid support points do
-	#pragma omp for
 	for (int32_t u_can=0; u_can<D_can_width; u_can++) {
 		for (int32_t v_can=0; v_can<D_can_height; v_can++) {
 			int16_t d_can = *(D_can+getAddressOffsetImage(u_can,v_can,D_can_width));
@@ -200,7 +211,6 @@ void Elas::removeRedundantSupportPoints(int16_t* D_can,int32_t D_can_width,int32
 	}
 
 	// for all valid support points do
-	#pragma omp for
 	for (int32_t u_can=0; u_can<D_can_width; u_can++) {
 		for (int32_t v_can=0; v_can<D_can_height; v_can++) {
 			int16_t d_can = *(D_can+getAddressOffsetImage(u_can,v_can,D_can_width));
@@ -275,6 +285,11 @@ void Elas::addCornerSupportPoints(vector<support_pt> &p_support) {
 }
 
 inline int16_t Elas::computeMatchingDisparity (const int32_t &u,const int32_t &v,uint8_t* I1_desc,uint8_t* I2_desc,const bool &right_image) {
+	return computeMatchingDisparity(u,v,I1_desc,I2_desc,right_image,param.disp_min,param.disp_max);
+}
+
+inline int16_t Elas::computeMatchingDisparity (const int32_t &u,const int32_t &v,uint8_t* I1_desc,uint8_t* I2_desc,const bool &right_image,
+                                               const int32_t &d_from,const int32_t &d_to) {
 
 	const int32_t u_step      = 2;
 	const int32_t v_step      = 2;
@@ -337,6 +352,12 @@ inline int16_t Elas::computeMatchingDisparity (const int32_t &u,const int32_t &v
 		if (disp_max_valid-disp_min_valid<10)
 			return -1;
 
+		// restrict the search to the requested range
+		disp_min_valid = max(disp_min_valid,d_from);
+		disp_max_valid = min(disp_max_valid,d_to);
+		if (disp_min_valid>disp_max_valid)
+			return -1;
+
 		// for all disparities do
 		for (int16_t d=disp_min_valid; d<=disp_max_valid; d++) {
 
@@ -378,41 +399,58 @@ inline int16_t Elas::computeMatchingDisparity (const int32_t &u,const int32_t &v
 		return -1;
 }
 
-vector<Elas::support_pt> Elas::computeSupportMatches (uint8_t* I1_desc,uint8_t* I2_desc) {
+void Elas::supportGrid (int32_t &stepsize,int32_t &grid_width,int32_t &grid_height) {
 
 	// be sure that at half resolution we only need data
 	// from every second line!
-	int32_t D_candidate_stepsize = param.candidate_stepsize;
+	stepsize = param.candidate_stepsize;
 	if (param.subsampling)
-		D_candidate_stepsize += D_candidate_stepsize%2;
+		stepsize += stepsize%2;
+
+	grid_width  = 0;
+	grid_height = 0;
+	for (int32_t u=0; u<width;  u+=stepsize) grid_width++;
+	for (int32_t v=0; v<height; v+=stepsize) grid_height++;
+}
+
+vector<Elas::support_pt> Elas::computeSupportMatches (uint8_t* I1_desc,uint8_t* I2_desc) {
 
 	// create matrix for saving disparity candidates
-	int32_t D_can_width  = 0;
-	int32_t D_can_height = 0;
-	for (int32_t u=0; u<width;  u+=D_candidate_stepsize) D_can_width++;
-	for (int32_t v=0; v<height; v+=D_candidate_stepsize) D_can_height++;
+	int32_t D_candidate_stepsize,D_can_width,D_can_height;
+	supportGrid(D_candidate_stepsize,D_can_width,D_can_height);
 	int16_t* D_can = (int16_t*)calloc(D_can_width*D_can_height,sizeof(int16_t));
 
-	// loop variables
-	int32_t u,v;
-	int16_t d,d2;
-	int32_t u_can, v_can;
+	// previous frame seeds, only usable on the same grid
+	int16_t* D_seed = 0;
+	if (param.support_reuse && D_prev_width==D_can_width && D_prev_height==D_can_height)
+		D_seed = D_prev.data();
+	int32_t reuse_radius = param.support_reuse_radius;
+
 	int32_t lr_threshold = param.lr_threshold;
 	vector<support_pt> p_support;
-	vector<support_pt> partial_p_support[2];
 	// for all point candidates in image 1 do
-	#pragma omp parallel default(none) num_threads(2) private(u_can, v_can, u, d, v, d2) shared(partial_p_support,lr_threshold, D_can, D_can_width, D_can_height, D_candidate_stepsize, I1_desc, I2_desc)
-	{
-		int tid = omp_get_thread_num();
-	#pragma omp for
-	for (v_can=1; v_can<D_can_height; v_can++) {
-		v = v_can*D_candidate_stepsize;
-		for (u_can=1; u_can<D_can_width; u_can++) {
-			u = u_can*D_candidate_stepsize;
+	elasParallelFor(1,D_can_height,[&](int32_t v_can) {
+		int32_t v = v_can*D_candidate_stepsize;
+		for (int32_t u_can=1; u_can<D_can_width; u_can++) {
+			int32_t u = u_can*D_candidate_stepsize;
+			int16_t d,d2;
 
 			// initialize disparity candidate to invalid
 			*(D_can+getAddressOffsetImage(u_can,v_can,D_can_width)) = -1;
 
+			// verify the seed with a narrow search, a minimum on the window border may continue outside of it
+			int16_t d_seed = D_seed ? *(D_seed+getAddressOffsetImage(u_can,v_can,D_can_width)) : -1;
+			if (d_seed>=0) {
+				d = computeMatchingDisparity(u,v,I1_desc,I2_desc,false,d_seed-reuse_radius,d_seed+reuse_radius);
+				if (d>=0 && d!=d_seed-reuse_radius && d!=d_seed+reuse_radius) {
+					d2 = computeMatchingDisparity(u-d,v,I1_desc,I2_desc,true,d-reuse_radius,d+reuse_radius);
+					if (d2>=0 && abs(d-d2)<=lr_threshold) {
+						*(D_can+getAddressOffsetImage(u_can,v_can,D_can_width)) = d;
+						continue;
+					}
+				}
+			}
+
 			// find forwards
 			d = computeMatchingDisparity(u,v,I1_desc,I2_desc,false);
 			if (d>=0) {
@@ -423,37 +461,24 @@ vector<Elas::support_pt> Elas::computeSupportMatches (uint8_t* I1_desc,uint8_t*
 					*(D_can+getAddressOffsetImage(u_can,v_can,D_can_width)) = d;
 			}
 		}
-	}
-
-
+	},4);
 
 	// remove inconsistent support points
-	//timer.start("removeInconsistentSupportPoints");
 	removeInconsistentSupportPoints(D_can,D_can_width,D_can_height);
 
 	// remove support points on straight lines, since they are redundant
 	// this reduces the number of triangles a little bit and hence speeds up
 	// the triangulation process
-	//timer.start("removeRedundantSupportPoints");
 	removeRedundantSupportPoints(D_can,D_can_width,D_can_height,5,1,true);
 	removeRedundantSupportPoints(D_can,D_can_width,D_can_height,5,1,false);
 
-	//}
 	// move support points from image representation into a vector representation
-	//timer.start("segundo for");
-
-
-
-	#pragma omp for
 	for (int32_t v_can=1; v_can<D_can_height; v_can++)
 		for (int32_t u_can=1; u_can<D_can_width; u_can++)
 			if (*(D_can+getAddressOffsetImage(u_can,v_can,D_can_width))>=0)
-				partial_p_support[tid].push_back(support_pt(u_can*D_candidate_stepsize,
+				p_support.push_back(support_pt(u_can*D_candidate_stepsize,
 						v_can*D_candidate_stepsize,
 						*(D_can+getAddressOffsetImage(u_can,v_can,D_can_width))));
-	}
-	p_support = partial_p_support[0];
-	p_support.insert(p_support.end(),partial_p_support[1].begin(),partial_p_support[1].end());
 
 	// if flag is set, add support points in image corners
 	// with the same disparity as the nearest neighbor support point
@@ -468,137 +493,85 @@ vector<Elas::support_pt> Elas::computeSupportMatches (uint8_t* I1_desc,uint8_t*
 	return p_support;
 }
 
-vector<Elas::triangle> Elas::computeDelaunayTriangulation (vector<support_pt> p_support,int32_t right_image) {
+void Elas::storeSupportSeeds (float* D) {
 
-	// input/output structure for triangulation
-	struct triangulateio in, out;
-	int32_t k;
+	int32_t D_candidate_stepsize;
+	supportGrid(D_candidate_stepsize,D_prev_width,D_prev_height);
+	D_prev.assign(D_prev_width*D_prev_height,-1);
 
-	// inputs
-	in.numberofpoints = p_support.size();
-	in.pointlist = (float*)malloc(in.numberofpoints*2*sizeof(float));
-	k=0;
-	if (!right_image) {
-		for (int32_t i=0; i<p_support.size(); i++) {
-			in.pointlist[k++] = p_support[i].u;
-			in.pointlist[k++] = p_support[i].v;
-		}
-	} else {
-		for (int32_t i=0; i<p_support.size(); i++) {
-			in.pointlist[k++] = p_support[i].u-p_support[i].d;
-			in.pointlist[k++] = p_support[i].v;
+	// final disparities sampled at the candidate grid, invalid ones are negative
+	for (int32_t v_can=1; v_can<D_prev_height; v_can++) {
+		for (int32_t u_can=1; u_can<D_prev_width; u_can++) {
+			int32_t u = u_can*D_candidate_stepsize;
+			int32_t v = v_can*D_candidate_stepsize;
+			float d;
+			if (param.subsampling) {
+				if (u/2>=width/2 || v/2>=height/2) continue;
+				d = *(D+getAddressOffsetImage(u/2,v/2,width/2));
+			} else {
+				d = *(D+getAddressOffsetImage(u,v,width));
+			}
+			if (d>=0)
+				D_prev[getAddressOffsetImage(u_can,v_can,D_prev_width)] = (int16_t)(d+0.5f);
 		}
 	}
-	in.numberofpointattributes = 0;
-	in.pointattributelist      = NULL;
-	in.pointmarkerlist         = NULL;
-	in.numberofsegments        = 0;
-	in.numberofholes           = 0;
-	in.numberofregions         = 0;
-	in.regionlist              = NULL;
-
-	// outputs
-	out.pointlist              = NULL;
-	out.pointattributelist     = NULL;
-	out.pointmarkerlist        = NULL;
-	out.trianglelist           = NULL;
-	out.triangleattributelist  = NULL;
-	out.neighborlist           = NULL;
-	out.segmentlist            = NULL;
-	out.segmentmarkerlist      = NULL;
-	out.edgelist               = NULL;
-	out.edgemarkerlist         = NULL;
-
-	// do triangulation (z=zero-based, n=neighbors, Q=quiet, B=no boundary markers)
-	char parameters[] = "zQB";
-	triangulate(parameters, &in, &out, NULL);
+}
 
-	// put resulting triangles into vector tri
-	vector<triangle> tri;
-	k=0;
-	for (int32_t i=0; i<out.numberoftriangles; i++) {
-		tri.push_back(triangle(out.trianglelist[k],out.trianglelist[k+1],out.trianglelist[k+2]));
-		k+=3;
+vector<Elas::triangle> Elas::computeDelaunayTriangulation (const vector<support_pt> &p_support,int32_t right_image) {
+
+	// support point coordinates in the left or right image
+	int32_t num = p_support.size();
+	vector<int32_t> points(num*2);
+	for (int32_t i=0; i<num; i++) {
+		points[2*i]   = right_image ? p_support[i].u-p_support[i].d : p_support[i].u;
+		points[2*i+1] = p_support[i].v;
 	}
 
-	// free memory used for triangulation
-	free(in.pointlist);
-	free(out.pointlist);
-	free(out.trianglelist);
+	// left and right images have their own triangulator, they run concurrently
+	vector<int32_t> corners;
+	delaunay[right_image].triangulate(points.data(),num,corners);
+
+	// put resulting triangles into vector tri
+	vector<triangle> tri;
+	tri.reserve(corners.size()/3);
+	for (size_t k=0; k<corners.size(); k+=3)
+		tri.push_back(triangle(corners[k],corners[k+1],corners[k+2]));
 
 	// return triangles
 	return tri;
 }
 
-void Elas::computeDisparityPlanes (vector<support_pt> p_support,vector<triangle> &tri,int32_t right_image) {
+// plane d = a*u+b*v+c through three points by Cramer's rule, zero plane for
+// degenerate triangles (integer coordinates make the determinant exact)
+static inline void solvePlane (int32_t u1,int32_t v1,int32_t d1,int32_t u2,int32_t v2,int32_t d2,
+                               int32_t u3,int32_t v3,int32_t d3,float &a,float &b,float &c) {
+	int64_t det = (int64_t)(u2-u1)*(v3-v1)-(int64_t)(u3-u1)*(v2-v1);
+	if (det==0) {
+		a = b = c = 0;
+		return;
+	}
+	double pa = (double)((int64_t)(d2-d1)*(v3-v1)-(int64_t)(d3-d1)*(v2-v1))/det;
+	double pb = (double)((int64_t)(u2-u1)*(d3-d1)-(int64_t)(u3-u1)*(d2-d1))/det;
+	a = pa;
+	b = pb;
+	c = d1-pa*u1-pb*v1;
+}
 
-	// init matrices
-	Matrix A(3,3);
-	Matrix b(3,1);
+void Elas::computeDisparityPlanes (const vector<support_pt> &p_support,vector<triangle> &tri,int32_t right_image) {
 
 	// for all triangles do
 	for (int32_t i=0; i<tri.size(); i++) {
 
-		// get triangle corner indices
-		int32_t c1 = tri[i].c1;
-		int32_t c2 = tri[i].c2;
-		int32_t c3 = tri[i].c3;
-
-		// compute matrix A for linear system of left triangle
-		A.val[0][0] = p_support[c1].u;
-		A.val[1][0] = p_support[c2].u;
-		A.val[2][0] = p_support[c3].u;
-		A.val[0][1] = p_support[c1].v; A.val[0][2] = 1;
-		A.val[1][1] = p_support[c2].v; A.val[1][2] = 1;
-		A.val[2][1] = p_support[c3].v; A.val[2][2] = 1;
-
-		// compute vector b for linear system (containing the disparities)
-		b.val[0][0] = p_support[c1].d;
-		b.val[1][0] = p_support[c2].d;
-		b.val[2][0] = p_support[c3].d;
-
-		// on success of gauss jordan elimination
-		if (b.solve(A)) {
-
-			// grab results from b
-			tri[i].t1a = b.val[0][0];
-			tri[i].t1b = b.val[1][0];
-			tri[i].t1c = b.val[2][0];
-
-			// otherwise: invalid
-		} else {
-			tri[i].t1a = 0;
-			tri[i].t1b = 0;
-			tri[i].t1c = 0;
-		}
-
-		// compute matrix A for linear system of right triangle
-		A.val[0][0] = p_support[c1].u-p_support[c1].d;
-		A.val[1][0] = p_support[c2].u-p_support[c2].d;
-		A.val[2][0] = p_support[c3].u-p_support[c3].d;
-		A.val[0][1] = p_support[c1].v; A.val[0][2] = 1;
-		A.val[1][1] = p_support[c2].v; A.val[1][2] = 1;
-		A.val[2][1] = p_support[c3].v; A.val[2][2] = 1;
-
-		// compute vector b for linear system (containing the disparities)
-		b.val[0][0] = p_support[c1].d;
-		b.val[1][0] = p_support[c2].d;
-		b.val[2][0] = p_support[c3].d;
+		// get triangle corners
+		const support_pt &p1 = p_support[tri[i].c1];
+		const support_pt &p2 = p_support[tri[i].c2];
+		const support_pt &p3 = p_support[tri[i].c3];
 
-		// on success of gauss jordan elimination
-		if (b.solve(A)) {
+		// plane of the left triangle
+		solvePlane(p1.u,p1.v,p1.d,p2.u,p2.v,p2.d,p3.u,p3.v,p3.d,tri[i].t1a,tri[i].t1b,tri[i].t1c);
 
-			// grab results from b
-			tri[i].t2a = b.val[0][0];
-			tri[i].t2b = b.val[1][0];
-			tri[i].t2c = b.val[2][0];
-
-			// otherwise: invalid
-		} else {
-			tri[i].t2a = 0;
-			tri[i].t2b = 0;
-			tri[i].t2c = 0;
-		}
+		// plane of the right triangle
+		solvePlane(p1.u-p1.d,p1.v,p1.d,p2.u-p2.d,p2.v,p2.d,p3.u-p3.d,p3.v,p3.d,tri[i].t2a,tri[i].t2b,tri[i].t2c);
 	}
 }
 
@@ -832,20 +805,13 @@ void Elas::computeDisparity(vector<support_pt> p_support,vector<triangle> tri,in
 		P[delta_d] = (int32_t)((-log(param.gamma+exp(-delta_d*delta_d/two_sigma_squared))+log(param.gamma))/param.beta);
 	int32_t plane_radius = (int32_t)max((float)ceil(param.sigma*param.sradius),(float)2.0);
 
-	// loop variables
-	int32_t c1, c2, c3;
-	float plane_a,plane_b,plane_c,plane_d;
-	uint32_t i;
-
 	// for all triangles do
-#pragma omp parallel for num_threads(3) default(none)\
-	private(i, plane_a, plane_b, plane_c, plane_d, c1, c2, c3)\
-	shared(P, plane_radius, two_sigma_squared, disp_num, window_size, p_support, tri, disparity_grid, grid_dims, I1_desc, I2_desc, right_image, D)
-	for (i=0; i<tri.size(); i++) {
+	elasParallelFor(0,(int32_t)tri.size(),[&](int32_t i) {
+		float plane_a,plane_b,plane_c,plane_d;
+		int32_t c1, c2, c3;
+
 
-		//printf("Matching thread %d\n", omp_get_thread_num());
 		// get plane parameters
-		uint32_t p_i = i*3;
 		if (!right_image) {
 			plane_a = tri[i].t1a;
 			plane_b = tri[i].t1b;
@@ -933,7 +899,7 @@ void Elas::computeDisparity(vector<support_pt> p_support,vector<triangle> tri,in
 			}
 		}
 
-	}
+	},16);
 
 	delete[] P;
 }
@@ -1010,6 +976,28 @@ void Elas::leftRightConsistencyCheck(float* D1,float* D2) {
 	free(D2_copy);
 }
 
+// union-find labels: a root stores the negative segment size, any other pixel
+// an address of the same segment that is smaller than its own
+static inline int32_t findSegment (int32_t* L,int32_t a) {
+	while (L[a]>=0) {
+		if (L[L[a]]>=0)
+			L[a] = L[L[a]];
+		a = L[a];
+	}
+	return a;
+}
+
+static inline void uniteSegments (int32_t* L,int32_t a,int32_t b) {
+	a = findSegment(L,a);
+	b = findSegment(L,b);
+	if (a==b)
+		return;
+	if (a>b)
+		std::swap(a,b);
+	L[a] += L[b];
+	L[b]  = a;
+}
+
 void Elas::removeSmallSegments (float* D) {
 
 	// get disparity image dimensions
@@ -1022,112 +1010,64 @@ void Elas::removeSmallSegments (float* D) {
 		D_speckle_size = sqrt((float)param.speckle_size)*2;
 	}
 
-	// allocate memory on heap for dynamic programming arrays
-	int32_t *D_done     = (int32_t*)calloc(D_width*D_height,sizeof(int32_t));
-	int32_t *seg_list_u = (int32_t*)calloc(D_width*D_height,sizeof(int32_t));
-	int32_t *seg_list_v = (int32_t*)calloc(D_width*D_height,sizeof(int32_t));
-	int32_t seg_list_count;
-	int32_t seg_list_curr;
-	int32_t u_neighbor[4];
-	int32_t v_neighbor[4];
-	int32_t u_seg_curr;
-	int32_t v_seg_curr;
-
-	// declare loop variables
-	int32_t addr_start, addr_curr, addr_neighbor;
-
-	// for all pixels do
-	for (int32_t u=0; u<D_width; u++) {
-		for (int32_t v=0; v<D_height; v++) {
-
-			// get address of first pixel in this segment
-			addr_start = getAddressOffsetImage(u,v,D_width);
-
-			// if this pixel has not already been processed
-			if (*(D_done+addr_start)==0) {
-
-				// init segment list (add first element
-				// and set it to be the next element to check)
-				*(seg_list_u+0) = u;
-				*(seg_list_v+0) = v;
-				seg_list_count  = 1;
-				seg_list_curr   = 0;
-
-				// add neighboring segments as long as there
-				// are none-processed pixels in the seg_list;
-				// none-processed means: seg_list_curr<seg_list_count
-				while (seg_list_curr<seg_list_count) {
+	// valid 4-neighbors with similar disparities belong to the same segment
+	const float sim_threshold = param.speckle_sim_threshold;
+	auto similar = [&](int32_t a,int32_t b) {
+		return *(D+b)>=0 && fabs(*(D+a)-*(D+b))<=sim_threshold;
+	};
 
-					// get current position from seg_list
-					u_seg_curr = *(seg_list_u+seg_list_curr);
-					v_seg_curr = *(seg_list_v+seg_list_curr);
+	// one label per pixel instead of the flood fill lists
+	int32_t *L = (int32_t*)malloc(D_width*D_height*sizeof(int32_t));
 
-					// get address of current pixel in this segment
-					addr_curr = getAddressOffsetImage(u_seg_curr,v_seg_curr,D_width);
+	// label row bands in parallel, links stay inside the band
+	const int32_t band_count = max(1,min(elasThreadsCount()*2,D_height/32));
 
-					// fill list with neighbor positions
-					u_neighbor[0] = u_seg_curr-1; v_neighbor[0] = v_seg_curr;
-					u_neighbor[1] = u_seg_curr+1; v_neighbor[1] = v_seg_curr;
-					u_neighbor[2] = u_seg_curr;   v_neighbor[2] = v_seg_curr-1;
-					u_neighbor[3] = u_seg_curr;   v_neighbor[3] = v_seg_curr+1;
-
-					// for all neighbors do
-					for (int32_t i=0; i<4; i++) {
-
-						// check if neighbor is inside image
-						if (u_neighbor[i]>=0 && v_neighbor[i]>=0 && u_neighbor[i]<D_width && v_neighbor[i]<D_height) {
-
-							// get neighbor pixel address
-							addr_neighbor = getAddressOffsetImage(u_neighbor[i],v_neighbor[i],D_width);
-
-							// check if neighbor has not been added yet and if it is valid
-							if (*(D_done+addr_neighbor)==0 && *(D+addr_neighbor)>=0) {
-
-								// is the neighbor similar to the current pixel
-								// (=belonging to the current segment)
-								if (fabs(*(D+addr_curr)-*(D+addr_neighbor))<=param.speckle_sim_threshold) {
-
-									// add neighbor coordinates to segment list
-									*(seg_list_u+seg_list_count) = u_neighbor[i];
-									*(seg_list_v+seg_list_count) = v_neighbor[i];
-									seg_list_count++;
-
-									// set neighbor pixel in I_done to "done"
-									// (otherwise a pixel may be added 2 times to the list, as
-									//  neighbor of one pixel and as neighbor of another pixel)
-									*(D_done+addr_neighbor) = 1;
-								}
-							}
-
-						}
-					}
-
-					// set current pixel in seg_list to "done"
-					seg_list_curr++;
-
-					// set current pixel in I_done to "done"
-					*(D_done+addr_curr) = 1;
-
-				} // end: while (seg_list_curr<seg_list_count)
+	elasParallelFor(0,band_count,[&](int32_t band) {
+		int32_t v_begin = band*D_height/band_count;
+		int32_t v_end   = (band+1)*D_height/band_count;
+		for (int32_t v=v_begin; v<v_end; v++) {
+			for (int32_t u=0; u<D_width; u++) {
+				int32_t addr = getAddressOffsetImage(u,v,D_width);
+				*(L+addr) = -1;
+				if (*(D+addr)<0)
+					continue;
+				if (u>0 && similar(addr,addr-1))
+					uniteSegments(L,addr,addr-1);
+				if (v>v_begin && similar(addr,addr-D_width))
+					uniteSegments(L,addr,addr-D_width);
+			}
+		}
+	});
 
-				// if segment NOT large enough => invalidate pixels
-				if (seg_list_count<D_speckle_size) {
+	// join segments across band borders
+	for (int32_t band=1; band<band_count; band++) {
+		int32_t v = band*D_height/band_count;
+		for (int32_t u=0; u<D_width; u++) {
+			int32_t addr = getAddressOffsetImage(u,v,D_width);
+			if (*(D+addr)>=0 && similar(addr,addr-D_width))
+				uniteSegments(L,addr,addr-D_width);
+		}
+	}
 
-					// for all pixels in current segment invalidate pixels
-					for (int32_t i=0; i<seg_list_count; i++) {
-						addr_curr = getAddressOffsetImage(*(seg_list_u+i),*(seg_list_v+i),D_width);
-						*(D+addr_curr) = -10;
-					}
-				}
-			} // end: if (*(I_done+addr_start)==0)
+	// parents have smaller addresses, so one pass in address order points every pixel to its root
+	for (int32_t addr=0; addr<D_width*D_height; addr++)
+		if (*(L+addr)>=0 && *(L+*(L+addr))>=0)
+			*(L+addr) = *(L+*(L+addr));
 
+	// invalidate pixels of small segments
+	elasParallelFor(0,D_height,[&](int32_t v) {
+		for (int32_t u=0; u<D_width; u++) {
+			int32_t addr = getAddressOffsetImage(u,v,D_width);
+			if (*(D+addr)<0)
+				continue;
+			int32_t root = *(L+addr)<0 ? addr : *(L+addr);
+			if (-*(L+root)<D_speckle_size)
+				*(D+addr) = -10;
 		}
-	}
+	},16);
 
 	// free memory
-	free(D_done);
-	free(seg_list_u);
-	free(seg_list_v);
+	free(L);
 }
 
 void Elas::gapInterpolation(float* D) {
@@ -30,6 +30,7 @@ Street, Fifth Floor, Boston, MA 02110-1301, USA
 #include <stdlib.h>
 #include <vector>
 #include <emmintrin.h>
+#include "delaunay.h"
 //#define PROFILE 1
 
 // define fixed-width datatypes for Visual Studio projects
@@ -54,6 +55,11 @@ class Elas {
 
 public:
 
+  // implementation of gap interpolation, adaptive mean and median filters:
+  // reference single threaded code or row band parallel SSE / AVX2 code,
+  // AVX2 falls back to SSE on processors without it
+  enum postprocess_mode { POSTPROCESS_SCALAR=0, POSTPROCESS_SSE=1, POSTPROCESS_AVX2=2 };
+
   // parameter settings
   struct parameters {
     int32_t disp_min;               // min disparity
@@ -81,6 +87,9 @@ public:
     bool    subsampling;            // saves time by only computing disparities for each 2nd pixel
                                     // note: for this option D1 and D2 must be passed with size
                                     //       width/2 x height/2 (rounded towards zero)
+    bool    support_reuse;          // seed support points with the previous frame disparities (video input)
+    int32_t support_reuse_radius;   // disparity search radius around a seed when verifying it
+    int32_t postprocess_mode;       // post-processing filters implementation, see postprocess_mode
 
     // constructor
     parameters () {
@@ -111,6 +120,9 @@ public:
         filter_adaptive_mean  = 1;
         postprocess_only_left = 1;
         subsampling           = 0;
+        support_reuse         = 0;
+        support_reuse_radius  = 3;
+        postprocess_mode      = POSTPROCESS_AVX2;
 
       // default settings for middlebury benchmark
       // (interpolate all missing disparities)
@@ -118,8 +130,8 @@ public:
   };
 
   // constructor, input: parameters
-  Elas (parameters param) : param(param) {}
-  Elas () {}
+  Elas (parameters param) : param(param),D_prev_width(0),D_prev_height(0) {}
+  Elas () : D_prev_width(0),D_prev_height(0) {}
 
   // deconstructor
   ~Elas () {}
@@ -135,6 +147,19 @@ public:
   //               otherwise width/2 x height/2 (rounded towards zero)
   void process (uint8_t* I1,uint8_t* I2,float* D1,float* D2,const int32_t* dims);
 
+  // support point seeds from the previous frame, a full search runs only where a seed fails verification
+  void setSupportReuse (bool value) { param.support_reuse = value; resetSupport(); }
+  bool supportReuse () const { return param.support_reuse; }
+  void resetSupport () { D_prev.clear(); }
+
+  // disparity search range, support seeds of the previous range are dropped
+  void setDisparityRange (int32_t disp_min,int32_t disp_max) { param.disp_min = disp_min; param.disp_max = disp_max; resetSupport(); }
+  int32_t disparityMin () const { return param.disp_min; }
+  int32_t disparityMax () const { return param.disp_max; }
+
+  void setPostprocessMode (int32_t mode) { param.postprocess_mode = mode; }
+  int32_t postprocessMode () const { return param.postprocess_mode; }
+
 private:
 
   struct support_pt {
@@ -165,11 +190,15 @@ private:
                                      int32_t redun_max_dist, int32_t redun_threshold, bool vertical);
   void addCornerSupportPoints (std::vector<support_pt> &p_support);
   inline int16_t computeMatchingDisparity (const int32_t &u,const int32_t &v,uint8_t* I1_desc,uint8_t* I2_desc,const bool &right_image);
+  inline int16_t computeMatchingDisparity (const int32_t &u,const int32_t &v,uint8_t* I1_desc,uint8_t* I2_desc,const bool &right_image,
+                                           const int32_t &d_from,const int32_t &d_to);
+  void supportGrid (int32_t &stepsize,int32_t &grid_width,int32_t &grid_height);
   std::vector<support_pt> computeSupportMatches (uint8_t* I1_desc,uint8_t* I2_desc);
+  void storeSupportSeeds (float* D);
 
   // triangulation & grid
-  std::vector<triangle> computeDelaunayTriangulation (std::vector<support_pt> p_support,int32_t right_image);
-  void computeDisparityPlanes (std::vector<support_pt> p_support,std::vector<triangle> &tri,int32_t right_image);
+  std::vector<triangle> computeDelaunayTriangulation (const std::vector<support_pt> &p_support,int32_t right_image);
+  void computeDisparityPlanes (const std::vector<support_pt> &p_support,std::vector<triangle> &tri,int32_t right_image);
   void createGrid (std::vector<support_pt> p_support,int32_t* disparity_grid,int32_t* grid_dims,bool right_image);
 
   // matching
@@ -194,6 +223,12 @@ private:
   void adaptiveMean (float* D);
   void median (float* D);
 
+  // vectorized row band parallel postprocessing, postprocess.cpp
+  bool useAvx2 () const;
+  void gapInterpolationParallel (float* D);
+  void adaptiveMeanParallel (float* D);
+  void medianParallel (float* D);
+
   // parameter set
   parameters param;
 
@@ -201,6 +236,13 @@ private:
   uint8_t *I1,*I2;
   int32_t width,height,bpl;
 
+  // previous frame disparities on the support candidate grid, empty without a previous frame
+  std::vector<int16_t> D_prev;
+  int32_t D_prev_width,D_prev_height;
+
+  // support point triangulators of the left and right image, keep their buffers between frames
+  Delaunay delaunay[2];
+
   // profiling timer
 #ifdef PROFILE
   Timer timer;
@@ -0,0 +1,26 @@
+/*
+Parallel loop hook of libelas, see parallel.h.
+*/
+
+#include "parallel.h"
+
+static ParallelForHook parallel_for_hook = 0;
+static int32_t         parallel_threads  = 1;
+
+void setParallelForHook (ParallelForHook hook,int32_t threads_count) {
+	parallel_for_hook = hook;
+	parallel_threads  = hook && threads_count>1 ? threads_count : 1;
+}
+
+void elasParallelFor (int32_t begin,int32_t end,const std::function<void(int32_t)> &body,int32_t grain) {
+	if (parallel_for_hook) {
+		parallel_for_hook(begin,end,body,grain);
+		return;
+	}
+	for (int32_t i=begin; i<end; i++)
+		body(i);
+}
+
+int32_t elasThreadsCount () {
+	return parallel_threads;
+}
@@ -0,0 +1,29 @@
+/*
+Parallel loop hook of libelas. Loops run serially unless the application
+installs its own scheduler, so the library keeps no threading dependency.
+*/
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include <functional>
+
+#ifndef _MSC_VER
+  #include <stdint.h>
+#else
+  typedef __int32           int32_t;
+#endif
+
+// runs body(i) for every i in [begin,end), possibly concurrently, and returns
+// when all are done; grain is the smallest useful number of iterations per task
+typedef void (*ParallelForHook) (int32_t begin,int32_t end,const std::function<void(int32_t)> &body,int32_t grain);
+
+// installs hook with the number of threads it runs on, NULL restores the serial loop
+void setParallelForHook (ParallelForHook hook,int32_t threads_count);
+
+void elasParallelFor (int32_t begin,int32_t end,const std::function<void(int32_t)> &body,int32_t grain=1);
+
+// threads of the installed hook, 1 for the serial loop
+int32_t elasThreadsCount ();
+
+#endif
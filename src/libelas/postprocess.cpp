@@ -0,0 +1,372 @@
+/*
+Vectorized and row band parallel versions of the ELAS post-processing filters.
+They follow gapInterpolation, adaptiveMean and median in elas.cpp, which stay
+as the reference implementation (postprocess_mode = POSTPROCESS_SCALAR).
+*/
+
+#include "elas.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <immintrin.h>
+
+#include "parallel.h"
+
+using namespace std;
+
+static bool cpuHasAvx2 () {
+	static const bool ret = __builtin_cpu_supports("avx2");
+	return ret;
+}
+
+bool Elas::useAvx2 () const {
+	return param.postprocess_mode==POSTPROCESS_AVX2 && cpuHasAvx2();
+}
+
+// gap interpolation
+
+static void interpolateRowGaps (float* D_row,int32_t D_width,int32_t D_ipol_gap_width,float discon_threshold,bool add_corners) {
+
+	int32_t count = 0;
+
+	for (int32_t u=0; u<D_width; u++) {
+		if (D_row[u]>=0) {
+			if (count>=1 && count<=D_ipol_gap_width) {
+				int32_t u_first = u-count;
+				int32_t u_last  = u-1;
+				if (u_first>0 && u_last<D_width-1) {
+					float d1 = D_row[u_first-1];
+					float d2 = D_row[u_last+1];
+					float d_ipol = fabs(d1-d2)<discon_threshold ? (d1+d2)/2 : min(d1,d2);
+					for (int32_t u_curr=u_first; u_curr<=u_last; u_curr++)
+						D_row[u_curr] = d_ipol;
+				}
+			}
+			count = 0;
+		} else {
+			count++;
+		}
+	}
+
+	if (add_corners) {
+		for (int32_t u=0; u<D_width; u++) {
+			if (D_row[u]>=0) {
+				for (int32_t u2=max(u-D_ipol_gap_width,0); u2<u; u2++)
+					D_row[u2] = D_row[u];
+				break;
+			}
+		}
+		for (int32_t u=D_width-1; u>=0; u--) {
+			if (D_row[u]>=0) {
+				for (int32_t u2=u; u2<=min(u+D_ipol_gap_width,D_width-1); u2++)
+					D_row[u2] = D_row[u];
+				break;
+			}
+		}
+	}
+}
+
+static inline void closeColumnGap (float* D,int32_t D_width,int32_t u,int32_t v,int32_t count,int32_t D_ipol_gap_width,float discon_threshold) {
+
+	if (count<1 || count>D_ipol_gap_width)
+		return;
+
+	int32_t v_first = v-count;
+	int32_t v_last  = v-1;
+	if (v_first<=0)
+		return;
+
+	float d1 = D[(v_first-1)*D_width+u];
+	float d2 = D[(v_last+1)*D_width+u];
+	float d_ipol = fabs(d1-d2)<discon_threshold ? (d1+d2)/2 : min(d1,d2);
+	for (int32_t v_curr=v_first; v_curr<=v_last; v_curr++)
+		D[v_curr*D_width+u] = d_ipol;
+}
+
+void Elas::gapInterpolationParallel (float* D) {
+
+	int32_t D_width          = width;
+	int32_t D_height         = height;
+	int32_t D_ipol_gap_width = param.ipol_gap_width;
+	if (param.subsampling) {
+		D_width          = width/2;
+		D_height         = height/2;
+		D_ipol_gap_width = param.ipol_gap_width/2+1;
+	}
+
+	const float discon_threshold = 3.0;
+	const bool add_corners = param.add_corners;
+
+	// 1. rows are independent
+	elasParallelFor(0,D_height,[&](int32_t v) {
+		interpolateRowGaps(D+v*D_width,D_width,D_ipol_gap_width,discon_threshold,add_corners);
+	},16);
+
+	// 2. columns in strips, swept row by row with a gap counter per column,
+	// so memory is read along rows and gap ends are found four columns at a time
+	const int32_t strip_width = 64;
+
+	elasParallelFor(0,(D_width+strip_width-1)/strip_width,[&](int32_t strip) {
+		int32_t u_begin = strip*strip_width;
+		int32_t u_end   = min(D_width,u_begin+strip_width);
+
+		alignas(16) int32_t count[strip_width] = {};
+
+		const __m128  xzero  = _mm_setzero_ps();
+		const __m128i xzeroi = _mm_setzero_si128();
+		const __m128i xone   = _mm_set1_epi32(1);
+
+		for (int32_t v=0; v<D_height; v++) {
+			float* D_row = D+v*D_width;
+			int32_t u = u_begin;
+
+			for (; u+4<=u_end; u+=4) {
+				int32_t* c = count+(u-u_begin);
+				__m128i xvalid = _mm_castps_si128(_mm_cmpge_ps(_mm_loadu_ps(D_row+u),xzero));
+				__m128i xcount = _mm_load_si128((__m128i*)c);
+
+				// valid pixels right after a gap
+				int32_t closed = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(xvalid,_mm_cmpgt_epi32(xcount,xzeroi))));
+				for (int32_t k=0; closed; k++, closed>>=1)
+					if (closed&1)
+						closeColumnGap(D,D_width,u+k,v,c[k],D_ipol_gap_width,discon_threshold);
+
+				_mm_store_si128((__m128i*)c,_mm_andnot_si128(xvalid,_mm_add_epi32(xcount,xone)));
+			}
+
+			for (; u<u_end; u++) {
+				int32_t& c = count[u-u_begin];
+				if (D_row[u]>=0) {
+					closeColumnGap(D,D_width,u,v,c,D_ipol_gap_width,discon_threshold);
+					c = 0;
+				} else {
+					c++;
+				}
+			}
+		}
+	});
+}
+
+// adaptive mean
+
+// same mask constant as adaptiveMean, so both paths compute the same weights
+static float adaptiveMeanMask () {
+	return (float)0x7FFFFFFF;
+}
+
+static inline float adaptiveMeanWeight (float x,float center) {
+	float diff = x-center;
+	float mask = adaptiveMeanMask();
+	uint32_t diff_bits,mask_bits;
+	memcpy(&diff_bits,&diff,sizeof(float));
+	memcpy(&mask_bits,&mask,sizeof(float));
+	diff_bits &= mask_bits;
+	memcpy(&diff,&diff_bits,sizeof(float));
+	return max(0.f,4-diff);
+}
+
+// weighted mean of taps src[u+(tap_first+k)*tap_step], k < taps, around src[u] for u in [u_begin,u_end)
+static void adaptiveMeanScalar (const float* src,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step,int32_t tap_first,int32_t taps) {
+	for (int32_t u=u_begin; u<u_end; u++) {
+		float center = src[u];
+		float weight_sum = 0,factor_sum = 0;
+		for (int32_t k=0; k<taps; k++) {
+			float x = src[u+(tap_first+k)*tap_step];
+			float w = adaptiveMeanWeight(x,center);
+			weight_sum += w;
+			factor_sum += x*w;
+		}
+		if (weight_sum>0) {
+			float d = factor_sum/weight_sum;
+			if (d>=0) dst[u] = d;
+		}
+	}
+}
+
+static int32_t adaptiveMeanSse (const float* src,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step,int32_t tap_first,int32_t taps) {
+
+	const __m128 xzero = _mm_setzero_ps();
+	const __m128 xfour = _mm_set1_ps(4);
+	const __m128 xmask = _mm_set1_ps(adaptiveMeanMask());
+
+	int32_t u = u_begin;
+	for (; u+4<=u_end; u+=4) {
+		__m128 xcenter = _mm_loadu_ps(src+u);
+		__m128 xweight = xzero, xfactor = xzero;
+		for (int32_t k=0; k<taps; k++) {
+			__m128 xval = _mm_loadu_ps(src+u+(tap_first+k)*tap_step);
+			__m128 xw   = _mm_max_ps(xzero,_mm_sub_ps(xfour,_mm_and_ps(_mm_sub_ps(xval,xcenter),xmask)));
+			xweight = _mm_add_ps(xweight,xw);
+			xfactor = _mm_add_ps(xfactor,_mm_mul_ps(xval,xw));
+		}
+		__m128 xd    = _mm_div_ps(xfactor,xweight);
+		__m128 xkeep = _mm_and_ps(_mm_cmpgt_ps(xweight,xzero),_mm_cmpge_ps(xd,xzero));
+		__m128 xold  = _mm_loadu_ps(dst+u);
+		_mm_storeu_ps(dst+u,_mm_or_ps(_mm_and_ps(xkeep,xd),_mm_andnot_ps(xkeep,xold)));
+	}
+	return u;
+}
+
+__attribute__((target("avx2")))
+static int32_t adaptiveMeanAvx2 (const float* src,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step,int32_t tap_first,int32_t taps) {
+
+	const __m256 xzero = _mm256_setzero_ps();
+	const __m256 xfour = _mm256_set1_ps(4);
+	const __m256 xmask = _mm256_set1_ps(adaptiveMeanMask());
+
+	int32_t u = u_begin;
+	for (; u+8<=u_end; u+=8) {
+		__m256 xcenter = _mm256_loadu_ps(src+u);
+		__m256 xweight = xzero, xfactor = xzero;
+		for (int32_t k=0; k<taps; k++) {
+			__m256 xval = _mm256_loadu_ps(src+u+(tap_first+k)*tap_step);
+			__m256 xw   = _mm256_max_ps(xzero,_mm256_sub_ps(xfour,_mm256_and_ps(_mm256_sub_ps(xval,xcenter),xmask)));
+			xweight = _mm256_add_ps(xweight,xw);
+			xfactor = _mm256_add_ps(xfactor,_mm256_mul_ps(xval,xw));
+		}
+		__m256 xd    = _mm256_div_ps(xfactor,xweight);
+		__m256 xkeep = _mm256_and_ps(_mm256_cmp_ps(xweight,xzero,_CMP_GT_OQ),_mm256_cmp_ps(xd,xzero,_CMP_GE_OQ));
+		_mm256_storeu_ps(dst+u,_mm256_blendv_ps(_mm256_loadu_ps(dst+u),xd,xkeep));
+	}
+	return u;
+}
+
+void Elas::adaptiveMeanParallel (float* D) {
+
+	int32_t D_width  = width;
+	int32_t D_height = height;
+	if (param.subsampling) {
+		D_width  = width/2;
+		D_height = height/2;
+	}
+
+	// invalid disparities become -10, which gives them zero weight next to valid ones
+	float* D_copy = (float*)malloc(D_width*D_height*sizeof(float));
+	float* D_tmp  = (float*)malloc(D_width*D_height*sizeof(float));
+	for (int32_t i=0; i<D_width*D_height; i++)
+		D_copy[i] = D[i]<0 ? -10 : D[i];
+	memcpy(D_tmp,D_copy,D_width*D_height*sizeof(float));
+
+	// subsampling: 4 taps from -2, full resolution: 8 taps from -4
+	const int32_t taps      = param.subsampling ? 4 : 8;
+	const int32_t tap_first = -taps/2;
+	const bool avx2 = useAvx2();
+
+	auto filter = [&](const float* src,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step) {
+		int32_t u = avx2 ? adaptiveMeanAvx2(src,dst,u_begin,u_end,tap_step,tap_first,taps)
+		                 : adaptiveMeanSse(src,dst,u_begin,u_end,tap_step,tap_first,taps);
+		adaptiveMeanScalar(src,dst,u,u_end,tap_step,tap_first,taps);
+	};
+
+	// horizontal filter
+	elasParallelFor(3,D_height-3,[&](int32_t v) {
+		filter(D_copy+v*D_width,D_tmp+v*D_width,-tap_first,D_width-taps/2+1,1);
+	},16);
+
+	// vertical filter, output rows read D_tmp only, so they are independent as well
+	elasParallelFor(-tap_first,D_height-taps/2+1,[&](int32_t v) {
+		filter(D_tmp+v*D_width,D+v*D_width,3,D_width-3,D_width);
+	},16);
+
+	free(D_copy);
+	free(D_tmp);
+}
+
+// median
+
+// sorting network for the 7 values in x, the median ends up in x[3]
+#define MEDIAN_SORT(a,b,vmin,vmax) { auto t = vmin(x[a],x[b]); x[b] = vmax(x[a],x[b]); x[a] = t; }
+#define MEDIAN7(vmin,vmax) \
+	MEDIAN_SORT(0,6,vmin,vmax) MEDIAN_SORT(2,3,vmin,vmax) MEDIAN_SORT(4,5,vmin,vmax) \
+	MEDIAN_SORT(0,2,vmin,vmax) MEDIAN_SORT(1,4,vmin,vmax) MEDIAN_SORT(3,6,vmin,vmax) \
+	MEDIAN_SORT(0,1,vmin,vmax) MEDIAN_SORT(2,5,vmin,vmax) MEDIAN_SORT(3,4,vmin,vmax) \
+	MEDIAN_SORT(1,2,vmin,vmax) MEDIAN_SORT(4,6,vmin,vmax) \
+	MEDIAN_SORT(2,3,vmin,vmax) MEDIAN_SORT(4,5,vmin,vmax) \
+	MEDIAN_SORT(1,2,vmin,vmax) MEDIAN_SORT(3,4,vmin,vmax) MEDIAN_SORT(5,6,vmin,vmax)
+
+// dst[u] = median of src[u+k*tap_step], |k| <= 3, for valid ref[u], otherwise ref[u]
+static void medianScalar (const float* src,const float* ref,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step) {
+	for (int32_t u=u_begin; u<u_end; u++) {
+		if (ref[u]>=0) {
+			float x[7];
+			for (int32_t k=0; k<7; k++)
+				x[k] = src[u+(k-3)*tap_step];
+			MEDIAN7(min,max)
+			dst[u] = x[3];
+		} else {
+			dst[u] = ref[u];
+		}
+	}
+}
+
+static int32_t medianSse (const float* src,const float* ref,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step) {
+
+	const __m128 xzero = _mm_setzero_ps();
+
+	int32_t u = u_begin;
+	for (; u+4<=u_end; u+=4) {
+		__m128 x[7];
+		for (int32_t k=0; k<7; k++)
+			x[k] = _mm_loadu_ps(src+u+(k-3)*tap_step);
+		MEDIAN7(_mm_min_ps,_mm_max_ps)
+		__m128 xref   = _mm_loadu_ps(ref+u);
+		__m128 xvalid = _mm_cmpge_ps(xref,xzero);
+		_mm_storeu_ps(dst+u,_mm_or_ps(_mm_and_ps(xvalid,x[3]),_mm_andnot_ps(xvalid,xref)));
+	}
+	return u;
+}
+
+__attribute__((target("avx2")))
+static int32_t medianAvx2 (const float* src,const float* ref,float* dst,int32_t u_begin,int32_t u_end,int32_t tap_step) {
+
+	const __m256 xzero = _mm256_setzero_ps();
+
+	int32_t u = u_begin;
+	for (; u+8<=u_end; u+=8) {
+		__m256 x[7];
+		for (int32_t k=0; k<7; k++)
+			x[k] = _mm256_loadu_ps(src+u+(k-3)*tap_step);
+		MEDIAN7(_mm256_min_ps,_mm256_max_ps)
+		__m256 xref = _mm256_loadu_ps(ref+u);
+		_mm256_storeu_ps(dst+u,_mm256_blendv_ps(xref,x[3],_mm256_cmp_ps(xref,xzero,_CMP_GE_OQ)));
+	}
+	return u;
+}
+
+#undef MEDIAN7
+#undef MEDIAN_SORT
+
+void Elas::medianParallel (float* D) {
+
+	int32_t D_width  = width;
+	int32_t D_height = height;
+	if (param.subsampling) {
+		D_width  = width/2;
+		D_height = height/2;
+	}
+
+	// the window border stays zero, as in median
+	float* D_temp = (float*)calloc(D_width*D_height,sizeof(float));
+
+	const int32_t window_size = 3;
+	const bool avx2 = useAvx2();
+
+	auto filter = [&](const float* src,const float* ref,float* dst,int32_t tap_step) {
+		int32_t u = avx2 ? medianAvx2(src,ref,dst,window_size,D_width-window_size,tap_step)
+		                 : medianSse(src,ref,dst,window_size,D_width-window_size,tap_step);
+		medianScalar(src,ref,dst,u,D_width-window_size,tap_step);
+	};
+
+	// horizontal median filter
+	elasParallelFor(window_size,D_height-window_size,[&](int32_t v) {
+		filter(D+v*D_width,D+v*D_width,D_temp+v*D_width,1);
+	},16);
+
+	// vertical median filter, every output only depends on D_temp and its own pixel
+	elasParallelFor(window_size,D_height-window_size,[&](int32_t v) {
+		filter(D_temp+v*D_width,D+v*D_width,D+v*D_width,D_width);
+	},16);
+
+	free(D_temp);
+}
@@ -0,0 +1,110 @@
+#include "src/common/precompiled.h"
+
+#include "replay.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+
+#include <iostream>
+
+static std::vector< std::string > imageList( const QString &path )
+{
+    std::vector< std::string > ret;
+
+    QDir dir( path );
+
+    for ( auto &i : dir.entryInfoList( QStringList() << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp" << "*.tif" << "*.tiff", QDir::Files, QDir::Name ) )
+        ret.push_back( i.absoluteFilePath().toStdString() );
+
+    return ret;
+
+}
+
+int main( int argc, char **argv )
+{
+    QCoreApplication application( argc, argv );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Headless SLAM replay of a recorded or synthetic stereo sequence" );
+    parser.addHelpOption();
+
+    QCommandLineOption calibrationOption( QStringList() << "c" << "calibration", "Stereo calibration file.", "file" );
+    QCommandLineOption leftOption( QStringList() << "l" << "left", "Folder with left images.", "folder" );
+    QCommandLineOption rightOption( QStringList() << "r" << "right", "Folder with right images.", "folder" );
+    QCommandLineOption groundTruthOption( QStringList() << "g" << "ground-truth", "Camera centers, TUM or KITTI poses, one line per frame.", "file" );
+    QCommandLineOption syntheticOption( "synthetic", "Replay a synthetic sequence of this many frames.", "count", "300" );
+    QCommandLineOption shiftOption( "shift", "Synthetic camera shift per frame, pixels.", "pixels", "4" );
+    QCommandLineOption seedOption( QStringList() << "s" << "seed", "Synthetic texture seed.", "seed", "0" );
+    QCommandLineOption threadsOption( QStringList() << "t" << "threads", "OpenCV and OpenMP threads count.", "count", "1" );
+    QCommandLineOption stepOption( "step", "Time step between frames, milliseconds.", "ms", "50" );
+    QCommandLineOption csvOption( "csv", "Save per-frame results to a CSV file.", "file" );
+
+    parser.addOption( calibrationOption );
+    parser.addOption( leftOption );
+    parser.addOption( rightOption );
+    parser.addOption( groundTruthOption );
+    parser.addOption( syntheticOption );
+    parser.addOption( shiftOption );
+    parser.addOption( seedOption );
+    parser.addOption( threadsOption );
+    parser.addOption( stepOption );
+    parser.addOption( csvOption );
+
+    parser.process( application );
+
+    std::unique_ptr< ReplaySource > source;
+
+    if ( parser.isSet( leftOption ) || parser.isSet( rightOption ) ) {
+
+        if ( !parser.isSet( calibrationOption ) || !parser.isSet( leftOption ) || !parser.isSet( rightOption ) ) {
+            std::cerr << "Recorded replay needs calibration, left and right folders" << std::endl;
+            return 1;
+        }
+
+        StereoCalibrationDataShort calibration( parser.value( calibrationOption ).toStdString() );
+
+        if ( !calibration.isOk() ) {
+            std::cerr << "Can't load calibration " << parser.value( calibrationOption ).toStdString() << std::endl;
+            return 1;
+        }
+
+        source.reset( new ImageListSource( calibration, imageList( parser.value( leftOption ) ), imageList( parser.value( rightOption ) ) ) );
+
+    }
+    else {
+        const int disparity = 32;
+
+        source.reset( new SyntheticSource( cv::Size( 640, 480 ), parser.value( syntheticOption ).toUInt(), parser.value( shiftOption ).toInt(), disparity, parser.value( seedOption ).toUInt() ) );
+
+    }
+
+    if ( parser.isSet( groundTruthOption ) && !source->loadGroundTruth( parser.value( groundTruthOption ).toStdString() ) ) {
+        std::cerr << "Can't load ground truth " << parser.value( groundTruthOption ).toStdString() << std::endl;
+        return 1;
+    }
+
+    SlamReplay replay;
+
+    replay.setThreadsCount( parser.value( threadsOption ).toInt() );
+    replay.setTimeStep( std::chrono::milliseconds( parser.value( stepOption ).toInt() ) );
+
+    auto frames = replay.run( *source );
+
+    SlamReplay::printHeader();
+
+    for ( auto &i : frames )
+        SlamReplay::print( i );
+
+    std::cout << std::endl;
+
+    SlamReplay::print( SlamReplay::summarize( frames, *source ) );
+
+    if ( parser.isSet( csvOption ) && !SlamReplay::saveCsv( frames, parser.value( csvOption ).toStdString() ) ) {
+        std::cerr << "Can't save " << parser.value( csvOption ).toStdString() << std::endl;
+        return 1;
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,445 @@
+#include "src/common/precompiled.h"
+
+#include "replay.h"
+
+#include "src/common/syntheticdata.h"
+#include "src/common/tictoc.h"
+
+#include "src/slam/frame.h"
+#include "src/slam/map.h"
+#include "src/slam/world.h"
+
+#include <omp.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+static cv::Vec3d cameraCenter( const StereoCameraMatrix &matrix )
+{
+    auto &projectionMatrix = matrix.leftProjectionMatrix();
+
+    cv::Mat center = -projectionMatrix.rotation().t() * projectionMatrix.translation();
+
+    return cv::Vec3d( center.at< double >( 0, 0 ), center.at< double >( 1, 0 ), center.at< double >( 2, 0 ) );
+}
+
+// ReplaySource
+const StereoCalibrationDataShort &ReplaySource::calibration() const
+{
+    return m_calibration;
+}
+
+void ReplaySource::setGroundTruth( const std::vector< cv::Vec3d > &value )
+{
+    m_groundTruth = value;
+}
+
+const std::vector< cv::Vec3d > &ReplaySource::groundTruth() const
+{
+    return m_groundTruth;
+}
+
+bool ReplaySource::loadGroundTruth( const std::string &fileName )
+{
+    std::ifstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    std::vector< cv::Vec3d > groundTruth;
+
+    std::string line;
+
+    while ( std::getline( stream, line ) ) {
+
+        if ( line.empty() || line[ 0 ] == '#' )
+            continue;
+
+        std::istringstream lineStream( line );
+        std::vector< double > values;
+
+        double value;
+
+        while ( lineStream >> value )
+            values.push_back( value );
+
+        // Camera center, TUM "time tx ty tz qx qy qz qw" or KITTI 3x4 pose rows
+        if ( values.size() == 3 )
+            groundTruth.push_back( cv::Vec3d( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+        else if ( values.size() == 8 )
+            groundTruth.push_back( cv::Vec3d( values[ 1 ], values[ 2 ], values[ 3 ] ) );
+        else if ( values.size() == 12 )
+            groundTruth.push_back( cv::Vec3d( values[ 3 ], values[ 7 ], values[ 11 ] ) );
+        else
+            return false;
+
+    }
+
+    m_groundTruth = groundTruth;
+
+    return true;
+
+}
+
+// ImageListSource
+ImageListSource::ImageListSource( const StereoCalibrationDataShort &calibration, const std::vector< std::string > &leftList, const std::vector< std::string > &rightList )
+    : m_leftList( leftList ), m_rightList( rightList )
+{
+    m_calibration = calibration;
+}
+
+size_t ImageListSource::framesCount() const
+{
+    return std::min( m_leftList.size(), m_rightList.size() );
+}
+
+StampedStereoImage ImageListSource::frame( const size_t index ) const
+{
+    if ( index >= framesCount() )
+        return StampedStereoImage();
+
+    return StampedStereoImage( StampedImage( CvImage( m_leftList[ index ] ) ), StampedImage( CvImage( m_rightList[ index ] ) ) );
+}
+
+// SyntheticSource
+SyntheticSource::SyntheticSource( const cv::Size &frameSize, const size_t framesCount, const int step, const int disparity, const unsigned int seed )
+    : m_frameSize( frameSize ), m_framesCount( framesCount ), m_step( step ), m_disparity( disparity )
+{
+    initialize( seed );
+}
+
+void SyntheticSource::initialize( const unsigned int seed )
+{
+    m_calibration = syntheticStereoCalibration( m_frameSize );
+
+    auto pathLength = m_step * static_cast< int >( m_framesCount > 0 ? m_framesCount - 1 : 0 );
+
+    m_texture = syntheticTexture( cv::Size( m_frameSize.width + m_disparity + pathLength, m_frameSize.height ), seed );
+
+    // The view slides over a fronto-parallel plane, so each pixel of shift moves the camera by baseline / disparity
+    auto baseline = cv::norm( m_calibration.translationVector() );
+
+    for ( size_t i = 0; i < m_framesCount; ++i )
+        m_groundTruth.push_back( cv::Vec3d( static_cast< double >( i * m_step ) * baseline / m_disparity, 0., 0. ) );
+
+}
+
+size_t SyntheticSource::framesCount() const
+{
+    return m_framesCount;
+}
+
+StampedStereoImage SyntheticSource::frame( const size_t index ) const
+{
+    if ( index >= m_framesCount )
+        return StampedStereoImage();
+
+    return syntheticStereoPair( m_texture, cv::Rect( cv::Point( static_cast< int >( index ) * m_step, 0 ), m_frameSize ), m_disparity );
+}
+
+// SlamReplay
+SlamReplay::SlamReplay()
+{
+    initialize();
+}
+
+void SlamReplay::initialize()
+{
+    m_threadsCount = 1;
+    m_timeStep = std::chrono::milliseconds( 50 );
+}
+
+void SlamReplay::setThreadsCount( const int value )
+{
+    m_threadsCount = std::max( 1, value );
+}
+
+int SlamReplay::threadsCount() const
+{
+    return m_threadsCount;
+}
+
+void SlamReplay::setTimeStep( const std::chrono::milliseconds &value )
+{
+    m_timeStep = value;
+}
+
+const std::chrono::milliseconds &SlamReplay::timeStep() const
+{
+    return m_timeStep;
+}
+
+std::vector< ReplayFrame > SlamReplay::run( const ReplaySource &source )
+{
+    std::vector< ReplayFrame > ret;
+
+    cv::setNumThreads( m_threadsCount );
+    omp_set_num_threads( m_threadsCount );
+
+    auto &calibration = source.calibration();
+    auto &groundTruth = source.groundTruth();
+
+    StereoRectificationProcessor rectificationProcessor( calibration );
+
+    auto cropRect = calibration.cropRect();
+    auto projectionMatrix = calibration.projectionMatrix();
+
+    projectionMatrix.movePrincipalPoint( cv::Vec2f( -cropRect.x, -cropRect.y ) );
+
+    auto world = slam::World::create( projectionMatrix );
+
+    // Timestamps advance by a fixed step from the epoch, so the result does not depend on the wall clock
+    std::chrono::time_point< std::chrono::system_clock > startTime;
+
+    std::weak_ptr< slam::StereoKeyFrame > lastKeyFrame;
+
+    bool hasOrigin = false;
+    cv::Vec3d startCenter;
+    cv::Vec3d startTruth;
+
+    for ( size_t i = 0; i < source.framesCount(); ++i ) {
+
+        auto frame = source.frame( i );
+
+        if ( frame.empty() )
+            continue;
+
+        CvImage leftRectifiedImage;
+        CvImage rightRectifiedImage;
+        CvImage leftCroppedImage;
+        CvImage rightCroppedImage;
+
+        if ( !rectificationProcessor.rectify( frame.leftImage(), frame.rightImage(), &leftRectifiedImage, &rightRectifiedImage )
+                || !rectificationProcessor.crop( leftRectifiedImage, rightRectifiedImage, &leftCroppedImage, &rightCroppedImage ) )
+            continue;
+
+        auto time = startTime + static_cast< int64_t >( i ) * m_timeStep;
+
+        StampedImage leftImage( time, leftCroppedImage );
+        StampedImage rightImage( time, rightCroppedImage );
+
+        ReplayFrame result;
+
+        result.index = i;
+
+        TicToc timer;
+
+        result.tracked = world->track( leftImage, rightImage );
+
+        result.trackTime = timer.toc() * 1.e3;
+
+        result.mapsCount = world->maps().size();
+        result.keyFramesCount = 0;
+        result.mapPointsCount = 0;
+
+        for ( auto &map : world->maps() ) {
+
+            result.mapPointsCount += map->mapPoints().size();
+
+            for ( auto &j : map->frames() )
+                if ( std::dynamic_pointer_cast< slam::StereoKeyFrame >( j ) )
+                    ++result.keyFramesCount;
+
+        }
+
+        result.memory = residentMemory();
+        result.positionError = std::numeric_limits< double >::quiet_NaN();
+
+        slam::StereoKeyFramePtr keyFrame;
+
+        if ( !world->maps().empty() ) {
+            auto &frames = world->maps().back()->frames();
+
+            for ( auto j = frames.rbegin(); j != frames.rend() && !keyFrame; ++j )
+                keyFrame = std::dynamic_pointer_cast< slam::StereoKeyFrame >( *j );
+
+        }
+
+        // A new keyframe is created from the current frame, so its pose is compared with this frame ground truth
+        if ( keyFrame && keyFrame != lastKeyFrame.lock() ) {
+
+            lastKeyFrame = keyFrame;
+
+            if ( i < groundTruth.size() ) {
+
+                auto center = cameraCenter( keyFrame->projectionMatrix() );
+
+                if ( !hasOrigin ) {
+                    startCenter = center;
+                    startTruth = groundTruth[ i ];
+                    hasOrigin = true;
+                }
+
+                result.positionError = cv::norm( ( center - startCenter ) - ( groundTruth[ i ] - startTruth ) );
+
+            }
+
+        }
+
+        ret.push_back( result );
+
+    }
+
+    return ret;
+
+}
+
+ReplaySummary SlamReplay::summarize( const std::vector< ReplayFrame > &frames, const ReplaySource &source )
+{
+    ReplaySummary ret;
+
+    ret.framesCount = frames.size();
+    ret.lostCount = 0;
+    ret.fps = 0.;
+    ret.meanTrackTime = 0.;
+    ret.maxTrackTime = 0.;
+    ret.keyFramesCount = frames.empty() ? 0 : frames.back().keyFramesCount;
+    ret.mapPointsCount = frames.empty() ? 0 : frames.back().mapPointsCount;
+    ret.peakMemory = 0;
+    ret.trajectoryError = std::numeric_limits< double >::quiet_NaN();
+    ret.finalDrift = std::numeric_limits< double >::quiet_NaN();
+
+    double totalTime = 0.;
+
+    double squaredError = 0.;
+    size_t errorsCount = 0;
+
+    const ReplayFrame *lastMeasured = nullptr;
+
+    for ( auto &i : frames ) {
+
+        if ( !i.tracked )
+            ++ret.lostCount;
+
+        totalTime += i.trackTime;
+        ret.maxTrackTime = std::max( ret.maxTrackTime, i.trackTime );
+
+        ret.peakMemory = std::max( ret.peakMemory, i.memory );
+
+        if ( !std::isnan( i.positionError ) ) {
+            squaredError += i.positionError * i.positionError;
+            ++errorsCount;
+
+            lastMeasured = &i;
+
+        }
+
+    }
+
+    if ( !frames.empty() )
+        ret.meanTrackTime = totalTime / frames.size();
+
+    if ( totalTime > 0. )
+        ret.fps = frames.size() / ( totalTime * 1.e-3 );
+
+    if ( errorsCount > 0 )
+        ret.trajectoryError = std::sqrt( squaredError / errorsCount );
+
+    // Drift is the last keyframe error relative to the distance travelled up to it
+    if ( lastMeasured ) {
+        auto &groundTruth = source.groundTruth();
+
+        double pathLength = 0.;
+
+        for ( size_t i = frames.front().index + 1; i <= lastMeasured->index && i < groundTruth.size(); ++i )
+            pathLength += cv::norm( groundTruth[ i ] - groundTruth[ i - 1 ] );
+
+        if ( pathLength > 0. )
+            ret.finalDrift = 100. * lastMeasured->positionError / pathLength;
+
+    }
+
+    return ret;
+
+}
+
+void SlamReplay::printHeader()
+{
+    std::cout << std::right << std::setw( 8 ) << "frame" << std::setw( 8 ) << "tracked" << std::setw( 12 ) << "track, ms"
+              << std::setw( 6 ) << "maps" << std::setw( 11 ) << "keyframes" << std::setw( 12 ) << "map points"
+              << std::setw( 12 ) << "memory, MB" << std::setw( 12 ) << "error" << std::endl;
+}
+
+void SlamReplay::print( const ReplayFrame &frame )
+{
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    std::cout << std::right << std::setw( 8 ) << frame.index << std::setw( 8 ) << ( frame.tracked ? "yes" : "no" ) << std::setw( 12 ) << frame.trackTime
+              << std::setw( 6 ) << frame.mapsCount << std::setw( 11 ) << frame.keyFramesCount << std::setw( 12 ) << frame.mapPointsCount
+              << std::setw( 12 ) << frame.memory / ( 1024. * 1024. ) << std::setw( 12 );
+
+    if ( std::isnan( frame.positionError ) )
+        std::cout << "-";
+    else
+        std::cout << frame.positionError;
+
+    std::cout << std::endl;
+
+    std::cout << std::defaultfloat;
+}
+
+void SlamReplay::print( const ReplaySummary &summary )
+{
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    std::cout << "Frames: " << summary.framesCount << ", lost: " << summary.lostCount << std::endl;
+    std::cout << "Tracking: " << summary.fps << " fps, mean " << summary.meanTrackTime << " ms, max " << summary.maxTrackTime << " ms" << std::endl;
+    std::cout << "Keyframes: " << summary.keyFramesCount << ", map points: " << summary.mapPointsCount << std::endl;
+    std::cout << "Peak memory: " << summary.peakMemory / ( 1024. * 1024. ) << " MB" << std::endl;
+
+    if ( !std::isnan( summary.trajectoryError ) )
+        std::cout << "Trajectory error (RMSE): " << summary.trajectoryError << std::endl;
+
+    if ( !std::isnan( summary.finalDrift ) )
+        std::cout << "Final drift: " << summary.finalDrift << " %" << std::endl;
+
+    std::cout << std::defaultfloat;
+}
+
+bool SlamReplay::saveCsv( const std::vector< ReplayFrame > &frames, const std::string &fileName )
+{
+    std::ofstream stream( fileName );
+
+    if ( !stream.is_open() )
+        return false;
+
+    stream << "frame,tracked,track_ms,maps,keyframes,map_points,memory_bytes,position_error" << std::endl;
+
+    for ( auto &i : frames ) {
+        stream << i.index << "," << i.tracked << "," << i.trackTime << "," << i.mapsCount << "," << i.keyFramesCount << ","
+               << i.mapPointsCount << "," << i.memory << ",";
+
+        if ( !std::isnan( i.positionError ) )
+            stream << i.positionError;
+
+        stream << std::endl;
+
+    }
+
+    return stream.good();
+
+}
+
+size_t SlamReplay::residentMemory()
+{
+#ifdef __linux__
+    std::ifstream stream( "/proc/self/statm" );
+
+    size_t size = 0;
+    size_t resident = 0;
+
+    if ( stream >> size >> resident )
+        return resident * static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+#endif
+
+    return 0;
+
+}
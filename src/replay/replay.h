@@ -0,0 +1,144 @@
+#pragma once
+
+#include "src/common/calibrationdatabase.h"
+#include "src/common/image.h"
+#include "src/common/rectificationprocessor.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace slam {
+    class World;
+}
+
+class ReplaySource
+{
+public:
+    virtual ~ReplaySource() = default;
+
+    virtual size_t framesCount() const = 0;
+    virtual StampedStereoImage frame( const size_t index ) const = 0;
+
+    const StereoCalibrationDataShort &calibration() const;
+
+    // Left camera centers of every frame, in calibration units
+    void setGroundTruth( const std::vector< cv::Vec3d > &value );
+    const std::vector< cv::Vec3d > &groundTruth() const;
+
+    bool loadGroundTruth( const std::string &fileName );
+
+protected:
+    StereoCalibrationDataShort m_calibration;
+
+    std::vector< cv::Vec3d > m_groundTruth;
+
+};
+
+class ImageListSource : public ReplaySource
+{
+public:
+    ImageListSource( const StereoCalibrationDataShort &calibration, const std::vector< std::string > &leftList, const std::vector< std::string > &rightList );
+
+    virtual size_t framesCount() const override;
+    virtual StampedStereoImage frame( const size_t index ) const override;
+
+protected:
+    std::vector< std::string > m_leftList;
+    std::vector< std::string > m_rightList;
+
+};
+
+class SyntheticSource : public ReplaySource
+{
+public:
+    SyntheticSource( const cv::Size &frameSize, const size_t framesCount, const int step, const int disparity, const unsigned int seed = 0 );
+
+    virtual size_t framesCount() const override;
+    virtual StampedStereoImage frame( const size_t index ) const override;
+
+protected:
+    cv::Size m_frameSize;
+
+    size_t m_framesCount;
+
+    int m_step;
+    int m_disparity;
+
+    CvImage m_texture;
+
+private:
+    void initialize( const unsigned int seed );
+
+};
+
+struct ReplayFrame
+{
+    size_t index;
+
+    bool tracked;
+
+    // milliseconds
+    double trackTime;
+
+    size_t mapsCount;
+    size_t keyFramesCount;
+    size_t mapPointsCount;
+
+    size_t memory;
+
+    // Distance between the estimated and true camera centers, set on frames that produced a keyframe
+    double positionError;
+};
+
+struct ReplaySummary
+{
+    size_t framesCount;
+    size_t lostCount;
+
+    double fps;
+    double meanTrackTime;
+    double maxTrackTime;
+
+    size_t keyFramesCount;
+    size_t mapPointsCount;
+
+    size_t peakMemory;
+
+    double trajectoryError;
+    double finalDrift;
+};
+
+class SlamReplay
+{
+public:
+    SlamReplay();
+
+    void setThreadsCount( const int value );
+    int threadsCount() const;
+
+    void setTimeStep( const std::chrono::milliseconds &value );
+    const std::chrono::milliseconds &timeStep() const;
+
+    std::vector< ReplayFrame > run( const ReplaySource &source );
+
+    static ReplaySummary summarize( const std::vector< ReplayFrame > &frames, const ReplaySource &source );
+
+    static void print( const ReplayFrame &frame );
+    static void printHeader();
+    static void print( const ReplaySummary &summary );
+
+    static bool saveCsv( const std::vector< ReplayFrame > &frames, const std::string &fileName );
+
+protected:
+    int m_threadsCount;
+
+    std::chrono::milliseconds m_timeStep;
+
+    static size_t residentMemory();
+
+private:
+    void initialize();
+
+};
@@ -4,6 +4,8 @@
 
 #include "src/common/defs.h"
 #include "src/common/functions.h"
+#include "src/common/profiler.h"
+#include "src/common/taskscheduler.h"
 
 #include "map.h"
 #include "world.h"
@@ -104,8 +106,7 @@ CvImage ProcessedFrame::drawTracks() const
 
         auto points = this->framePoints();
 
-#pragma omp parallel for
-        for ( size_t i = 0; i < points.size(); ++i )
+        parallelFor( 0, points.size(), [ & ]( const int i ) {
             if ( points[ i ] && ( points[ i ]->prevPoint() || points[i]->nextPoint() ) ) {
                 if ( points[ i ]->mapPoint() )
                     points[ i ]->drawTrack( &ret );
@@ -113,13 +114,14 @@ CvImage ProcessedFrame::drawTracks() const
                     points[ i ]->drawTrack( &ret, cv::Scalar( 255, 0, 0, 255 ) );
 
             }
+        }, TaskScheduler::VISUALIZATION, DRAW_GRAIN_SIZE );
 
         int radius = std::min( ret.width(), ret.height() ) / 500.0;
 
-#pragma omp parallel for
-        for ( size_t i = 0; i < points.size(); ++i )
+        parallelFor( 0, points.size(), [ & ]( const int i ) {
             if ( points[ i ] && ( points[ i ]->prevPoint() || points[ i ]->nextPoint() ) )
                 drawFeaturePoint( &ret, points[ i ]->point(), radius );
+        }, TaskScheduler::VISUALIZATION, DRAW_GRAIN_SIZE );
 
         drawLabel( &ret, "Tracks count: " + std::to_string( points.size() ), ret.height() / 70 );
 
@@ -1008,8 +1010,7 @@ CvImage ProcessedStereoFrame::drawStereoCorrespondences() const
 
             auto stereoPoints = this->stereoPoints();
 
-#pragma omp parallel for
-            for ( size_t i = 0; i < stereoPoints.size(); ++i ) {
+            parallelFor( 0, stereoPoints.size(), [ & ]( const int i ) {
 
                     auto rightPoint = stereoPoints[ i ].rightPoint();
 
@@ -1018,19 +1019,18 @@ CvImage ProcessedStereoFrame::drawStereoCorrespondences() const
                     drawLine( &ret, stereoPoints[ i ].leftPoint(), rightPoint );
 
 
-            }
+            }, TaskScheduler::VISUALIZATION, DRAW_GRAIN_SIZE );
 
             int radius = std::min( ret.width(), ret.height() ) / 500.0;
 
-#pragma omp parallel for
-            for ( size_t i = 0; i < stereoPoints.size(); ++i ) {
+            parallelFor( 0, stereoPoints.size(), [ & ]( const int i ) {
                 auto rightPoint = stereoPoints[ i ].rightPoint();
                 rightPoint.x += leftImage.width();
 
                 drawFeaturePoint( &ret, stereoPoints[ i ].leftPoint(), radius );
                 drawFeaturePoint( &ret, rightPoint, radius );
 
-            }
+            }, TaskScheduler::VISUALIZATION, DRAW_GRAIN_SIZE );
 
             drawLabel( &ret, "Stereo correspondencies count: " + std::to_string( stereoPoints.size() ), ret.height() / 70 );
 
@@ -1153,6 +1153,8 @@ cv::Point3f StereoKeyFrame::center() const
 
 int StereoKeyFrame::triangulatePoints()
 {
+    ProfileZone zone( "stereo triangulation" );
+
     int ret = 0;
 
     auto map = parentMap();
@@ -1956,6 +1958,8 @@ ProcessedKeyFramePtr ConsecutiveKeyFrame::endFrame() const
 
 int ConsecutiveKeyFrame::triangulatePoints()
 {
+    ProfileZone zone( "consecutive triangulation" );
+
     int ret = 0;
 
     auto startFrame = this->startFrame();
@@ -7,6 +7,9 @@
 #include "slamdialog.h"
 #include "choicedialog.h"
 
+#include "src/common/frametrace.h"
+#include "src/common/profiler.h"
+
 MainWindow::MainWindow( QWidget *parent )
     : DocumentMainWindow( parent )
 {
@@ -61,6 +64,35 @@ void MainWindow::addCameraSlamDialog()
         addCamerasDocument( dialog.leftIp(), dialog.rightIp(), dialog.calibrationFile() );
 }
 
+void MainWindow::saveProfileDialog()
+{
+    auto csvFilter = tr( "Profile statistics (*.csv)" );
+    auto jsonFilter = tr( "Profile statistics (*.json)" );
+    auto traceFilter = tr( "Chrome trace (*.json)" );
+    auto latencyFilter = tr( "Frame latency statistics (*.csv)" );
+
+    QString selectedFilter;
+
+    auto fileName = QFileDialog::getSaveFileName( nullptr, tr( "Save profile" ), QString(),
+                                                  csvFilter + ";;" + jsonFilter + ";;" + traceFilter + ";;" + latencyFilter, &selectedFilter,
+                                                  QFileDialog::DontUseNativeDialog );
+
+    if ( !fileName.isEmpty() ) {
+        auto &profiler = Profiler::instance();
+
+        if ( selectedFilter == latencyFilter )
+            LatencyMonitor::instance().saveCsv( fileName.toStdString() );
+        else if ( selectedFilter == traceFilter )
+            profiler.saveChromeTrace( fileName.toStdString() );
+        else if ( selectedFilter == jsonFilter )
+            profiler.saveJson( fileName.toStdString() );
+        else
+            profiler.saveCsv( fileName.toStdString() );
+
+    }
+
+}
+
 void MainWindow::addImagesDocument( const QStringList &leftList, const QStringList &rightList, const QString &calibrationFile )
 {
     addDocument( new ImageSlamDocument( leftList, rightList, calibrationFile, this ) );
@@ -80,12 +112,14 @@ void MainWindow::setupActions()
 {
     m_newSlamDocumentAction = new QAction( QIcon( ":/resources/images/new.ico" ), tr( "New SLAM document" ), this );
     m_newImuDocumentAction = new QAction( QIcon( ":/resources/images/map.ico" ), tr( "New IMU document" ), this );
+    m_saveProfileAction = new QAction( QIcon( ":/resources/images/export.ico" ), tr( "Save profile" ), this );
 
     m_exitAction = new QAction( QIcon( ":/resources/images/power.ico" ), tr( "Exit" ), this );
     m_aboutAction = new QAction( QIcon( ":/resources/images/help.ico" ), tr( "About" ), this );
 
     connect( m_newSlamDocumentAction, &QAction::triggered, this, &MainWindow::choiceDialog );
     connect( m_newImuDocumentAction, &QAction::triggered, this, &MainWindow::addImuDocument );
+    connect( m_saveProfileAction, &QAction::triggered, this, &MainWindow::saveProfileDialog );
     connect( m_exitAction, &QAction::triggered, this, &MainWindow::close );
 }
 
@@ -97,6 +131,8 @@ void MainWindow::setupMenus()
     fileMenu->addAction( m_newSlamDocumentAction );
     fileMenu->addAction( m_newImuDocumentAction );
     fileMenu->addSeparator();
+    fileMenu->addAction( m_saveProfileAction );
+    fileMenu->addSeparator();
     fileMenu->addAction( m_exitAction );
 
     auto helpMenu = m_menuBar->addMenu( tr( "Help" ) );
@@ -17,9 +17,12 @@ public slots:
     void addImageSlamDialog();
     void addCameraSlamDialog();
 
+    void saveProfileDialog();
+
 protected:
     QPointer< QAction > m_newSlamDocumentAction;
     QPointer< QAction > m_newImuDocumentAction;
+    QPointer< QAction > m_saveProfileAction;
     QPointer< QAction > m_exitAction;
     QPointer< QAction > m_aboutAction;
 
@@ -184,9 +184,7 @@ std::shared_ptr< const FlowMap > FlowMap::shared_from_this() const
 }
 
 bool FlowMap::track( const StampedImage &leftImage, const StampedImage &rightImage )
-{    
-    static FlowDenseFramePtr keyFrame;
-
+{
     /*if ( m_denseFlag && m_frames.size() % m_denseStep == 0 )
         denseFrame->processDenseCloud();*/
 
@@ -194,7 +192,7 @@ bool FlowMap::track( const StampedImage &leftImage, const StampedImage &rightIma
 
         auto frame = FlowDenseFrame::create( shared_from_this() );
 
-        keyFrame = frame;
+        m_keyFrame = frame;
 
         frame->setImage( leftImage, rightImage );
 
@@ -256,10 +254,10 @@ bool FlowMap::track( const StampedImage &leftImage, const StampedImage &rightIma
 
         }
 
-        if ( keyFrame ) {
+        if ( m_keyFrame ) {
 
-            auto previousLeftFrame = keyFrame->leftFrame();
-            auto previousRightFrame = keyFrame->rightFrame();
+            auto previousLeftFrame = m_keyFrame->leftFrame();
+            auto previousRightFrame = m_keyFrame->rightFrame();
             auto leftFrame = frame->leftFrame();
 
             FlowConsecutiveFrame adjacentFrame( previousLeftFrame, leftFrame );
@@ -301,14 +299,14 @@ bool FlowMap::track( const StampedImage &leftImage, const StampedImage &rightIma
                     m_frames.push_back( newKeyFrame );
 
                     auto replacedFrame = FinishedStereoKeyFrame::create( shared_from_this() );
-                    replacedFrame->replaceAndClean( keyFrame );
+                    replacedFrame->replaceAndClean( m_keyFrame );
 
-                    auto it = std::find( m_frames.begin(), m_frames.end(), keyFrame );
+                    auto it = std::find( m_frames.begin(), m_frames.end(), m_keyFrame );
 
                     if ( it != m_frames.end() )
                         *it = replacedFrame;
 
-                    keyFrame = newKeyFrame;
+                    m_keyFrame = newKeyFrame;
 
                     return true;
 
@@ -100,6 +100,8 @@ public:
 protected:
     FlowMap( const StereoCameraMatrix &projectionMatrix, const WorldPtr &parentWorld );
 
+    FlowDenseFramePtr m_keyFrame;
+
 };
 
 class FeatureMap : public Map
@@ -2,6 +2,8 @@
 
 #include "optimizer.h"
 
+#include "src/common/profiler.h"
+
 #include "map.h"
 
 #include "frame.h"
@@ -16,7 +18,9 @@ Optimizer::Optimizer()
 }
 
 void Optimizer::adjust( std::list<StereoKeyFramePtr> &frames )
-{    
+{
+    ProfileZone zone( "adjustment" );
+
     if ( frames.size() > 1 ) {
 
         g2o::SparseOptimizer optimizer;
@@ -3,18 +3,17 @@
 #include "slamthread.h"
 
 #include "src/common/defs.h"
+#include "src/common/frametrace.h"
 #include "src/common/functions.h"
-#include "src/common/tictoc.h"
+#include "src/common/profiler.h"
 
 #include "world.h"
 #include "mappoint.h"
 #include "frame.h"
 
-#include <thread>
-
 // SlamThread
 SlamThread::SlamThread(const StereoCalibrationDataShort &calibration, QObject *parent )
-    : QThread( parent )
+    : QObject( parent )
 {
     initialize( calibration );
 }
@@ -23,6 +22,12 @@ void SlamThread::initialize( const StereoCalibrationDataShort &calibration )
 {
     m_scaleFactor = 1.0;
 
+    m_running = false;
+    m_stopped = false;
+
+    m_framesCount = 0;
+    m_reportInterval = 100;
+
     m_rectificationProcessor.setCalibrationData( calibration );
     m_leftUndistortionProcessor.setCalibrationData( calibration.leftCameraResults() );
     m_rightUndistortionProcessor.setCalibrationData( calibration.rightCameraResults() );
@@ -43,11 +48,37 @@ void SlamThread::process( const StampedImage leftImage, const StampedImage right
 {
     m_framesMutex.lock();
 
+    // The previous frame was replaced before the tracking loop picked it up
+    if ( !m_leftFrame.empty() )
+        LatencyMonitor::instance().drop( m_leftFrame.trace(), "slam" );
+
     m_leftFrame = leftImage;
     m_rightFrame = rightImage;
 
+    m_leftFrame.trace().mark( "queue" );
+
+    auto start = !m_running && !m_stopped;
+
+    if ( start )
+        m_running = true;
+
+    m_framesMutex.unlock();
+
+    if ( start )
+        m_tasks.run( [ this ] { run(); } );
+
+}
+
+void SlamThread::stop()
+{
+    m_framesMutex.lock();
+
+    m_stopped = true;
+
     m_framesMutex.unlock();
 
+    m_tasks.wait();
+
 }
 
 std::shared_ptr< slam::World > SlamThread::system() const
@@ -100,11 +131,11 @@ std::list< StereoCameraMatrix > SlamThread::path() const
 
 }
 
-std::list< ColorPoint3d > SlamThread::sparseCloud() const
+FrameTrace SlamThread::trace() const
 {
     m_systemMutex.lock();
 
-    auto ret = m_system->sparseCloud();
+    auto ret = m_trace;
 
     m_systemMutex.unlock();
 
@@ -112,83 +143,102 @@ std::list< ColorPoint3d > SlamThread::sparseCloud() const
 
 }
 
-void SlamThread::run()
+std::list< ColorPoint3d > SlamThread::sparseCloud() const
 {
-   /*auto optimizationThread = std::thread( [ & ] {
-
-        while ( !isInterruptionRequested() ) {
+    m_systemMutex.lock();
 
-            const int frames = 100;
+    auto ret = m_system->sparseCloud();
 
-            m_system->adjust( frames );
-            std::this_thread::sleep_for( std::chrono::seconds( 5 ) );
+    m_systemMutex.unlock();
 
-        }
+    return ret;
 
-    } );*/
+}
 
-    while( !isInterruptionRequested() )
-    {
+// Tracks frames until none is waiting, the next process() call submits a new task
+void SlamThread::run()
+{
+    for ( ;; ) {
         m_framesMutex.lock();
 
+        if ( m_leftFrame.empty() || m_rightFrame.empty() || m_stopped ) {
+            m_running = false;
+            m_framesMutex.unlock();
+            return;
+        }
+
         auto leftFrame = m_leftFrame;
         auto rightFrame = m_rightFrame;
 
+        m_leftFrame.release();
+        m_rightFrame.release();
+
         m_framesMutex.unlock();
 
-        if ( !leftFrame.empty() && !rightFrame.empty() ) {
+        track( leftFrame, rightFrame );
 
-            CvImage leftRectifiedImage;
-            CvImage rightRectifiedImage;
-            CvImage leftCroppedImage;
-            CvImage rightCroppedImage;
+    }
+
+}
+
+void SlamThread::track( StampedImage &leftFrame, StampedImage &rightFrame )
+{
+    CvImage leftRectifiedImage;
+    CvImage rightRectifiedImage;
+    CvImage leftCroppedImage;
+    CvImage rightCroppedImage;
 
-            // cv::rectangle( leftFrame, cv::Point( 0, 1500 ), cv::Point( 2048, 2048 ), cv::Scalar( 0, 0, 0, 255 ), cv::FILLED );
-            // cv::rectangle( rightFrame, cv::Point( 0, 1500 ), cv::Point( 2048, 2048 ), cv::Scalar( 0, 0, 0, 255 ), cv::FILLED );
+    // cv::rectangle( leftFrame, cv::Point( 0, 1500 ), cv::Point( 2048, 2048 ), cv::Scalar( 0, 0, 0, 255 ), cv::FILLED );
+    // cv::rectangle( rightFrame, cv::Point( 0, 1500 ), cv::Point( 2048, 2048 ), cv::Scalar( 0, 0, 0, 255 ), cv::FILLED );
 
-            TicToc time;
+    ProfileZone zone( "slam frame" );
 
-            // leftCroppedImage = m_leftUndistortionProcessor.undistort( leftFrame );
-            // rightCroppedImage = m_rightUndistortionProcessor.undistort( rightFrame );
+    auto &trace = leftFrame.trace();
 
-            if ( m_rectificationProcessor.rectify( leftFrame, rightFrame, &leftRectifiedImage, &rightRectifiedImage )
-                        && m_rectificationProcessor.crop( leftRectifiedImage, rightRectifiedImage, &leftCroppedImage, &rightCroppedImage ) ) {
+    trace.mark( "processing" );
 
-                CvImage leftProcImage;
-                CvImage rightProcImage;
+    // leftCroppedImage = m_leftUndistortionProcessor.undistort( leftFrame );
+    // rightCroppedImage = m_rightUndistortionProcessor.undistort( rightFrame );
 
-                if ( std::abs( m_scaleFactor - 1.0 ) > DOUBLE_EPS ) {
-                    cv::resize( leftCroppedImage, leftProcImage, cv::Size(), m_scaleFactor, m_scaleFactor, cv::INTER_AREA );
-                    cv::resize( rightCroppedImage, rightProcImage, cv::Size(), m_scaleFactor, m_scaleFactor, cv::INTER_AREA );
+    if ( m_rectificationProcessor.rectify( leftFrame, rightFrame, &leftRectifiedImage, &rightRectifiedImage )
+                && m_rectificationProcessor.crop( leftRectifiedImage, rightRectifiedImage, &leftCroppedImage, &rightCroppedImage ) ) {
 
-                }
-                else {
-                    leftProcImage = leftCroppedImage;
-                    rightProcImage = rightCroppedImage;
+        trace.mark( "rectification" );
 
-                }
+        StampedImage leftProcImage;
+        StampedImage rightProcImage;
 
-                m_systemMutex.lock();
+        if ( std::abs( m_scaleFactor - 1.0 ) > DOUBLE_EPS ) {
+            cv::resize( leftCroppedImage, leftProcImage, cv::Size(), m_scaleFactor, m_scaleFactor, cv::INTER_AREA );
+            cv::resize( rightCroppedImage, rightProcImage, cv::Size(), m_scaleFactor, m_scaleFactor, cv::INTER_AREA );
 
-                m_system->track( leftProcImage, rightProcImage );
+        }
+        else {
+            leftProcImage = leftCroppedImage;
+            rightProcImage = rightCroppedImage;
 
-                m_systemMutex.unlock();
+        }
 
-                emit updateSignal();
+        leftProcImage.setTrace( trace );
+        rightProcImage.setTrace( trace );
 
-            }
+        m_systemMutex.lock();
 
-            time.report();
+        m_system->track( leftProcImage, rightProcImage );
 
-            m_leftFrame.release();
-            m_rightFrame.release();
+        trace.mark( "tracking" );
 
-        }
+        m_trace = trace;
 
-        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        m_systemMutex.unlock();
+
+        emit updateSignal();
 
     }
 
-    // optimizationThread.join();
+    if ( ++m_framesCount % m_reportInterval == 0 ) {
+        Profiler::instance().report();
+        LatencyMonitor::instance().report();
+    }
 
 }
@@ -1,7 +1,6 @@
 #pragma once
 
-#include <QThread>
-#include <QMutex>
+#include <QObject>
 
 #include <memory>
 
@@ -10,6 +9,7 @@
 #include "src/common/image.h"
 
 #include "src/common/rectificationprocessor.h"
+#include "src/common/taskscheduler.h"
 
 namespace slam {
     class World;
@@ -19,7 +19,8 @@ namespace slam {
     class StereoFrame;
 }
 
-class SlamThread : public QThread
+// Tracks the latest frame as a task of the shared scheduler, frames replaced before tracking picks them up are dropped
+class SlamThread : public QObject
 {
     Q_OBJECT
 
@@ -31,6 +32,9 @@ public:
 
     void process( const StampedImage leftImage, const StampedImage rightImage );
 
+    // Finishes the frame being tracked, later frames are ignored
+    void stop();
+
     std::shared_ptr< slam::World > system() const;
 
     CvImage pointsImage() const;
@@ -40,6 +44,8 @@ public:
     std::list< StereoCameraMatrix > path() const;
     std::list< ColorPoint3d > sparseCloud() const;
 
+    FrameTrace trace() const;
+
 signals:
     void updateSignal();
 
@@ -47,18 +53,31 @@ protected:
     StampedImage m_leftFrame;
     StampedImage m_rightFrame;
 
+    FrameTrace m_trace;
+
+    // A tracking task is submitted or running, guarded by the frames mutex
+    bool m_running;
+    bool m_stopped;
+
     std::mutex m_framesMutex;
     mutable std::mutex m_systemMutex;
 
     double m_scaleFactor;
 
+    size_t m_framesCount;
+    size_t m_reportInterval;
+
     std::shared_ptr< slam::World > m_system;
 
     StereoRectificationProcessor m_rectificationProcessor;
     MonoUndistortionProcessor m_leftUndistortionProcessor;
     MonoUndistortionProcessor m_rightUndistortionProcessor;
 
-    virtual void run() override;
+    // Declared last, so a running task finishes before the other members are destroyed
+    TaskGroup m_tasks;
+
+    void run();
+    void track( StampedImage &leftFrame, StampedImage &rightFrame );
 
 private:
     void initialize(const StereoCalibrationDataShort &calibration);
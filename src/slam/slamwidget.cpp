@@ -3,6 +3,8 @@
 #include "slamwidget.h"
 
 #include "slamthread.h"
+
+#include "src/common/frametrace.h"
 #include "map.h"
 #include "frame.h"
 
@@ -539,8 +541,7 @@ SlamWidgetBase::SlamWidgetBase( const QString &calibrationFile, QWidget* parent
 
 SlamWidgetBase::~SlamWidgetBase()
 {
-    m_slamThread->requestInterruption();
-    m_slamThread->wait();
+    m_slamThread->stop();
 }
 
 void SlamWidgetBase::initialize( const QString &calibrationFile )
@@ -562,8 +563,6 @@ void SlamWidgetBase::initialize( const QString &calibrationFile )
 
     connect( m_updateTimer, &QTimer::timeout, this, &SlamWidgetBase::updateViews );
 
-    m_slamThread->start();
-
     updateVisibility();
 
 }
@@ -584,6 +583,8 @@ void SlamWidgetBase::updateImages()
     m_viewWidget->setPointsImage( m_slamThread->pointsImage() );
     m_viewWidget->setTracksImage( m_slamThread->tracksImage() );
     m_viewWidget->setStereoImage( m_slamThread->stereoImage() );
+
+    LatencyMonitor::instance().finish( m_slamThread->trace(), "slam view" );
 }
 
 void SlamWidgetBase::updatePath()
@@ -750,6 +751,9 @@ void SlamImageWidget::timerEvent( QTimerEvent * )
         StampedImage leftImage( time, m_leftList[ m_index ].toStdString() );
         StampedImage rightImage( time, m_rightList[ m_index ].toStdString() );
 
+        leftImage.setTrace( FrameTrace::create() );
+        rightImage.setTrace( leftImage.trace() );
+
         m_slamThread->process( leftImage, rightImage );
         ++m_index;
 
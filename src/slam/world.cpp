@@ -3,6 +3,7 @@
 #include "world.h"
 
 #include "src/common/functions.h"
+#include "src/common/profiler.h"
 
 #include "frame.h"
 
@@ -58,6 +59,8 @@ const std::list< MapPtr > &World::maps() const
 
 bool World::track( const StampedImage &leftImage, const StampedImage &rightImage )
 {
+    ProfileZone zone( "tracking" );
+
     auto restoreRotation = this->restoreRotation();
     auto restoreTranslation = this->restoreTranslation();
 